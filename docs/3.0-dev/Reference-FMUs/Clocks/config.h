@@ -42,6 +42,7 @@ typedef enum {
     vr_result2           = 2005,
     vr_input2            = 2006,
     vr_output3           = 2007,
+    vr_burnIterations    = 2008,
 } ValueReference;
 
 typedef struct {
@@ -55,6 +56,7 @@ typedef struct {
     int result2;
     int input2;
     int output3;
+    int burnIterations;
 } ModelData;
 
 
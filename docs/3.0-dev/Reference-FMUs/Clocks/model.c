@@ -124,8 +124,8 @@ static void activateModelPartition2(ModelInstance* comp, double time) {
     }
 
     // This partition is supposed to consume a bit of time on a low prio ...
-    unsigned long sum = 0;
-    for (int loop = 1; loop < 1000000000; loop++) {
+    volatile unsigned long sum = 0;
+    for (int loop = 1; loop <= M(burnIterations); loop++) {
         sum += loop;
     }
     // ... end of burning CPU cycles
@@ -141,13 +141,13 @@ static void activateModelPartition2(ModelInstance* comp, double time) {
 
         if (M(outClock)) {
             comp->intermediateUpdate(
-                comp,   // fmu instance
-                time,   // intermediateUpdateTime
-                true,   // clocksTicked
-                false,  // intermediateVariableSetAllowed
-                false,  // intermediateVariableGetAllowed
-                true,   // intermediateStepFinished
-                false,  // canReturnEarly
+                comp->componentEnvironment, // fmu instance
+                time,                       // intermediateUpdateTime
+                true,                       // clocksTicked
+                false,                      // intermediateVariableSetAllowed
+                false,                      // intermediateVariableGetAllowed
+                true,                       // intermediateStepFinished
+                false,                      // canReturnEarly
                 &earlyReturnRequested,
                 &earlyReturnTime
             );
@@ -166,6 +166,7 @@ void setStartValues(ModelInstance *comp) {
     M(result2)           = 0;
     M(input2)            = 0;
     M(output3)           = 0;
+    M(burnIterations)    = 1000000;
 }
 
 Status calculateValues(ModelInstance *comp) {
@@ -203,6 +204,9 @@ Status setInt32(ModelInstance* comp, ValueReference vr, const int* value, size_t
     case vr_input2:
         M(input2) = value[(*index)++];
         return OK;
+    case vr_burnIterations:
+        M(burnIterations) = value[(*index)++];
+        return OK;
     default:
         logError(comp, "Set Int32 is not allowed for value reference %u.", vr);
         return Error;
@@ -230,6 +234,9 @@ Status getInt32(ModelInstance* comp, ValueReference vr, int *value, size_t *inde
     case vr_output3:
         value[(*index)++] = M(output3);
         return OK;
+    case vr_burnIterations:
+        value[(*index)++] = M(burnIterations);
+        return OK;
     default:
         logError(comp, "Get Int32 is not allowed for value reference %u.", vr);
         return Error;
@@ -30,4 +30,10 @@ typedef struct {
 
 } ModelData;
 
+// structure-of-arrays ensemble (see ensemble.h)
+#define ENSEMBLE_N_VARIABLES (vr_k + 1)
+#define ENSEMBLE_STATES      { vr_x }
+#define ENSEMBLE_DERIVATIVES { vr_der_x }
+#define ENSEMBLE_STATE_NAMES { "x" }
+
 #endif /* config_h */
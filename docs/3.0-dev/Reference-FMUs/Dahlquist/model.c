@@ -77,3 +77,27 @@ void eventUpdate(ModelInstance *comp) {
     comp->terminateSimulation               = false;
     comp->nextEventTimeDefined              = false;
 }
+
+#ifdef ENSEMBLE
+
+#include "ensemble.h"
+
+void ensembleSetStartValues(Ensemble *ensemble) {
+    for (size_t i = 0; i < ensemble->stride; i++) {
+        E(vr_x)[i] = 1;
+        E(vr_k)[i] = 1;
+    }
+}
+
+void ensembleCalculateValues(Ensemble *ensemble) {
+
+    const double *restrict x = E(vr_x);
+    const double *restrict k = E(vr_k);
+    double *restrict der_x = E(vr_der_x);
+
+    for (size_t i = 0; i < ensemble->stride; i++) {
+        der_x[i] = -k[i] * x[i];
+    }
+}
+
+#endif
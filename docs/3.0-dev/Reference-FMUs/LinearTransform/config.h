@@ -18,13 +18,11 @@
 #define GET_UINT64
 #define SET_UINT64
 #define EVENT_UPDATE
+#define COPY_MODEL_DATA
 
 #define FIXED_SOLVER_STEP 1
 #define DEFAULT_STOP_TIME 10
 
-#define M_MAX 5
-#define N_MAX 5
-
 typedef enum {
     vr_time,
     vr_m,
@@ -37,9 +35,9 @@ typedef enum {
 typedef struct {
     uint64_t m;
     uint64_t n;
-    double u[N_MAX];
-    double A[M_MAX][N_MAX];
-    double y[M_MAX];
+    double *u; // n
+    double *A; // m x n, row-major
+    double *y; // m
 } ModelData;
 
 #endif /* config_h */
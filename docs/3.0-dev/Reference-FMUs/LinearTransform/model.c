@@ -1,64 +1,251 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
 #include "config.h"
 #include "model.h"
 
 
-void setStartValues(ModelInstance *comp) {
+// number of columns per block, so the block of u (8 KiB) stays in the L1 cache
+// while the rows of A are streamed through
+#define BLOCK_SIZE 1024
 
-    M(m) = 2;
-    M(n) = 2;
+#if !defined(__AVX512F__) && defined(__AVX2__) && defined(__FMA__)
+static double sum4(__m256d v) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+#endif
 
-    // identity matrix
-    for (int i = 0; i < M_MAX; i++) {
-    for (int j = 0; j < N_MAX; j++) {
-        M(A)[i][j] = i == j ? 1 : 0;
-    }}
+// y[0] += a[0..nb) * u[0..nb)
+static void dot1(const double *restrict a, const double *restrict u, size_t nb, double *restrict y) {
 
-    for (int i = 0; i < M_MAX; i++) {
-        M(u)[i] = i + 1;
+    size_t j = 0;
+    double s = 0;
+
+#if defined(__AVX512F__)
+    __m512d c = _mm512_setzero_pd();
+
+    for (; j + 8 <= nb; j += 8) {
+        c = _mm512_fmadd_pd(_mm512_loadu_pd(a + j), _mm512_loadu_pd(u + j), c);
     }
 
-    for (int i = 0; i < N_MAX; i++) {
-        M(y)[i] = 0;
+    s = _mm512_reduce_add_pd(c);
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256d c = _mm256_setzero_pd();
+
+    for (; j + 4 <= nb; j += 4) {
+        c = _mm256_fmadd_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(u + j), c);
     }
 
+    s = sum4(c);
+#endif
+
+    for (; j < nb; j++) {
+        s += a[j] * u[j];
+    }
+
+    y[0] += s;
 }
 
-Status calculateValues(ModelInstance *comp) {
+// y[0..4) += a[0..4)[0..nb) * u[0..nb) for four rows that are lda elements apart,
+// so every element of u is loaded once for four rows
+static void dot4(const double *restrict a, size_t lda, const double *restrict u, size_t nb, double *restrict y) {
+
+    const double *a0 = a;
+    const double *a1 = a + lda;
+    const double *a2 = a + 2 * lda;
+    const double *a3 = a + 3 * lda;
+
+    size_t j = 0;
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+#if defined(__AVX512F__)
+    __m512d c0 = _mm512_setzero_pd();
+    __m512d c1 = _mm512_setzero_pd();
+    __m512d c2 = _mm512_setzero_pd();
+    __m512d c3 = _mm512_setzero_pd();
+
+    for (; j + 8 <= nb; j += 8) {
+        const __m512d v = _mm512_loadu_pd(u + j);
+        c0 = _mm512_fmadd_pd(_mm512_loadu_pd(a0 + j), v, c0);
+        c1 = _mm512_fmadd_pd(_mm512_loadu_pd(a1 + j), v, c1);
+        c2 = _mm512_fmadd_pd(_mm512_loadu_pd(a2 + j), v, c2);
+        c3 = _mm512_fmadd_pd(_mm512_loadu_pd(a3 + j), v, c3);
+    }
 
-    // y = A * u
-    for (size_t i = 0; i < M(m); i++) {
-        M(y)[i] = 0;
-        for (size_t j = 0; j < M(n); j++) {
-            M(y)[i] += M(A)[i][j] * M(u)[j];
+    s0 = _mm512_reduce_add_pd(c0);
+    s1 = _mm512_reduce_add_pd(c1);
+    s2 = _mm512_reduce_add_pd(c2);
+    s3 = _mm512_reduce_add_pd(c3);
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256d c0 = _mm256_setzero_pd();
+    __m256d c1 = _mm256_setzero_pd();
+    __m256d c2 = _mm256_setzero_pd();
+    __m256d c3 = _mm256_setzero_pd();
+
+    for (; j + 4 <= nb; j += 4) {
+        const __m256d v = _mm256_loadu_pd(u + j);
+        c0 = _mm256_fmadd_pd(_mm256_loadu_pd(a0 + j), v, c0);
+        c1 = _mm256_fmadd_pd(_mm256_loadu_pd(a1 + j), v, c1);
+        c2 = _mm256_fmadd_pd(_mm256_loadu_pd(a2 + j), v, c2);
+        c3 = _mm256_fmadd_pd(_mm256_loadu_pd(a3 + j), v, c3);
+    }
+
+    s0 = sum4(c0);
+    s1 = sum4(c1);
+    s2 = sum4(c2);
+    s3 = sum4(c3);
+#endif
+
+    for (; j < nb; j++) {
+        const double v = u[j];
+        s0 += a0[j] * v;
+        s1 += a1[j] * v;
+        s2 += a2[j] * v;
+        s3 += a3[j] * v;
+    }
+
+    y[0] += s0;
+    y[1] += s1;
+    y[2] += s2;
+    y[3] += s3;
+}
+
+// y = A * u for a row-major m x n matrix A
+static void matvec(size_t m, size_t n, const double *restrict A, const double *restrict u, double *restrict y) {
+
+    memset(y, 0, m * sizeof(double));
+
+    for (size_t jb = 0; jb < n; jb += BLOCK_SIZE) {
+
+        const size_t nb = n - jb < BLOCK_SIZE ? n - jb : BLOCK_SIZE;
+
+        size_t i = 0;
+
+        for (; i + 4 <= m; i += 4) {
+            dot4(&A[i * n + jb], n, &u[jb], nb, &y[i]);
         }
+
+        for (; i < m; i++) {
+            dot1(&A[i * n + jb], &u[jb], nb, &y[i]);
+        }
+    }
+}
+
+// allocate u, A and y for the dimensions m x n and set them to their start values
+static Status resize(ModelInstance *comp, uint64_t m, uint64_t n) {
+
+    if (m < 1 || n < 1 || m > SIZE_MAX / sizeof(double) / n) {
+        logError(comp, "Invalid dimensions m = %llu, n = %llu.", (unsigned long long)m, (unsigned long long)n);
+        return Error;
+    }
+
+    double *u = malloc((size_t)n * sizeof(double));
+    double *A = malloc((size_t)(m * n) * sizeof(double));
+    double *y = malloc((size_t)m * sizeof(double));
+
+    if (!u || !A || !y) {
+        free(u);
+        free(A);
+        free(y);
+        logError(comp, "Failed to allocate memory for m = %llu, n = %llu.", (unsigned long long)m, (unsigned long long)n);
+        return Error;
+    }
+
+    freeModelData(comp->modelData);
+
+    M(u) = u;
+    M(A) = A;
+    M(y) = y;
+    M(m) = m;
+    M(n) = n;
+
+    // identity matrix
+    for (size_t i = 0; i < m; i++)
+    for (size_t j = 0; j < n; j++) {
+        M(A)[i * n + j] = i == j ? 1 : 0;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        M(u)[i] = (double)(i + 1);
+    }
+
+    memset(M(y), 0, (size_t)m * sizeof(double));
+
+    return OK;
+}
+
+void setStartValues(ModelInstance *comp) {
+
+    if (resize(comp, 2, 2) > Warning) {
+        M(m) = 0;
+        M(n) = 0;
     }
 
+}
+
+Status calculateValues(ModelInstance *comp) {
+
+    // y = A * u (only called when u, A or the dimensions have changed)
+    matvec((size_t)M(m), (size_t)M(n), M(A), M(u), M(y));
+
     return OK;
 }
 
+// number of elements of a Float64 variable
+static size_t float64Size(ModelInstance *comp, ValueReference vr) {
+    switch (vr) {
+        case vr_u:
+            return (size_t)M(n);
+        case vr_A:
+            return (size_t)(M(m) * M(n));
+        case vr_y:
+            return (size_t)M(m);
+        default:
+            return 1;
+    }
+}
+
+// check that the values of the current get or set call have room for the variable
+static bool tooFewValues(ModelInstance *comp, ValueReference vr, size_t index) {
+
+    const size_t size = float64Size(comp, vr);
+
+    if (index > comp->nValues || size > comp->nValues - index) {
+        logError(comp, "The values of variable %u require %zu elements but only %zu are left.",
+            vr, size, index > comp->nValues ? 0 : comp->nValues - index);
+        return true;
+    }
+
+    return false;
+}
+
 Status getFloat64(ModelInstance* comp, ValueReference vr, double *value, size_t *index) {
 
-    calculateValues(comp);
+    if (tooFewValues(comp, vr, *index)) {
+        return Error;
+    }
 
     switch (vr) {
         case vr_time:
             value[(*index)++] = comp->time;
             return OK;
         case vr_u:
-            for (size_t i = 0; i < M(n); i++) {
-                value[(*index)++] = M(u)[i];
-            }
+            memcpy(&value[*index], M(u), (size_t)M(n) * sizeof(double));
+            *index += (size_t)M(n);
             return OK;
         case vr_A:
-            for (size_t i = 0; i < M(m); i++)
-            for (size_t j = 0; j < M(n); j++) {
-                value[(*index)++] = M(A)[i][j];
-            }
+            memcpy(&value[*index], M(A), (size_t)(M(m) * M(n)) * sizeof(double));
+            *index += (size_t)(M(m) * M(n));
             return OK;
         case vr_y:
-            for (size_t i = 0; i < M(m); i++) {
-                value[(*index)++] = M(y)[i];
-            }
+            memcpy(&value[*index], M(y), (size_t)M(m) * sizeof(double));
+            *index += (size_t)M(m);
             return OK;
         default:
             logError(comp, "Get Float64 is not allowed for value reference %u.", vr);
@@ -67,18 +254,19 @@ Status getFloat64(ModelInstance* comp, ValueReference vr, double *value, size_t
 }
 
 Status setFloat64(ModelInstance* comp, ValueReference vr, const double *value, size_t *index) {
+
+    if (tooFewValues(comp, vr, *index)) {
+        return Error;
+    }
+
     switch (vr) {
         case vr_u:
-            for (size_t i = 0; i < M(n); i++) {
-                M(u)[i] = value[(*index)++];
-            }
-            calculateValues(comp);
+            memcpy(M(u), &value[*index], (size_t)M(n) * sizeof(double));
+            *index += (size_t)M(n);
             return OK;
         case vr_A:
-            for (size_t i = 0; i < M(m); i++)
-            for (size_t j = 0; j < M(n); j++) {
-                M(A)[i][j] = value[(*index)++];
-            }
+            memcpy(M(A), &value[*index], (size_t)(M(m) * M(n)) * sizeof(double));
+            *index += (size_t)(M(m) * M(n));
             return OK;
         default:
             logError(comp, "Set Float64 is not allowed for value reference %u.", vr);
@@ -87,7 +275,6 @@ Status setFloat64(ModelInstance* comp, ValueReference vr, const double *value, s
 }
 
 Status getUInt64(ModelInstance* comp, ValueReference vr, uint64_t *value, size_t *index) {
-    calculateValues(comp);
     switch (vr) {
         case vr_m:
             value[(*index)++] = M(m);
@@ -104,6 +291,7 @@ Status getUInt64(ModelInstance* comp, ValueReference vr, uint64_t *value, size_t
 Status setUInt64(ModelInstance* comp, ValueReference vr, const uint64_t *value, size_t *index) {
 
     if (comp->state != ConfigurationMode && comp->state != ReconfigurationMode) {
+        logError(comp, "Variable %s can only be set in Configuration Mode or Reconfiguration Mode.", vr == vr_m ? "m" : "n");
         return Error;
     }
 
@@ -111,19 +299,129 @@ Status setUInt64(ModelInstance* comp, ValueReference vr, const uint64_t *value,
 
     switch (vr) {
         case vr_m:
-            if (v < 1 || v > M_MAX) return Error;
-            M(m) = v;
-            return OK;
+            return v == M(m) ? OK : resize(comp, v, M(n));
         case vr_n:
-            if (v < 1 || v > N_MAX) return Error;
-            M(n) = v;
-            return OK;
+            return v == M(n) ? OK : resize(comp, M(m), v);
         default:
             logError(comp, "Set UInt64 is not allowed for value reference %u.", vr);
             return Error;
     }
 }
 
+// allocate the arrays of data for the dimensions m x n
+static Status allocateModelData(ModelInstance *comp, ModelData *data, uint64_t m, uint64_t n) {
+
+    // re-use the arrays if the dimensions have not changed
+    if (data->m == m && data->n == n && data->u && data->A && data->y) {
+        return OK;
+    }
+
+    freeModelData(data);
+
+    data->u = malloc((size_t)n * sizeof(double));
+    data->A = malloc((size_t)(m * n) * sizeof(double));
+    data->y = malloc((size_t)m * sizeof(double));
+
+    if (!data->u || !data->A || !data->y) {
+        freeModelData(data);
+        data->m = 0;
+        data->n = 0;
+        logError(comp, "Failed to allocate memory for the model data.");
+        return Error;
+    }
+
+    data->m = m;
+    data->n = n;
+
+    return OK;
+}
+
+Status copyModelData(ModelInstance *comp, ModelData *dst, const ModelData *src) {
+
+    if (allocateModelData(comp, dst, src->m, src->n) > Warning) {
+        return Error;
+    }
+
+    memcpy(dst->u, src->u, (size_t)src->n * sizeof(double));
+    memcpy(dst->A, src->A, (size_t)(src->m * src->n) * sizeof(double));
+    memcpy(dst->y, src->y, (size_t)src->m * sizeof(double));
+
+    return OK;
+}
+
+// the model data is serialized as m, n, u, A, y
+size_t serializedModelDataSize(const ModelData *data) {
+    return 2 * sizeof(uint64_t) + (size_t)(data->n + data->m * data->n + data->m) * sizeof(double);
+}
+
+void serializeModelData(const ModelData *data, void *buffer) {
+
+    char *p = buffer;
+
+    memcpy(p, &data->m, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+
+    memcpy(p, &data->n, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+
+    memcpy(p, data->u, (size_t)data->n * sizeof(double));
+    p += (size_t)data->n * sizeof(double);
+
+    memcpy(p, data->A, (size_t)(data->m * data->n) * sizeof(double));
+    p += (size_t)(data->m * data->n) * sizeof(double);
+
+    memcpy(p, data->y, (size_t)data->m * sizeof(double));
+}
+
+Status deserializeModelData(ModelInstance *comp, ModelData *data, const void *buffer, size_t size) {
+
+    const char *p = buffer;
+
+    uint64_t m, n;
+
+    if (size < 2 * sizeof(uint64_t)) {
+        logError(comp, "The serialized FMU state is too short.");
+        return Error;
+    }
+
+    memcpy(&m, p, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+
+    memcpy(&n, p, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+
+    // u, A and y have (m + 1) * (n + 1) - 1 elements
+    if (m < 1 || n < 1 || m >= SIZE_MAX / sizeof(double) || n >= SIZE_MAX / sizeof(double) ||
+        m + 1 > SIZE_MAX / sizeof(double) / (n + 1) ||
+        size - 2 * sizeof(uint64_t) != (size_t)((m + 1) * (n + 1) - 1) * sizeof(double)) {
+        logError(comp, "The serialized FMU state has an invalid size.");
+        return Error;
+    }
+
+    if (allocateModelData(comp, data, m, n) > Warning) {
+        return Error;
+    }
+
+    memcpy(data->u, p, (size_t)n * sizeof(double));
+    p += (size_t)n * sizeof(double);
+
+    memcpy(data->A, p, (size_t)(m * n) * sizeof(double));
+    p += (size_t)(m * n) * sizeof(double);
+
+    memcpy(data->y, p, (size_t)m * sizeof(double));
+
+    return OK;
+}
+
+void freeModelData(ModelData *data) {
+    free(data->u);
+    free(data->A);
+    free(data->y);
+    data->u = NULL;
+    data->A = NULL;
+    data->y = NULL;
+}
+
 void eventUpdate(ModelInstance *comp) {
     comp->valuesOfContinuousStatesChanged   = false;
     comp->nominalsOfContinuousStatesChanged = false;
@@ -0,0 +1,318 @@
+# Generates the modelDescription.xml and size.h of the OscillatorChain model for the
+# number of oscillators and event indicators set in OSCILLATOR_CHAIN_N and OSCILLATOR_CHAIN_NZ.
+#
+# Sets MODEL_DESCRIPTION, GENERATED_INCLUDE_DIR and GENERATED_HEADERS.
+
+set(OSCILLATOR_CHAIN_N 10 CACHE STRING "Number of oscillators of the OscillatorChain model (2 states each)")
+set(OSCILLATOR_CHAIN_NZ 2 CACHE STRING "Number of event indicators of the OscillatorChain model")
+
+set(N ${OSCILLATOR_CHAIN_N})
+set(NZ ${OSCILLATOR_CHAIN_NZ})
+
+if (N LESS 1 OR NZ LESS 0 OR NZ GREATER N)
+  message(FATAL_ERROR "OSCILLATOR_CHAIN_N must be at least 1 and OSCILLATOR_CHAIN_NZ must be in [0, OSCILLATOR_CHAIN_N].")
+endif ()
+
+set(GENERATED_INCLUDE_DIR "${CMAKE_CURRENT_BINARY_DIR}/${MODEL_NAME}")
+set(GENERATED_HEADERS "${GENERATED_INCLUDE_DIR}/size.h")
+set(MODEL_DESCRIPTION "${GENERATED_INCLUDE_DIR}/FMI${FMI_VERSION}.xml")
+
+math(EXPR N_HALF "${N} / 2")
+math(EXPR LAST "${N} - 1")
+
+file(WRITE "${GENERATED_INCLUDE_DIR}/size.h.in" "#ifndef size_h
+#define size_h
+
+// generated by OscillatorChain.cmake
+#define N_OSCILLATORS ${N}
+#define N_EVENT_INDICATORS ${NZ}
+
+#endif /* size_h */
+")
+
+# only touch size.h if the size has changed
+configure_file("${GENERATED_INCLUDE_DIR}/size.h.in" "${GENERATED_INCLUDE_DIR}/size.h" COPYONLY)
+
+# value references (see config.h)
+macro(oscillator_value_references I)
+  math(EXPR VR_X     "4 + 4 * ${I}")
+  math(EXPR VR_DER_X "4 + 4 * ${I} + 1")
+  math(EXPR VR_V     "4 + 4 * ${I} + 2")
+  math(EXPR VR_DER_V "4 + 4 * ${I} + 3")
+  math(EXPR NAME_INDEX "${I} + 1")
+  if (${I} LESS N_HALF)
+    set(X_START 1)
+  else ()
+    set(X_START -1)
+  endif ()
+endmacro()
+
+# the knowns of der(v[i]): x[i - 1], x[i], x[i + 1] and v[i]
+macro(acceleration_dependencies I OFFSET KIND)
+  set(DEPENDENCIES "")
+  set(KINDS "")
+  if (${I} GREATER 0)
+    math(EXPR D "${VR_X} - 4 + ${OFFSET}")
+    string(APPEND DEPENDENCIES "${D} ")
+    string(APPEND KINDS "${KIND} ")
+  endif ()
+  math(EXPR D "${VR_X} + ${OFFSET}")
+  string(APPEND DEPENDENCIES "${D} ")
+  string(APPEND KINDS "${KIND} ")
+  if (${I} LESS LAST)
+    math(EXPR D "${VR_X} + 4 + ${OFFSET}")
+    string(APPEND DEPENDENCIES "${D} ")
+    string(APPEND KINDS "${KIND} ")
+  endif ()
+  math(EXPR D "${VR_V} + ${OFFSET}")
+  string(APPEND DEPENDENCIES "${D}")
+  string(APPEND KINDS "${KIND}")
+endmacro()
+
+# generating the XML for large models takes a while, so it is only done if the
+# size or this file have changed
+file(MD5 "${CMAKE_CURRENT_LIST_FILE}" GENERATOR_MD5)
+set(SIGNATURE "${FMI_VERSION} ${N} ${NZ} ${GENERATOR_MD5}")
+set(SIGNATURE_FILE "${GENERATED_INCLUDE_DIR}/FMI${FMI_VERSION}.signature")
+
+if (EXISTS "${SIGNATURE_FILE}" AND EXISTS "${MODEL_DESCRIPTION}")
+  file(READ "${SIGNATURE_FILE}" PREVIOUS_SIGNATURE)
+else ()
+  set(PREVIOUS_SIGNATURE "")
+endif ()
+
+set(XML_FILE "${MODEL_DESCRIPTION}")
+
+# the XML is written in chunks, so the strings stay small for large models
+set(CHUNK_SIZE 1000)
+
+if (SIGNATURE STREQUAL PREVIOUS_SIGNATURE)
+
+  # the model description is up to date
+
+elseif (${FMI_VERSION} EQUAL 3)
+
+  file(WRITE "${XML_FILE}" "<?xml version=\"1.0\" encoding=\"UTF-8\"?>
+<fmiModelDescription fmiVersion=\"3.0-beta.2\" modelName=\"OscillatorChain\" description=\"Chain of ${N} coupled oscillators\" generationTool=\"Reference FMUs (development build)\" instantiationToken=\"{8c4e810f-3df3-4a00-8276-176fa3c9f009}\">
+
+  <ModelExchange
+    modelIdentifier=\"OscillatorChain\"
+    canGetAndSetFMUState=\"true\"
+    canSerializeFMUState=\"true\"
+    providesDirectionalDerivatives=\"true\"/>
+
+  <CoSimulation
+    modelIdentifier=\"OscillatorChain\"
+    canGetAndSetFMUState=\"true\"
+    canSerializeFMUState=\"true\"
+    canHandleVariableCommunicationStepSize=\"true\"
+    providesIntermediateUpdate=\"true\"
+    canReturnEarlyAfterIntermediateUpdate=\"true\"
+    fixedInternalStepSize=\"1e-2\"
+    providesDirectionalDerivatives=\"true\"/>
+
+  <LogCategories>
+    <Category name=\"logEvents\" description=\"Log events\"/>
+    <Category name=\"logStatusError\" description=\"Log error messages\"/>
+  </LogCategories>
+
+  <DefaultExperiment startTime=\"0\" stopTime=\"10\" stepSize=\"1e-2\"/>
+
+  <ModelVariables>
+    <Float64 name=\"time\" valueReference=\"0\" causality=\"independent\" variability=\"continuous\" description=\"Simulation time\"/>
+    <Float64 name=\"k\" valueReference=\"1\" causality=\"parameter\" variability=\"fixed\" initial=\"exact\" start=\"1\" description=\"Stiffness of the springs\"/>
+    <Float64 name=\"d\" valueReference=\"2\" causality=\"parameter\" variability=\"fixed\" initial=\"exact\" start=\"0.1\" description=\"Damping of the oscillators\"/>
+    <Int32 name=\"crossings\" valueReference=\"3\" causality=\"output\" variability=\"discrete\" initial=\"exact\" start=\"0\" description=\"Zero-crossings of the monitored oscillators\"/>
+")
+
+  set(XML "")
+
+  foreach (I RANGE ${LAST})
+    oscillator_value_references(${I})
+    string(APPEND XML "    <Float64 name=\"x[${NAME_INDEX}]\" valueReference=\"${VR_X}\" causality=\"output\" variability=\"continuous\" initial=\"exact\" start=\"${X_START}\"/>
+    <Float64 name=\"der(x[${NAME_INDEX}])\" valueReference=\"${VR_DER_X}\" causality=\"local\" variability=\"continuous\" initial=\"calculated\" derivative=\"${VR_X}\"/>
+    <Float64 name=\"v[${NAME_INDEX}]\" valueReference=\"${VR_V}\" causality=\"local\" variability=\"continuous\" initial=\"exact\" start=\"0\"/>
+    <Float64 name=\"der(v[${NAME_INDEX}])\" valueReference=\"${VR_DER_V}\" causality=\"local\" variability=\"continuous\" initial=\"calculated\" derivative=\"${VR_V}\"/>
+")
+    math(EXPR R "(${I} + 1) % ${CHUNK_SIZE}")
+    if (R EQUAL 0 OR I EQUAL LAST)
+      file(APPEND "${XML_FILE}" "${XML}")
+      set(XML "")
+    endif ()
+  endforeach ()
+
+  file(APPEND "${XML_FILE}" "  </ModelVariables>
+
+  <ModelStructure>
+    <Output valueReference=\"3\"/>
+")
+
+  foreach (SECTION Output ContinuousStateDerivative InitialUnknown)
+    foreach (I RANGE ${LAST})
+      oscillator_value_references(${I})
+      if (SECTION STREQUAL "Output")
+        string(APPEND XML "    <Output valueReference=\"${VR_X}\"/>\n")
+      elseif (SECTION STREQUAL "ContinuousStateDerivative")
+        acceleration_dependencies(${I} 0 fixed)
+      else ()
+        acceleration_dependencies(${I} 0 dependent)
+      endif ()
+      if (NOT SECTION STREQUAL "Output")
+        string(APPEND XML "    <${SECTION} valueReference=\"${VR_DER_X}\" dependencies=\"${VR_V}\" dependenciesKind=\"constant\"/>
+    <${SECTION} valueReference=\"${VR_DER_V}\" dependencies=\"${DEPENDENCIES}\" dependenciesKind=\"${KINDS}\"/>
+")
+      endif ()
+      math(EXPR R "(${I} + 1) % ${CHUNK_SIZE}")
+      if (R EQUAL 0 OR I EQUAL LAST)
+        file(APPEND "${XML_FILE}" "${XML}")
+        set(XML "")
+      endif ()
+    endforeach ()
+  endforeach ()
+
+  if (NZ GREATER 0)
+    math(EXPR LAST_INDICATOR "${NZ} - 1")
+    foreach (J RANGE ${LAST_INDICATOR})
+      # see EVENT_INDICATOR_OSCILLATOR() in config.h
+      math(EXPR I "((2 * ${J} + 1) * ${N}) / (2 * ${NZ})")
+      oscillator_value_references(${I})
+      string(APPEND XML "    <EventIndicator valueReference=\"${VR_X}\"/>\n")
+    endforeach ()
+    file(APPEND "${XML_FILE}" "${XML}")
+    set(XML "")
+  endif ()
+
+  file(APPEND "${XML_FILE}" "  </ModelStructure>
+
+</fmiModelDescription>
+")
+
+else ()
+
+  # FMI 2.0 references the variables by their index (value reference + 1)
+  file(WRITE "${XML_FILE}" "<?xml version=\"1.0\" encoding=\"UTF-8\"?>
+<fmiModelDescription
+  fmiVersion=\"2.0\"
+  modelName=\"OscillatorChain\"
+  description=\"Chain of ${N} coupled oscillators\"
+  generationTool=\"Reference FMUs (development build)\"
+  guid=\"{8c4e810f-3df3-4a00-8276-176fa3c9f009}\"
+  numberOfEventIndicators=\"${NZ}\">
+
+  <ModelExchange
+    modelIdentifier=\"OscillatorChain\"
+    canNotUseMemoryManagementFunctions=\"true\"
+    canGetAndSetFMUstate=\"true\"
+    canSerializeFMUstate=\"true\"
+    providesDirectionalDerivative=\"true\">
+    <SourceFiles>
+      <File name=\"all.c\"/>
+    </SourceFiles>
+  </ModelExchange>
+
+  <CoSimulation
+    modelIdentifier=\"OscillatorChain\"
+    canHandleVariableCommunicationStepSize=\"true\"
+    canNotUseMemoryManagementFunctions=\"true\"
+    canGetAndSetFMUstate=\"true\"
+    canSerializeFMUstate=\"true\"
+    providesDirectionalDerivative=\"true\">
+    <SourceFiles>
+      <File name=\"all.c\"/>
+    </SourceFiles>
+  </CoSimulation>
+
+  <LogCategories>
+    <Category name=\"logEvents\" description=\"Log events\"/>
+    <Category name=\"logStatusError\" description=\"Log error messages\"/>
+  </LogCategories>
+
+  <DefaultExperiment startTime=\"0\" stopTime=\"10\" stepSize=\"1e-2\"/>
+
+  <ModelVariables>
+    <ScalarVariable name=\"time\" valueReference=\"0\" causality=\"independent\" variability=\"continuous\" description=\"Simulation time\">
+      <Real/>
+    </ScalarVariable>
+    <ScalarVariable name=\"k\" valueReference=\"1\" causality=\"parameter\" variability=\"fixed\" initial=\"exact\" description=\"Stiffness of the springs\">
+      <Real start=\"1\"/>
+    </ScalarVariable>
+    <ScalarVariable name=\"d\" valueReference=\"2\" causality=\"parameter\" variability=\"fixed\" initial=\"exact\" description=\"Damping of the oscillators\">
+      <Real start=\"0.1\"/>
+    </ScalarVariable>
+    <ScalarVariable name=\"crossings\" valueReference=\"3\" causality=\"output\" variability=\"discrete\" initial=\"exact\" description=\"Zero-crossings of the monitored oscillators\">
+      <Integer start=\"0\"/>
+    </ScalarVariable>
+")
+
+  set(XML "")
+
+  foreach (I RANGE ${LAST})
+    oscillator_value_references(${I})
+    math(EXPR INDEX_X "${VR_X} + 1")
+    math(EXPR INDEX_V "${VR_V} + 1")
+    string(APPEND XML "    <ScalarVariable name=\"x[${NAME_INDEX}]\" valueReference=\"${VR_X}\" causality=\"output\" variability=\"continuous\" initial=\"exact\">
+      <Real start=\"${X_START}\"/>
+    </ScalarVariable>
+    <ScalarVariable name=\"der(x[${NAME_INDEX}])\" valueReference=\"${VR_DER_X}\" causality=\"local\" variability=\"continuous\" initial=\"calculated\">
+      <Real derivative=\"${INDEX_X}\"/>
+    </ScalarVariable>
+    <ScalarVariable name=\"v[${NAME_INDEX}]\" valueReference=\"${VR_V}\" causality=\"local\" variability=\"continuous\" initial=\"exact\">
+      <Real start=\"0\"/>
+    </ScalarVariable>
+    <ScalarVariable name=\"der(v[${NAME_INDEX}])\" valueReference=\"${VR_DER_V}\" causality=\"local\" variability=\"continuous\" initial=\"calculated\">
+      <Real derivative=\"${INDEX_V}\"/>
+    </ScalarVariable>
+")
+    math(EXPR R "(${I} + 1) % ${CHUNK_SIZE}")
+    if (R EQUAL 0 OR I EQUAL LAST)
+      file(APPEND "${XML_FILE}" "${XML}")
+      set(XML "")
+    endif ()
+  endforeach ()
+
+  file(APPEND "${XML_FILE}" "  </ModelVariables>
+
+  <ModelStructure>
+    <Outputs>
+      <Unknown index=\"4\" dependencies=\"\"/>
+")
+
+  foreach (SECTION Outputs Derivatives InitialUnknowns)
+    if (NOT SECTION STREQUAL "Outputs")
+      string(APPEND XML "    <${SECTION}>\n")
+    endif ()
+    foreach (I RANGE ${LAST})
+      oscillator_value_references(${I})
+      math(EXPR INDEX_X "${VR_X} + 1")
+      math(EXPR INDEX_DER_X "${VR_DER_X} + 1")
+      math(EXPR INDEX_V "${VR_V} + 1")
+      math(EXPR INDEX_DER_V "${VR_DER_V} + 1")
+      if (SECTION STREQUAL "Outputs")
+        string(APPEND XML "      <Unknown index=\"${INDEX_X}\" dependencies=\"\"/>\n")
+      elseif (SECTION STREQUAL "Derivatives")
+        acceleration_dependencies(${I} 1 fixed)
+      else ()
+        acceleration_dependencies(${I} 1 dependent)
+      endif ()
+      if (NOT SECTION STREQUAL "Outputs")
+        string(APPEND XML "      <Unknown index=\"${INDEX_DER_X}\" dependencies=\"${INDEX_V}\" dependenciesKind=\"constant\"/>
+      <Unknown index=\"${INDEX_DER_V}\" dependencies=\"${DEPENDENCIES}\" dependenciesKind=\"${KINDS}\"/>
+")
+      endif ()
+      math(EXPR R "(${I} + 1) % ${CHUNK_SIZE}")
+      if (R EQUAL 0 OR I EQUAL LAST)
+        file(APPEND "${XML_FILE}" "${XML}")
+        set(XML "")
+      endif ()
+    endforeach ()
+    string(APPEND XML "    </${SECTION}>\n")
+  endforeach ()
+
+  file(APPEND "${XML_FILE}" "${XML}  </ModelStructure>
+
+</fmiModelDescription>
+")
+
+endif ()
+
+file(WRITE "${SIGNATURE_FILE}" "${SIGNATURE}")
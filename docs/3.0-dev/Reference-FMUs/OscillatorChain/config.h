@@ -0,0 +1,64 @@
+#ifndef config_h
+#define config_h
+
+// define class name and unique id
+#define MODEL_IDENTIFIER OscillatorChain
+#define INSTANTIATION_TOKEN "{8c4e810f-3df3-4a00-8276-176fa3c9f009}"
+
+#define CO_SIMULATION
+#define MODEL_EXCHANGE
+
+// number of oscillators and event indicators (generated by OscillatorChain.cmake)
+#include "size.h"
+
+#if N_OSCILLATORS < 1
+#error N_OSCILLATORS must be at least 1
+#endif
+
+#if N_EVENT_INDICATORS > N_OSCILLATORS
+#error N_EVENT_INDICATORS must not be greater than N_OSCILLATORS
+#endif
+
+// define model size
+#define NX (2 * N_OSCILLATORS)
+#define NZ N_EVENT_INDICATORS
+
+#define GET_INT32
+#define SET_FLOAT64
+#define GET_PARTIAL_DERIVATIVE
+#define EVENT_UPDATE
+
+#define FIXED_SOLVER_STEP 1e-2
+#define DEFAULT_STOP_TIME 10
+
+// oscillator i has the value references vr_x(i), vr_der_x(i), vr_v(i) and vr_der_v(i)
+typedef enum {
+    vr_time, vr_k, vr_d, vr_crossings, vr_oscillators
+} ValueReference;
+
+#define vr_x(i)     (vr_oscillators + 4 * (i))
+#define vr_der_x(i) (vr_oscillators + 4 * (i) + 1)
+#define vr_v(i)     (vr_oscillators + 4 * (i) + 2)
+#define vr_der_v(i) (vr_oscillators + 4 * (i) + 3)
+
+#define N_VALUE_REFERENCES vr_x(N_OSCILLATORS)
+
+// event indicator j is the position of the oscillator in the middle of the j-th segment of the chain
+#define EVENT_INDICATOR_OSCILLATOR(j) (((2 * (size_t)(j) + 1) * N_OSCILLATORS) / (2 * NZ))
+
+typedef struct {
+
+    double k;
+    double d;
+
+    double x[N_OSCILLATORS];
+    double v[N_OSCILLATORS];
+
+    // sign of the event indicators at the last event
+    signed char sign[NZ > 0 ? NZ : 1];
+
+    int crossings;
+
+} ModelData;
+
+#endif /* config_h */
@@ -0,0 +1,223 @@
+#include "config.h"
+#include "model.h"
+
+
+#if NZ > 0
+static signed char sign(double value) {
+    return (value > 0) - (value < 0);
+}
+#endif
+
+// acceleration of oscillator i (the ends of the chain are fixed)
+static double acceleration(ModelInstance *comp, size_t i) {
+    const double left  = i > 0 ? M(x)[i - 1] : 0;
+    const double right = i + 1 < N_OSCILLATORS ? M(x)[i + 1] : 0;
+    return M(k) * (left - 2 * M(x)[i] + right) - M(d) * M(v)[i];
+}
+
+void setStartValues(ModelInstance *comp) {
+
+    M(k) = 1;
+    M(d) = 0.1;
+
+    // the left half of the chain is displaced upwards, the right half downwards
+    for (size_t i = 0; i < N_OSCILLATORS; i++) {
+        M(x)[i] = i < N_OSCILLATORS / 2 ? 1 : -1;
+        M(v)[i] = 0;
+    }
+
+#if NZ > 0
+    for (size_t j = 0; j < NZ; j++) {
+        M(sign)[j] = sign(M(x)[EVENT_INDICATOR_OSCILLATOR(j)]);
+    }
+#endif
+
+    M(crossings) = 0;
+}
+
+Status calculateValues(ModelInstance *comp) {
+    UNUSED(comp)
+    // the derivatives are calculated on demand
+    return OK;
+}
+
+Status getFloat64(ModelInstance* comp, ValueReference vr, double *value, size_t *index) {
+
+    switch (vr) {
+        case vr_time:
+            value[(*index)++] = comp->time;
+            return OK;
+        case vr_k:
+            value[(*index)++] = M(k);
+            return OK;
+        case vr_d:
+            value[(*index)++] = M(d);
+            return OK;
+        default:
+            break;
+    }
+
+    if (vr >= vr_oscillators && vr < N_VALUE_REFERENCES) {
+
+        const size_t i = (vr - vr_oscillators) / 4;
+
+        switch ((vr - vr_oscillators) % 4) {
+            case 0:
+                value[(*index)++] = M(x)[i];
+                return OK;
+            case 1:
+                value[(*index)++] = M(v)[i];
+                return OK;
+            case 2:
+                value[(*index)++] = M(v)[i];
+                return OK;
+            default:
+                value[(*index)++] = acceleration(comp, i);
+                return OK;
+        }
+    }
+
+    logError(comp, "Get Float64 is not allowed for value reference %u.", vr);
+    return Error;
+}
+
+Status setFloat64(ModelInstance* comp, ValueReference vr, const double *value, size_t *index) {
+
+    switch (vr) {
+        case vr_k:
+        case vr_d:
+#if FMI_VERSION > 1
+            if (comp->state != Instantiated &&
+                comp->state != InitializationMode) {
+                logError(comp, "Variable %s can only be set after instantiation or in initialization mode.", vr == vr_k ? "k" : "d");
+                return Error;
+            }
+#endif
+            if (vr == vr_k) {
+                M(k) = value[(*index)++];
+            } else {
+                M(d) = value[(*index)++];
+            }
+            return OK;
+        default:
+            break;
+    }
+
+    if (vr >= vr_oscillators && vr < N_VALUE_REFERENCES) {
+
+        const size_t i = (vr - vr_oscillators) / 4;
+
+        switch ((vr - vr_oscillators) % 4) {
+            case 0:
+                M(x)[i] = value[(*index)++];
+                return OK;
+            case 2:
+                M(v)[i] = value[(*index)++];
+                return OK;
+            default:
+                break;
+        }
+    }
+
+    logError(comp, "Set Float64 is not allowed for value reference %u.", vr);
+    return Error;
+}
+
+Status getInt32(ModelInstance* comp, ValueReference vr, int *value, size_t *index) {
+    switch (vr) {
+        case vr_crossings:
+            value[(*index)++] = M(crossings);
+            return OK;
+        default:
+            logError(comp, "Get Int32 is not allowed for value reference %u.", vr);
+            return Error;
+    }
+}
+
+// the states are ordered like their value references: x(0), v(0), x(1), v(1)...
+void getContinuousStates(ModelInstance *comp, double x[], size_t nx) {
+    UNUSED(nx)
+    for (size_t i = 0; i < N_OSCILLATORS; i++) {
+        x[2 * i]     = M(x)[i];
+        x[2 * i + 1] = M(v)[i];
+    }
+}
+
+void setContinuousStates(ModelInstance *comp, const double x[], size_t nx) {
+    UNUSED(nx)
+    for (size_t i = 0; i < N_OSCILLATORS; i++) {
+        M(x)[i] = x[2 * i];
+        M(v)[i] = x[2 * i + 1];
+    }
+}
+
+void getDerivatives(ModelInstance *comp, double dx[], size_t nx) {
+    UNUSED(nx)
+    for (size_t i = 0; i < N_OSCILLATORS; i++) {
+        dx[2 * i]     = M(v)[i];
+        dx[2 * i + 1] = acceleration(comp, i);
+    }
+}
+
+// the Jacobian is sparse: der(x(i)) depends on v(i), der(v(i)) on x(i - 1), x(i), x(i + 1) and v(i)
+Status getPartialDerivative(ModelInstance *comp, ValueReference unknown, ValueReference known, double *partialDerivative) {
+
+    *partialDerivative = 0;
+
+    if (unknown < vr_oscillators || unknown >= N_VALUE_REFERENCES) {
+        return OK;
+    }
+
+    const size_t i = (unknown - vr_oscillators) / 4;
+
+    switch ((unknown - vr_oscillators) % 4) {
+        case 1:
+            if (known == vr_v(i)) {
+                *partialDerivative = 1;
+            }
+            break;
+        case 3:
+            if (known == vr_x(i)) {
+                *partialDerivative = -2 * M(k);
+            } else if ((i > 0 && known == vr_x(i - 1)) || (i + 1 < N_OSCILLATORS && known == vr_x(i + 1))) {
+                *partialDerivative = M(k);
+            } else if (known == vr_v(i)) {
+                *partialDerivative = -M(d);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return OK;
+}
+
+#if NZ > 0
+void getEventIndicators(ModelInstance *comp, double z[], size_t nz) {
+    UNUSED(nz)
+    for (size_t j = 0; j < NZ; j++) {
+        z[j] = M(x)[EVENT_INDICATOR_OSCILLATOR(j)];
+    }
+}
+#endif
+
+void eventUpdate(ModelInstance *comp) {
+
+#if NZ > 0
+    // count the zero-crossings of the monitored oscillators
+    for (size_t j = 0; j < NZ; j++) {
+
+        const signed char s = sign(M(x)[EVENT_INDICATOR_OSCILLATOR(j)]);
+
+        if (s != 0 && s != M(sign)[j]) {
+            M(sign)[j] = s;
+            M(crossings)++;
+        }
+    }
+#endif
+
+    comp->valuesOfContinuousStatesChanged   = false;
+    comp->nominalsOfContinuousStatesChanged = false;
+    comp->terminateSimulation               = false;
+    comp->nextEventTimeDefined              = false;
+}
@@ -1,98 +1,29 @@
 #include "config.h"
 #include "model.h"
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#ifdef _WIN32
-#include "shlwapi.h"
-#pragma comment(lib, "shlwapi.lib")
-#endif
-
-#define MAX_PATH_LENGTH 4096
-
 void setStartValues(ModelInstance *comp) {
     M(y) = 0;
 }
 
 Status calculateValues(ModelInstance *comp) {
 
-    // load the file
-    FILE *file = NULL;
-    char path[MAX_PATH_LENGTH] = "";
-    char c = '\0';
-
-    if (!comp->resourceLocation) {
-        logError(comp, "Resource location must not be NULL.");
-        return Error;
-    }
-
-#ifdef _WIN32
+    const char *data = NULL;
+    size_t size = 0;
 
-#if FMI_VERSION < 3
-    DWORD pathLen = MAX_PATH_LENGTH;
+    // the file is mapped on the first call and shared with the other instances
+    Status status = getResource(comp, "y.txt", &data, &size);
 
-    if (PathCreateFromUrlA(comp->resourceLocation, path, &pathLen, 0) != S_OK) {
-        logError(comp, "Failed to convert resource location to file system path.");
-        return Error;
+    if (status > Warning) {
+        return status;
     }
-#else
-    strncpy(path, comp->resourceLocation, MAX_PATH_LENGTH);
-#endif
-
-#if FMI_VERSION == 1
-    if (!PathAppendA(path, "resources") || !PathAppendA(path, "y.txt")) return Error;
-#elif FMI_VERSION == 2
-    if (!PathAppendA(path, "y.txt")) return Error;
-#else
-    if (!strncat(path, "y.txt", MAX_PATH_LENGTH)) return Error;
-#endif
-
-#else
 
-#if FMI_VERSION < 3
-    const char *scheme1 = "file:///";
-    const char *scheme2 = "file:/";
-
-    if (strncmp(comp->resourceLocation, scheme1, strlen(scheme1)) == 0) {
-        strncpy(path, &comp->resourceLocation[strlen(scheme1)] - 1, MAX_PATH_LENGTH);
-    } else if (strncmp(comp->resourceLocation, scheme2, strlen(scheme2)) == 0) {
-        strncpy(path, &comp->resourceLocation[strlen(scheme2) - 1], MAX_PATH_LENGTH);
-    } else {
-        logError(comp, "The resourceLocation must start with \"file:/\" or \"file:///\"");
+    if (size < 1) {
+        logError(comp, "The resource file y.txt is empty.");
         return Error;
     }
-#else
-    strncpy(path, comp->resourceLocation, MAX_PATH_LENGTH);
-#endif
-
-#if FMI_VERSION == 1
-    strncat(path, "/resources/y.txt", MAX_PATH_LENGTH);
-#elif FMI_VERSION == 2
-    strncat(path, "/y.txt", MAX_PATH_LENGTH);
-#else
-    strncat(path, "y.txt", MAX_PATH_LENGTH);
-#endif
-
-#endif
-
-    // open the resource file
-    file = fopen (path, "r");
-
-    if (!file) {
-        logError(comp, "Failed to open resource file %s.", path);
-        return Error;
-    }
-
-    // read the first character
-    c = (char)fgetc(file);
-
-    // assign it to y
-    M(y) = c;
 
-    // close the file
-    fclose(file);
+    // assign the first character to y
+    M(y) = data[0];
 
     return OK;
 }
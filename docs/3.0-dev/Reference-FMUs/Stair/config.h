@@ -15,6 +15,8 @@
 #define GET_INT32
 #define EVENT_UPDATE
 
+#define N_TIME_EVENTS 1
+
 #define FIXED_SOLVER_STEP 0.2
 #define DEFAULT_STOP_TIME 10
 
@@ -22,6 +24,9 @@ typedef enum {
     vr_time, vr_counter
 } ValueReference;
 
+// time events
+#define EVENT_TICK 0
+
 typedef struct {
 
     int counter;
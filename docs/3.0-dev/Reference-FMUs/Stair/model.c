@@ -1,5 +1,3 @@
-#include <float.h>  // for DBL_EPSILON
-#include <math.h>   // for fabs()
 #include "config.h"
 #include "model.h"
 
@@ -7,9 +5,7 @@
 void setStartValues(ModelInstance *comp) {
     M(counter) = 1;
 
-    // TODO: move this to initialize()?
-    comp->nextEventTime        = 1;
-    comp->nextEventTimeDefined = true;
+    scheduleTimeEvent(comp, EVENT_TICK, 1);
 }
 
 Status calculateValues(ModelInstance *comp) {
@@ -42,15 +38,16 @@ Status getInt32(ModelInstance* comp, ValueReference vr, int *value, size_t *inde
 
 void eventUpdate(ModelInstance *comp) {
 
-    double epsilon = (1.0 + fabs(comp->time)) * DBL_EPSILON;
+    size_t id;
+    double time;
 
-    if (comp->nextEventTimeDefined && comp->time + epsilon >= comp->nextEventTime) {
+    // the next event time is set by the time event queue
+    if (popTimeEvent(comp, &id, &time)) {
         M(counter)++;
-        comp->nextEventTime += 1;
+        scheduleTimeEvent(comp, EVENT_TICK, time + 1);
     }
 
     comp->valuesOfContinuousStatesChanged   = false;
     comp->nominalsOfContinuousStatesChanged = false;
     comp->terminateSimulation               = false;
-    comp->nextEventTimeDefined              = true;
 }
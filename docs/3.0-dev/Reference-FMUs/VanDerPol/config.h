@@ -33,4 +33,10 @@ typedef struct {
 
 } ModelData;
 
+// structure-of-arrays ensemble (see ensemble.h)
+#define ENSEMBLE_N_VARIABLES (vr_mu + 1)
+#define ENSEMBLE_STATES      { vr_x0, vr_x1 }
+#define ENSEMBLE_DERIVATIVES { vr_der_x0, vr_der_x1 }
+#define ENSEMBLE_STATE_NAMES { "x0", "x1" }
+
 #endif /* config_h */
@@ -110,3 +110,31 @@ void eventUpdate(ModelInstance *comp) {
     comp->terminateSimulation               = false;
     comp->nextEventTimeDefined              = false;
 }
+
+#ifdef ENSEMBLE
+
+#include "ensemble.h"
+
+void ensembleSetStartValues(Ensemble *ensemble) {
+    for (size_t i = 0; i < ensemble->stride; i++) {
+        E(vr_x0)[i] = 2;
+        E(vr_x1)[i] = 0;
+        E(vr_mu)[i] = 1;
+    }
+}
+
+void ensembleCalculateValues(Ensemble *ensemble) {
+
+    const double *restrict x0 = E(vr_x0);
+    const double *restrict x1 = E(vr_x1);
+    const double *restrict mu = E(vr_mu);
+    double *restrict der_x0 = E(vr_der_x0);
+    double *restrict der_x1 = E(vr_der_x1);
+
+    for (size_t i = 0; i < ensemble->stride; i++) {
+        der_x0[i] = x1[i];
+        der_x1[i] = mu[i] * ((1.0 - x0[i] * x0[i]) * x1[i]) - x0[i];
+    }
+}
+
+#endif
@@ -21,6 +21,23 @@ endif()
 
 if (${FMI_VERSION} EQUAL 3)
 
+    # simulate
+    add_library(simulate STATIC
+        include/fmi3Functions.h
+        include/fmi3FunctionTypes.h
+        include/FMI.h
+        include/FMI3.h
+        include/FMI3MEDriver.h
+        include/FMI3Simulation.h
+        src/FMI.c
+        src/FMI3.c
+        src/FMI3MEDriver.c
+        src/FMI3Simulation.c
+    )
+    set_target_properties(simulate PROPERTIES FOLDER examples)
+    target_include_directories(simulate PUBLIC include)
+    target_link_libraries(simulate ${LIBRARIES})
+
     # import_static_library
     add_executable(import_static_library
         include/fmi3Functions.h
@@ -54,6 +71,71 @@ if (${FMI_VERSION} EQUAL 3)
     )
     target_link_libraries(import_shared_library ${LIBRARIES})
 
+    # benchmark_static_linking
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT IPO_SUPPORTED LANGUAGES C)
+
+    add_library(benchmark_static_linking_static OBJECT
+        src/fmi3Functions.c
+        VanDerPol/model.c
+        src/cosimulation.c
+        examples/benchmark_static_linking_backend.c
+    )
+    target_compile_definitions(benchmark_static_linking_static PRIVATE FMI3_FUNCTION_PREFIX=VanDerPol_)
+    target_include_directories(benchmark_static_linking_static PRIVATE include src VanDerPol)
+
+    add_library(benchmark_static_linking_shared OBJECT
+        examples/benchmark_static_linking_backend.c
+    )
+    target_include_directories(benchmark_static_linking_shared PRIVATE include src VanDerPol)
+
+    add_executable(benchmark_static_linking
+        $<TARGET_OBJECTS:benchmark_static_linking_static>
+        $<TARGET_OBJECTS:benchmark_static_linking_shared>
+        examples/timer.h
+        examples/benchmark_static_linking.c
+    )
+    add_dependencies(benchmark_static_linking VanDerPol)
+    set_target_properties(benchmark_static_linking benchmark_static_linking_static benchmark_static_linking_shared PROPERTIES FOLDER examples)
+    target_link_libraries(benchmark_static_linking ${LIBRARIES})
+    set_target_properties(benchmark_static_linking PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+    if (IPO_SUPPORTED)
+        set_target_properties(benchmark_static_linking benchmark_static_linking_static benchmark_static_linking_shared PROPERTIES
+            INTERPROCEDURAL_OPTIMIZATION TRUE
+        )
+    endif ()
+
+    # ensemble
+    foreach (MODEL_NAME Dahlquist VanDerPol)
+        set(TARGET_NAME ensemble_${MODEL_NAME})
+        add_executable(${TARGET_NAME}
+            include/ensemble.h
+            include/model.h
+            src/ensemble.c
+            src/fmi3Functions.c
+            src/cosimulation.c
+            ${MODEL_NAME}/config.h
+            ${MODEL_NAME}/model.c
+            examples/timer.h
+            examples/ensemble.c
+        )
+        set_target_properties(${TARGET_NAME} PROPERTIES FOLDER examples)
+        target_include_directories(${TARGET_NAME} PRIVATE include ${MODEL_NAME})
+        target_link_libraries(${TARGET_NAME} ${LIBRARIES})
+        set_target_properties(${TARGET_NAME} PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+    endforeach(MODEL_NAME)
+    target_compile_definitions(ensemble_Dahlquist PRIVATE ENSEMBLE ENSEMBLE_PARAMETER=vr_k)
+    target_compile_definitions(ensemble_VanDerPol PRIVATE ENSEMBLE ENSEMBLE_PARAMETER=vr_mu)
+
     # cs_early_return
     add_executable(cs_early_return
         ${EXAMPLE_SOURCES}
@@ -108,6 +190,36 @@ if (${FMI_VERSION} EQUAL 3)
         RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
     )
 
+    # log_events
+    add_executable(log_events
+        ${EXAMPLE_SOURCES}
+        examples/log_events.c
+    )
+    add_dependencies(log_events BouncingBall)
+    set_target_properties(log_events PROPERTIES FOLDER examples)
+    target_include_directories(log_events PRIVATE include)
+    target_link_libraries(log_events ${LIBRARIES})
+    set_target_properties(log_events PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
+    # resource_sharing
+    add_executable(resource_sharing
+        ${EXAMPLE_SOURCES}
+        examples/resource_sharing.c
+    )
+    add_dependencies(resource_sharing Resource)
+    set_target_properties(resource_sharing PROPERTIES FOLDER examples)
+    target_include_directories(resource_sharing PRIVATE include)
+    target_link_libraries(resource_sharing ${LIBRARIES})
+    set_target_properties(resource_sharing PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
     # jacobian
     add_executable(jacobian
         ${EXAMPLE_SOURCES}
@@ -125,9 +237,28 @@ if (${FMI_VERSION} EQUAL 3)
         RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
     )
 
+    # linear_transform
+    add_executable(linear_transform
+        ${EXAMPLE_SOURCES}
+        LinearTransform/config.h
+        examples/linear_transform.c
+    )
+    add_dependencies(linear_transform LinearTransform)
+    set_target_properties(linear_transform PROPERTIES FOLDER examples)
+    target_compile_definitions(linear_transform PRIVATE DISABLE_PREFIX)
+    target_include_directories(linear_transform PRIVATE include LinearTransform)
+    target_link_libraries(linear_transform ${LIBRARIES})
+    set_target_properties(linear_transform PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
     # scs_synchronous
     add_executable (scs_synchronous
         ${EXAMPLE_SOURCES}
+        include/FMI3ClockScheduler.h
+        src/FMI3ClockScheduler.c
         Clocks/config.h
         examples/Clocks.c
         examples/scs_synchronous.c
@@ -142,6 +273,27 @@ if (${FMI_VERSION} EQUAL 3)
         RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
     )
 
+    # scs_virtual
+    add_executable (scs_virtual
+        ${EXAMPLE_SOURCES}
+        include/FMI3ClockScheduler.h
+        include/FMI3Executor.h
+        include/FMI3VirtualExecutor.h
+        src/FMI3ClockScheduler.c
+        src/FMI3VirtualExecutor.c
+        Clocks/config.h
+        examples/scs_virtual.c
+    )
+    add_dependencies(scs_virtual Clocks)
+    set_target_properties(scs_virtual PROPERTIES FOLDER examples)
+    target_include_directories(scs_virtual PRIVATE include Clocks)
+    target_link_libraries(scs_virtual ${LIBRARIES})
+    set_target_properties(scs_virtual PROPERTIES
+        RUNTIME_OUTPUT_DIRECTORY         temp
+        RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+        RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+    )
+
     if (WIN32)
         add_executable (scs_threaded
             ${EXAMPLE_SOURCES}
@@ -159,6 +311,187 @@ if (${FMI_VERSION} EQUAL 3)
         )
     endif ()
 
+    if (UNIX)
+        find_package(Threads REQUIRED)
+
+        # cs_jacobi
+        add_executable (cs_jacobi
+            ${EXAMPLE_SOURCES}
+            include/FMI3Master.h
+            src/FMI3Master.c
+            examples/timer.h
+            examples/cs_jacobi.c
+        )
+        add_dependencies(cs_jacobi VanDerPol Feedthrough BouncingBall)
+        set_target_properties(cs_jacobi PROPERTIES FOLDER examples)
+        target_include_directories(cs_jacobi PRIVATE include)
+        target_link_libraries(cs_jacobi ${LIBRARIES} Threads::Threads)
+        set_target_properties(cs_jacobi PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+
+        # cs_gauss_seidel
+        add_executable (cs_gauss_seidel
+            ${EXAMPLE_SOURCES}
+            include/FMI3Master.h
+            src/FMI3Master.c
+            examples/cs_gauss_seidel.c
+        )
+        add_dependencies(cs_gauss_seidel VanDerPol Feedthrough LinearTransform BouncingBall)
+        set_target_properties(cs_gauss_seidel PROPERTIES FOLDER examples)
+        target_include_directories(cs_gauss_seidel PRIVATE include)
+        target_link_libraries(cs_gauss_seidel ${LIBRARIES} Threads::Threads)
+        set_target_properties(cs_gauss_seidel PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+
+        # cs_async
+        add_executable (cs_async
+            ${EXAMPLE_SOURCES}
+            include/FMI3Async.h
+            src/FMI3Async.c
+            examples/timer.h
+            examples/cs_async.c
+        )
+        add_dependencies(cs_async VanDerPol Dahlquist BouncingBall)
+        set_target_properties(cs_async PROPERTIES FOLDER examples)
+        target_include_directories(cs_async PRIVATE include)
+        target_link_libraries(cs_async ${LIBRARIES} Threads::Threads)
+        set_target_properties(cs_async PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+
+        # simulate_threads
+        add_executable (simulate_threads
+            examples/simulate_threads.c
+        )
+        add_dependencies(simulate_threads BouncingBall)
+        set_target_properties(simulate_threads PROPERTIES FOLDER examples)
+        target_link_libraries(simulate_threads simulate Threads::Threads)
+        set_target_properties(simulate_threads PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+
+        # cs_variable_step
+        add_executable (cs_variable_step
+            ${EXAMPLE_SOURCES}
+            include/FMI3Master.h
+            src/FMI3Master.c
+            examples/cs_variable_step.c
+        )
+        add_dependencies(cs_variable_step VanDerPol Feedthrough)
+        set_target_properties(cs_variable_step PROPERTIES FOLDER examples)
+        target_include_directories(cs_variable_step PRIVATE include)
+        target_link_libraries(cs_variable_step ${LIBRARIES} Threads::Threads)
+        set_target_properties(cs_variable_step PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+
+        # parameter_sweep
+        add_executable (parameter_sweep
+            ${EXAMPLE_SOURCES}
+            include/FMI3Sweep.h
+            src/FMI3Sweep.c
+            examples/parameter_sweep.c
+        )
+        add_dependencies(parameter_sweep BouncingBall Dahlquist VanDerPol)
+        set_target_properties(parameter_sweep PROPERTIES FOLDER examples)
+        target_include_directories(parameter_sweep PRIVATE include)
+        target_link_libraries(parameter_sweep ${LIBRARIES} Threads::Threads)
+        set_target_properties(parameter_sweep PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+
+        # record_results
+        add_executable (record_results
+            ${EXAMPLE_SOURCES}
+            include/FMIRecorder.h
+            src/FMIRecorder.c
+            VanDerPol/config.h
+            examples/timer.h
+            examples/record_results.c
+        )
+        add_dependencies(record_results VanDerPol)
+        set_target_properties(record_results PROPERTIES FOLDER examples)
+        target_include_directories(record_results PRIVATE include VanDerPol)
+        target_link_libraries(record_results ${LIBRARIES} Threads::Threads)
+        set_target_properties(record_results PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+
+        # benchmarks
+        add_executable (benchmarks
+            ${EXAMPLE_SOURCES}
+            examples/timer.h
+            examples/benchmarks.c
+        )
+        add_dependencies(benchmarks BouncingBall Dahlquist Feedthrough LinearTransform OscillatorChain Resource Stair VanDerPol)
+        set_target_properties(benchmarks PROPERTIES FOLDER examples)
+        target_include_directories(benchmarks PRIVATE include)
+        target_link_libraries(benchmarks ${LIBRARIES})
+        set_target_properties(benchmarks PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY         temp
+            RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+            RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+        )
+
+        if (CMAKE_SYSTEM_NAME STREQUAL "Linux")
+            # scs_realtime
+            add_executable (scs_realtime
+                ${EXAMPLE_SOURCES}
+                include/FMI3ClockScheduler.h
+                include/FMI3Executor.h
+                src/FMI3ClockScheduler.c
+                src/FMI3Executor.c
+                Clocks/config.h
+                examples/scs_realtime.c
+            )
+            add_dependencies(scs_realtime Clocks)
+            set_target_properties(scs_realtime PROPERTIES FOLDER examples)
+            target_include_directories(scs_realtime PRIVATE include Clocks)
+            target_link_libraries(scs_realtime ${LIBRARIES} Threads::Threads)
+            set_target_properties(scs_realtime PROPERTIES
+                RUNTIME_OUTPUT_DIRECTORY         temp
+                RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+                RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+            )
+
+            # benchmark_activation_latency
+            add_executable (benchmark_activation_latency
+                ${EXAMPLE_SOURCES}
+                include/FMI3ClockScheduler.h
+                include/FMI3Executor.h
+                src/FMI3ClockScheduler.c
+                src/FMI3Executor.c
+                Clocks/config.h
+                examples/benchmark_activation_latency.c
+            )
+            add_dependencies(benchmark_activation_latency Clocks)
+            set_target_properties(benchmark_activation_latency PROPERTIES FOLDER examples)
+            target_include_directories(benchmark_activation_latency PRIVATE include Clocks)
+            target_link_libraries(benchmark_activation_latency ${LIBRARIES} Threads::Threads)
+            set_target_properties(benchmark_activation_latency PROPERTIES
+                RUNTIME_OUTPUT_DIRECTORY         temp
+                RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+                RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+            )
+        endif ()
+    endif ()
+
 endif()
 
 # Examples
@@ -166,17 +499,30 @@ endif()
 foreach (MODEL_NAME BouncingBall Dahlquist Feedthrough Resource Stair VanDerPol)
     foreach (INTERFACE_TYPE cs me)
         set(TARGET_NAME ${MODEL_NAME}_${INTERFACE_TYPE})
-        add_executable (${TARGET_NAME}
-            ${EXAMPLE_SOURCES}
-            ${MODEL_NAME}/config.h
-            examples/simulate_fmi${FMI_VERSION}_${INTERFACE_TYPE}.c
-            examples/${MODEL_NAME}.c
-        )
+        if (FMI_VERSION EQUAL 3)
+            add_executable (${TARGET_NAME}
+                examples/util.h
+                ${MODEL_NAME}/config.h
+                examples/simulate_fmi${FMI_VERSION}_${INTERFACE_TYPE}.c
+                examples/${MODEL_NAME}.c
+            )
+            target_link_libraries(${TARGET_NAME} simulate)
+        else ()
+            add_executable (${TARGET_NAME}
+                ${EXAMPLE_SOURCES}
+                ${MODEL_NAME}/config.h
+                examples/simulate_fmi${FMI_VERSION}_${INTERFACE_TYPE}.c
+                examples/${MODEL_NAME}.c
+            )
+            target_link_libraries(${TARGET_NAME} ${LIBRARIES})
+        endif ()
         add_dependencies(${TARGET_NAME} ${MODEL_NAME})
         set_target_properties(${TARGET_NAME} PROPERTIES FOLDER examples)
         target_include_directories(${TARGET_NAME} PRIVATE include ${MODEL_NAME})
         target_compile_definitions(${TARGET_NAME} PRIVATE DISABLE_PREFIX)
-        target_link_libraries(${TARGET_NAME} ${LIBRARIES})
+        if (MODEL_NAME STREQUAL "Feedthrough")
+            target_sources(${TARGET_NAME} PRIVATE include/FMIInputTable.h src/FMIInputTable.c)
+        endif ()
         set_target_properties(${TARGET_NAME} PROPERTIES
             RUNTIME_OUTPUT_DIRECTORY         temp
             RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
@@ -184,3 +530,20 @@ foreach (MODEL_NAME BouncingBall Dahlquist Feedthrough Resource Stair VanDerPol)
         )
     endforeach(INTERFACE_TYPE)
 endforeach(MODEL_NAME)
+
+# validate_result
+add_executable (validate_result
+    include/FMI.h
+    include/FMIValidation.h
+    src/FMIValidation.c
+    examples/timer.h
+    examples/validate_result.c
+)
+set_target_properties(validate_result PROPERTIES FOLDER examples)
+target_include_directories(validate_result PRIVATE include)
+target_link_libraries(validate_result ${LIBRARIES})
+set_target_properties(validate_result PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY         temp
+    RUNTIME_OUTPUT_DIRECTORY_DEBUG   temp
+    RUNTIME_OUTPUT_DIRECTORY_RELEASE temp
+)
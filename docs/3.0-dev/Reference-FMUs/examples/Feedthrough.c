@@ -1,4 +1,7 @@
 #include "util.h"
+#include "FMIInputTable.h"
+
+#define INPUT_FILE "Feedthrough/documentation/Feedthrough_in.csv"
 
 
 FILE *createOutputFile(const char *filename) {
@@ -12,16 +15,47 @@ FILE *createOutputFile(const char *filename) {
     return file;
 }
 
-double nextInputEventTime(double time) {
-    if (time <= 0.5) {
-        return 0.5;
-    } else if (time <= 1.0) {
-        return 1.0;
-    } else if (time <= 1.5) {
-        return 1.0;
-    } else {
-        return INFINITY;
+// the inputs are read from the input table of the FMU
+static FMIInputTable *table = NULL;
+
+static size_t continuousColumns[1];
+static size_t discreteColumns[4];
+
+static void closeInputTable(void) {
+    FMICloseInputTable(table);
+}
+
+static FMIInputTable *inputTable() {
+
+    if (table) {
+        return table;
+    }
+
+    const char *discreteNames[4] = { "real_tunable_param", "real_discrete_in", "int_in", "bool_in" };
+
+    table = FMIOpenInputTable(INPUT_FILE, discreteNames, 4);
+
+    if (!table) {
+        printf("Failed to open %s.\n", INPUT_FILE);
+        return NULL;
+    }
+
+    atexit(closeInputTable);
+
+    FMIInputTableFindColumn(table, "real_continuous_in", &continuousColumns[0]);
+
+    for (size_t i = 0; i < 4; i++) {
+        FMIInputTableFindColumn(table, discreteNames[i], &discreteColumns[i]);
     }
+
+    return table;
+}
+
+double nextInputEventTime(double time) {
+
+    FMIInputTable *table = inputTable();
+
+    return table ? FMIInputTableNextEventTime(table, time) : INFINITY;
 }
 
 FMIStatus applyStartValues(FMIInstance *S) {
@@ -49,56 +83,69 @@ FMIStatus applyStartValues(FMIInstance *S) {
 
 FMIStatus applyContinuousInputs(FMIInstance *S, bool afterEvent) {
 
-#if FMI_VERSION == 2
-    const fmi2ValueReference valueReferences[1] = { vr_continuous_real_in };
-    fmi2Real values[1];
-#else
-    const fmi3ValueReference valueReferences[1] = { vr_continuous_real_in };
-    fmi3Float64 values[1];
-#endif
+    FMIInputTable *table = inputTable();
+
+    if (!table) {
+        return FMIError;
+    }
+
+    double values[1];
+
+    FMIStatus status = FMIInputTableGetValues(table, S->time, afterEvent, continuousColumns, 1, values);
 
-    if (S->time < 0.5) {
-        values[0] = 0.0;
-    } else if (S->time == 0.5) {
-        values[0] = afterEvent ? 2.0 : 0.0;
-    } else if (S->time >= 0.5 && S->time < 1.0) {
-        values[0] = 2.0 - 2.0 * (S->time - 0.5);
-    } else {
-        values[0] = 1.0;
+    if (status > FMIWarning) {
+        return status;
     }
 
 #if FMI_VERSION == 2
-    return FMI2SetReal((FMIInstance *)S, valueReferences, 1, values);
+    const fmi2ValueReference valueReferences[1] = { vr_continuous_real_in };
+    return FMI2SetReal(S, valueReferences, 1, values);
 #else
-    return FMI3SetFloat64((FMIInstance *)S, valueReferences, 1, values, 1);
+    const fmi3ValueReference valueReferences[1] = { vr_continuous_real_in };
+    return FMI3SetFloat64(S, valueReferences, 1, values, 1);
 #endif
 }
 
 FMIStatus applyDiscreteInputs(FMIInstance *S) {
 
+    FMIInputTable *table = inputTable();
+
+    if (!table) {
+        return FMIError;
+    }
+
+    // real_tunable_param, real_discrete_in, int_in, bool_in
+    double values[4];
+
+    FMIStatus status = FMIInputTableGetValues(table, S->time, true, discreteColumns, 4, values);
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
 #if FMI_VERSION == 2
     const fmi2ValueReference float64ValueReferences[2] = { vr_tunable_real_parameter, vr_discrete_real_in };
-    const fmi2Real float64Values[2] = { S->time < 1.5 ? 0.0 : -1.0, S->time < 1.0 ? 0 : 1.0 };
+    const fmi2Real float64Values[2] = { values[0], values[1] };
     FMI2SetReal(S, float64ValueReferences, 1, float64Values);
 
     const fmi2ValueReference int32ValueReferences[1] = { vr_int_in };
-    const fmi2Integer int32Values[1] = { S->time < 1.0 ? 0 : 1 };
+    const fmi2Integer int32Values[1] = { (fmi2Integer)values[2] };
     FMI2SetInteger(S, int32ValueReferences, 1, int32Values);
 
     const fmi2ValueReference booleanValueReferences[1] = { vr_bool_in };
-    const fmi2Boolean booleanValues[1] = { S->time < 1.0 ? false : true };
+    const fmi2Boolean booleanValues[1] = { values[3] != 0 };
     FMI2SetBoolean(S, booleanValueReferences, 1, booleanValues);
 #else
     const fmi3ValueReference float64ValueReferences[2] = { vr_tunable_real_parameter, vr_discrete_real_in };
-    const fmi3Float64 float64Values[2] = { S->time < 1.5 ? 0.0 : -1.0, S->time < 1.0 ? 0 : 1.0 };
+    const fmi3Float64 float64Values[2] = { values[0], values[1] };
     FMI3SetFloat64(S, float64ValueReferences, 1, float64Values, 1);
 
     const fmi3ValueReference int32ValueReferences[1] = { vr_int_in };
-    const fmi3Int32 int32Values[1] = { S->time < 1.0 ? 0 : 1 };
+    const fmi3Int32 int32Values[1] = { (fmi3Int32)values[2] };
     FMI3SetInt32(S, int32ValueReferences, 1, int32Values, 1);
 
     const fmi3ValueReference booleanValueReferences[1] = { vr_bool_in };
-    const fmi3Boolean booleanValues[1] = { S->time < 1.0 ? false : true };
+    const fmi3Boolean booleanValues[1] = { values[3] != 0 };
     FMI3SetBoolean(S, booleanValueReferences, 1, booleanValues, 1);
 #endif
 
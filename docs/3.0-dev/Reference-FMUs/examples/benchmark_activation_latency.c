@@ -0,0 +1,508 @@
+/* This benchmark measures the latency and jitter of fmi3ActivateModelPartition() for the
+   clocks of the Clocks FMU under FMI3Executor. For every activation the release, start and
+   finish time are taken from CLOCK_MONOTONIC and collected in histograms per clock:
+
+   latency       start - release
+   responseTime  finish - release
+   jitter        deviation of the time between two starts from the period (periodic clocks only)
+
+   The load is injected by model partition 3, which burns burnIterations loop iterations
+   and is triggered every loadPeriod ticks of inClock1. The results are written as JSON
+   together with the cost of an uncontended FMI3ExecutorLockPreemption() / FMI3ExecutorUnlockPreemption().
+   The preemption lock is also checked for mutual exclusion (threads that increment a counter
+   under the nested lock) and priority inheritance (the owner must be boosted while a
+   SCHED_FIFO thread is blocked on the lock).
+
+   Usage: benchmark_activation_latency [nTicks] [period_us] [burnIterations] [loadPeriod] [output.json] [cpu] */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // sched_getcpu()
+#endif
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "FMI3ClockScheduler.h"
+#include "FMI3Executor.h"
+#include "config.h"
+
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#define MODEL_DESCRIPTION(m) m "/modelDescription.xml"
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+// number of uncontended lock / unlock pairs to measure
+#define N_LOCKS 10000000
+
+// number of threads and nested lock / unlock pairs per thread to check the mutual exclusion
+#define N_LOCK_THREADS 4
+#define N_CONTENDED_LOCKS 100000
+
+// bin i counts the values in [2^i, 2^(i+1)) ns, bin 0 also the values below 1 ns
+#define N_BINS 40
+
+typedef struct {
+    size_t n;
+    double min;
+    double max;
+    double sum;
+    double sumOfSquares;
+    size_t bins[N_BINS];
+} Histogram;
+
+typedef struct {
+    const char *name;
+    fmi3ValueReference clockReference;
+    fmi3Int32 priority; // from the modelDescription.xml
+    double period; // wall-clock period of periodic clocks in seconds
+    double lastStartTime;
+    Histogram latency;
+    Histogram responseTime;
+    Histogram jitter;
+} Clock;
+
+static Clock clocks[N_INPUT_CLOCKS] = {
+    { "inClock1", vr_inClock1 },
+    { "inClock2", vr_inClock2 },
+    { "inClock3", vr_inClock3 },
+};
+
+static FMI3Executor *executor = NULL;
+static int loadPeriod = 10;
+static double preemptionLockTime = 0; // per lock / unlock pair in seconds
+static size_t preemptionLockCount = 0; // incremented with the preemption lock held
+static int priorityInheritance = -1;   // 1: the owner was boosted, 0: it was not, -1: not checked
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+static void cb_intermediateUpdate(fmi3InstanceEnvironment instanceEnvironment,
+    fmi3Float64 intermediateUpdateTime,
+    fmi3Boolean clocksTicked,
+    fmi3Boolean intermediateVariableSetRequested,
+    fmi3Boolean intermediateVariableGetAllowed,
+    fmi3Boolean intermediateStepFinished,
+    fmi3Boolean canReturnEarly,
+    fmi3Boolean *earlyReturnRequested,
+    fmi3Float64 *earlyReturnTime) {
+
+    FMIInstance *S = instanceEnvironment;
+
+    const fmi3ValueReference countdownClocks[1] = { vr_inClock3 };
+    fmi3Float64 intervals[1] = { 0 };
+    fmi3IntervalQualifier qualifiers[1] = { fmi3IntervalNotYetKnown };
+
+    const fmi3ValueReference outputClocks[1] = { vr_outClock };
+    fmi3Clock outputClockValues[1] = { fmi3ClockInactive };
+
+    *earlyReturnRequested = fmi3False;
+
+    if (!clocksTicked) {
+        return;
+    }
+
+    FMI3ExecutorLockPreemption();
+    FMI3GetIntervalDecimal(S, countdownClocks, 1, intervals, qualifiers, 1);
+    FMI3GetClock(S, outputClocks, 1, outputClockValues, 1);
+    FMI3ExecutorUnlockPreemption();
+
+    if (qualifiers[0] == fmi3IntervalChanged) {
+        FMI3ExecutorTrigger(executor, vr_inClock3, intermediateUpdateTime + intervals[0]);
+    }
+}
+
+static FMIStatus afterActivation1(FMIInstance *S, fmi3ValueReference clockReference, fmi3Float64 activationTime, void *userData) {
+
+    const int t = (int)activationTime;
+
+    if (t % 8 == 0 || (t - 1) % 8 == 0) {
+        FMI3ExecutorTrigger(executor, vr_inClock2, activationTime);
+    }
+
+    // inject the load
+    if (loadPeriod > 0 && t % loadPeriod == loadPeriod - 1) {
+        FMI3ExecutorTrigger(executor, vr_inClock3, activationTime);
+    }
+
+    return FMIOK;
+}
+
+static void addValue(Histogram *histogram, double value) {
+
+    histogram->min = histogram->n > 0 ? fmin(histogram->min, value) : value;
+    histogram->max = histogram->n > 0 ? fmax(histogram->max, value) : value;
+
+    histogram->n++;
+    histogram->sum          += value;
+    histogram->sumOfSquares += value * value;
+
+    const double ns = value * 1e9;
+
+    int bin = ns < 1 ? 0 : (int)log2(ns);
+
+    if (bin >= N_BINS) {
+        bin = N_BINS - 1;
+    }
+
+    histogram->bins[bin]++;
+}
+
+// called on the thread of the clock, so the clocks need no lock
+static void activationFinished(const FMI3ActivationRecord *record, void *userData) {
+
+    Clock *clock = NULL;
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+        if (clocks[i].clockReference == record->clockReference) {
+            clock = &clocks[i];
+        }
+    }
+
+    if (!clock) {
+        return;
+    }
+
+    addValue(&clock->latency, record->startTime - record->releaseTime);
+    addValue(&clock->responseTime, record->finishTime - record->releaseTime);
+
+    if (clock->period > 0 && clock->latency.n > 1) {
+        addValue(&clock->jitter, fabs(record->startTime - clock->lastStartTime - clock->period));
+    }
+
+    clock->lastStartTime = record->startTime;
+}
+
+static void writeHistogram(FILE *file, const char *name, const Histogram *histogram, bool last) {
+
+    const double mean = histogram->n > 0 ? histogram->sum / histogram->n : 0;
+    const double variance = histogram->n > 1 ? (histogram->sumOfSquares - histogram->n * mean * mean) / (histogram->n - 1) : 0;
+
+    fprintf(file, "      \"%s\": {\n", name);
+    fprintf(file, "        \"count\": %zu,\n", histogram->n);
+    fprintf(file, "        \"min_ns\": %.1f,\n", histogram->min * 1e9);
+    fprintf(file, "        \"mean_ns\": %.1f,\n", mean * 1e9);
+    fprintf(file, "        \"max_ns\": %.1f,\n", histogram->max * 1e9);
+    fprintf(file, "        \"stddev_ns\": %.1f,\n", sqrt(fmax(variance, 0)) * 1e9);
+    fprintf(file, "        \"histogram\": [");
+
+    bool first = true;
+
+    for (int i = 0; i < N_BINS; i++) {
+
+        if (histogram->bins[i] == 0) {
+            continue;
+        }
+
+        fprintf(file, "%s\n          { \"upper_ns\": %.0f, \"count\": %zu }", first ? "" : ",", ldexp(1, i + 1), histogram->bins[i]);
+
+        first = false;
+    }
+
+    fprintf(file, "%s]\n", first ? "" : "\n        ");
+    fprintf(file, "      }%s\n", last ? "" : ",");
+}
+
+static double currentTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double measurePreemptionLock(void) {
+
+    const double startTime = currentTime();
+
+    for (int i = 0; i < N_LOCKS; i++) {
+        FMI3ExecutorLockPreemption();
+        FMI3ExecutorUnlockPreemption();
+    }
+
+    return (currentTime() - startTime) / N_LOCKS;
+}
+
+static void *incrementPreemptionLockCount(void *arg) {
+
+    for (int i = 0; i < N_CONTENDED_LOCKS; i++) {
+        FMI3ExecutorLockPreemption();
+        FMI3ExecutorLockPreemption();
+        preemptionLockCount++;
+        FMI3ExecutorUnlockPreemption();
+        FMI3ExecutorUnlockPreemption();
+    }
+
+    return NULL;
+}
+
+static bool checkMutualExclusion(void) {
+
+    pthread_t threads[N_LOCK_THREADS];
+    size_t nThreads = 0;
+
+    for (; nThreads < N_LOCK_THREADS; nThreads++) {
+        if (pthread_create(&threads[nThreads], NULL, incrementPreemptionLockCount, NULL) != 0) {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < nThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    return nThreads == N_LOCK_THREADS;
+}
+
+// kernel priority of the calling thread (field 18 of /proc/thread-self/stat, negative for SCHED_FIFO)
+static long threadPriority(void) {
+
+    char buffer[1024];
+    size_t length = 0;
+
+    FILE *file = fopen("/proc/thread-self/stat", "r");
+
+    if (file) {
+        length = fread(buffer, 1, sizeof(buffer) - 1, file);
+        fclose(file);
+    }
+
+    buffer[length] = '\0';
+
+    // the fields 3 (state) to 52 follow the command name in parentheses
+    const char *p = strrchr(buffer, ')');
+
+    for (int field = 3; p && field <= 18; field++) {
+        p = strchr(p + 1, ' ');
+    }
+
+    return p ? strtol(p + 1, NULL, 10) : LONG_MAX;
+}
+
+static void *blockOnPreemptionLock(void *arg) {
+    FMI3ExecutorLockPreemption();
+    FMI3ExecutorUnlockPreemption();
+    return NULL;
+}
+
+// block a SCHED_FIFO thread on the preemption lock held by the calling (SCHED_OTHER) thread
+static void checkPriorityInheritance(void) {
+
+    pthread_attr_t attr;
+    pthread_t thread;
+    struct sched_param param = { .sched_priority = sched_get_priority_min(SCHED_FIFO) };
+
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+
+    const long priority = threadPriority();
+
+    FMI3ExecutorLockPreemption();
+
+    // fails if SCHED_FIFO is not permitted
+    if (pthread_create(&thread, &attr, blockOnPreemptionLock, NULL) == 0) {
+
+        const struct timespec delay = { 0, 1000000 };
+
+        priorityInheritance = 0;
+
+        // wait up to 1 s for the thread to block and boost the owner
+        for (int i = 0; i < 1000 && !priorityInheritance; i++) {
+            nanosleep(&delay, NULL);
+            priorityInheritance = threadPriority() < priority;
+        }
+
+        FMI3ExecutorUnlockPreemption();
+
+        pthread_join(thread, NULL);
+
+    } else {
+        FMI3ExecutorUnlockPreemption();
+    }
+
+    pthread_attr_destroy(&attr);
+}
+
+static bool writeResults(const char *filename, int nTicks, double period, int burnIterations) {
+
+    FILE *file = fopen(filename, "w");
+
+    if (!file) {
+        printf("Failed to create %s.\n", filename);
+        return false;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"ticks\": %d,\n", nTicks);
+    fprintf(file, "  \"period_ns\": %.0f,\n", period * 1e9);
+    fprintf(file, "  \"burnIterations\": %d,\n", burnIterations);
+    fprintf(file, "  \"loadPeriod\": %d,\n", loadPeriod);
+    fprintf(file, "  \"realTime\": %s,\n", FMI3ExecutorIsRealTime(executor) ? "true" : "false");
+    fprintf(file, "  \"preemptionLock_ns\": %.2f,\n", preemptionLockTime * 1e9);
+    fprintf(file, "  \"preemptionLockCount\": %zu,\n", preemptionLockCount);
+    fprintf(file, "  \"preemptionLockExpectedCount\": %d,\n", N_LOCK_THREADS * N_CONTENDED_LOCKS);
+    fprintf(file, "  \"priorityInheritance\": %s,\n", priorityInheritance < 0 ? "null" : priorityInheritance ? "true" : "false");
+    fprintf(file, "  \"clocks\": [\n");
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+
+        const Clock *clock = &clocks[i];
+
+        FMI3TaskStatistics statistics = { 0 };
+
+        FMI3ExecutorGetStatistics(executor, clock->clockReference, &statistics);
+
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", clock->name);
+        fprintf(file, "      \"valueReference\": %u,\n", clock->clockReference);
+        fprintf(file, "      \"priority\": %d,\n", clock->priority);
+        fprintf(file, "      \"activations\": %zu,\n", statistics.nActivations);
+        fprintf(file, "      \"overruns\": %zu,\n", statistics.nOverruns);
+        fprintf(file, "      \"dropped\": %zu,\n", statistics.nDropped);
+
+        writeHistogram(file, "latency", &clock->latency, false);
+        writeHistogram(file, "responseTime", &clock->responseTime, false);
+        writeHistogram(file, "jitter", &clock->jitter, true);
+
+        fprintf(file, "    }%s\n", i + 1 < N_INPUT_CLOCKS ? "," : "");
+    }
+
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+
+    fclose(file);
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+
+    const int nTicks         = argc > 1 ? atoi(argv[1]) : 1000;
+    const double period      = (argc > 2 ? atof(argv[2]) : 1000) * 1e-6;
+    const int burnIterations = argc > 3 ? atoi(argv[3]) : 100000;
+    const char *outputFile   = argc > 5 ? argv[5] : "activation_latency.json";
+
+    loadPeriod = argc > 4 ? atoi(argv[4]) : 10;
+
+    if (nTicks <= 0 || period <= 0 || burnIterations < 0) {
+        printf("Usage: benchmark_activation_latency [nTicks] [period_us] [burnIterations] [loadPeriod] [output.json] [cpu]\n");
+        return EXIT_FAILURE;
+    }
+
+    const fmi3ValueReference clockReferences[N_INPUT_CLOCKS] = { vr_inClock1, vr_inClock2, vr_inClock3 };
+    fmi3Int32 priorities[N_INPUT_CLOCKS];
+
+    if (FMI3ReadClockPriorities(MODEL_DESCRIPTION("Clocks"), clockReferences, priorities, N_INPUT_CLOCKS) != FMIOK) {
+        printf("Failed to read the clock priorities from %s.\n", MODEL_DESCRIPTION("Clocks"));
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+        clocks[i].priority = priorities[i];
+    }
+
+    // inClock1 ticks every second
+    const FMI3ExecutorTask tasks[N_INPUT_CLOCKS] = {
+        { vr_inClock1, priorities[0], 1, 0, NULL, afterActivation1, NULL },
+        { vr_inClock2, priorities[1], 0, 0, NULL, NULL,             NULL },
+        { vr_inClock3, priorities[2], 0, 0, NULL, NULL,             NULL },
+    };
+
+    clocks[0].period = period;
+
+    const fmi3ValueReference parameters[1] = { vr_burnIterations };
+    const fmi3Int32 parameterValues[1] = { burnIterations };
+
+    FMIStatus status = FMIOK;
+
+    const FMI3ExecutorSettings settings = {
+        .cpu                = argc > 6 ? atoi(argv[6]) : sched_getcpu(),
+        .realTime           = true,
+        .maxPriority        = 0,
+        .timeScale          = period,
+        .activationFinished = activationFinished,
+        .userData           = NULL
+    };
+
+    FMIInstance *S = FMICreateInstance("instance1", PLATFORM_BINARY("Clocks"), cb_logMessage, NULL);
+
+    if (!S) {
+        return EXIT_FAILURE;
+    }
+
+    CALL(FMI3InstantiateScheduledExecution(S,
+        INSTANTIATION_TOKEN,            // instantiationToken
+        NULL,                           // resourcePath
+        fmi3False,                      // visible
+        fmi3False,                      // loggingOn
+        NULL,                           // requiredIntermediateVariables
+        0,                              // nRequiredIntermediateVariables
+        cb_intermediateUpdate,          // intermediateUpdate
+        FMI3ExecutorLockPreemption,     // lockPreemption
+        FMI3ExecutorUnlockPreemption    // unlockPreemption
+    ));
+
+    CALL(FMI3SetInt32(S, parameters, 1, parameterValues, 1));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3True, nTicks));
+    CALL(FMI3ExitInitializationMode(S));
+
+    executor = FMI3CreateExecutor(S, tasks, N_INPUT_CLOCKS, &settings);
+
+    if (!executor) {
+        printf("Failed to create the executor.\n");
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    CALL(FMI3ExecutorRun(executor, 0, nTicks));
+
+    preemptionLockTime = measurePreemptionLock();
+
+    if (!checkMutualExclusion()) {
+        printf("Failed to create the threads for the preemption lock.\n");
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    checkPriorityInheritance();
+
+    printf("%-10s %9s %9s %12s %12s %12s %12s\n", "clock", "priority", "count", "latency max", "latency avg", "response max", "jitter max");
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+
+        const Clock *clock = &clocks[i];
+
+        printf("%-10s %9d %9zu %9.1f us %9.1f us %9.1f us %9.1f us\n", clock->name, clock->priority, clock->latency.n,
+            clock->latency.max * 1e6, clock->latency.n > 0 ? clock->latency.sum / clock->latency.n * 1e6 : 0,
+            clock->responseTime.max * 1e6, clock->jitter.max * 1e6);
+    }
+
+    printf("\nlockPreemption / unlockPreemption (uncontended): %.2f ns\n", preemptionLockTime * 1e9);
+    printf("preemption lock: %zu of %d increments, priority inheritance: %s\n", preemptionLockCount, N_LOCK_THREADS * N_CONTENDED_LOCKS,
+        priorityInheritance < 0 ? "not checked" : priorityInheritance ? "yes" : "no");
+
+    if (!writeResults(outputFile, nTicks, period, burnIterations)) {
+        status = FMIError;
+    }
+
+    CALL(FMI3Terminate(S));
+
+TERMINATE:
+
+    if (S->component) {
+        FMI3FreeInstance(S);
+    }
+
+    FMI3FreeExecutor(executor);
+
+    FMIFreeInstance(S);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
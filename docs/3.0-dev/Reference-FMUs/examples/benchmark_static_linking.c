@@ -0,0 +1,55 @@
+/* This example compares the overhead of calling a statically linked FMU through the
+   FMI3* functions with FMI3_FUNCTION_PREFIX (direct calls that can be inlined with LTO)
+   to calling the same FMU loaded from a shared library (calls through function pointers).
+   Both variants must compute the same states. Build with CMAKE_BUILD_TYPE=Release to get
+   meaningful numbers. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N_CALLS 1000000
+
+int benchmarkStaticLinking(size_t nCalls, double results[3], double x[2]);
+
+int benchmarkSharedLibrary(size_t nCalls, double results[3], double x[2]);
+
+int main(int argc, char* argv[]) {
+
+    const char *names[] = { "fmi3GetFloat64", "fmi3SetFloat64", "fmi3DoStep" };
+
+    double staticLinking[3];
+    double sharedLibrary[3];
+
+    double xStaticLinking[2];
+    double xSharedLibrary[2];
+
+    size_t nCalls = argc > 1 ? strtoul(argv[1], NULL, 10) : N_CALLS;
+
+    if (nCalls == 0) {
+        printf("Usage: benchmark_static_linking [nCalls]\n");
+        return EXIT_FAILURE;
+    }
+
+    if (benchmarkStaticLinking(nCalls, staticLinking, xStaticLinking) != 0) {
+        printf("Benchmark for the statically linked FMU failed.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (benchmarkSharedLibrary(nCalls, sharedLibrary, xSharedLibrary) != 0) {
+        printf("Benchmark for the shared library failed.\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-16s %16s %16s\n", "ns/call", "static linking", "shared library");
+
+    for (size_t i = 0; i < 3; i++) {
+        printf("%-16s %16.2f %16.2f\n", names[i], staticLinking[i], sharedLibrary[i]);
+    }
+
+    const double maxDifference = fmax(fabs(xStaticLinking[0] - xSharedLibrary[0]), fabs(xStaticLinking[1] - xSharedLibrary[1]));
+
+    printf("max. difference of the states: %g\n", maxDifference);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+/* This file is compiled twice for benchmark_static_linking.c: with FMI3_FUNCTION_PREFIX
+   defined the FMI3* functions call the statically linked VanDerPol model directly,
+   otherwise the model is loaded from the shared library. */
+
+// keep the importer functions local to this translation unit
+#define FMI_STATIC static
+
+#include "FMI.c"
+#include "FMI3.c"
+
+#include "config.h"
+#include "timer.h"
+
+// "stringification" macros
+#define xstr(s) str(s)
+#define str(s) #s
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY  xstr(MODEL_IDENTIFIER) "\\binaries\\x86_64-windows\\" xstr(MODEL_IDENTIFIER) ".dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY  xstr(MODEL_IDENTIFIER) "/binaries/x86_64-darwin/" xstr(MODEL_IDENTIFIER) ".dylib"
+#else
+#define PLATFORM_BINARY  xstr(MODEL_IDENTIFIER) "/binaries/x86_64-linux/" xstr(MODEL_IDENTIFIER) ".so"
+#endif
+
+#if defined(FMI3_FUNCTION_PREFIX)
+#define BENCHMARK_FUNCTION benchmarkStaticLinking
+#else
+#define BENCHMARK_FUNCTION benchmarkSharedLibrary
+#endif
+
+// results[0]: fmi3GetFloat64, results[1]: fmi3SetFloat64, results[2]: fmi3DoStep in ns/call,
+// x: states after the steps
+int BENCHMARK_FUNCTION(size_t nCalls, double results[3], double x[2]) {
+
+    const fmi3ValueReference vr_x[] = { vr_x0, vr_x1 };
+    const fmi3ValueReference vr[]   = { vr_mu };
+
+    fmi3Float64 mu = 1;
+    fmi3Float64 time = 0;
+    fmi3Float64 h = FIXED_SOLVER_STEP;
+
+    fmi3Boolean eventEncountered, terminateSimulation, earlyReturn;
+    fmi3Float64 lastSuccessfulTime;
+
+    fmi3Status status = fmi3Error;
+
+    double start;
+
+    FMIInstance *S = FMICreateInstance("instance1", PLATFORM_BINARY, NULL, NULL);
+
+    if (!S) {
+        return fmi3Error;
+    }
+
+    if (FMI3InstantiateCoSimulation(S, INSTANTIATION_TOKEN, NULL, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL) > fmi3OK) goto TERMINATE;
+    if (FMI3EnterInitializationMode(S, fmi3False, 0, time, fmi3False, 0) > fmi3OK) goto TERMINATE;
+    if (FMI3ExitInitializationMode(S) > fmi3OK) goto TERMINATE;
+
+    start = currentTime();
+
+    for (size_t i = 0; i < nCalls; i++) {
+        FMI3GetFloat64(S, vr_x, 2, x, 2);
+    }
+
+    results[0] = (currentTime() - start) * 1e9 / nCalls;
+
+    start = currentTime();
+
+    for (size_t i = 0; i < nCalls; i++) {
+        FMI3SetFloat64(S, vr, 1, &mu, 1);
+    }
+
+    results[1] = (currentTime() - start) * 1e9 / nCalls;
+
+    start = currentTime();
+
+    for (size_t i = 0; i < nCalls; i++) {
+        FMI3DoStep(S, time, h, fmi3True, &eventEncountered, &terminateSimulation, &earlyReturn, &lastSuccessfulTime);
+        time += h;
+    }
+
+    results[2] = (currentTime() - start) * 1e9 / nCalls;
+
+    FMI3GetFloat64(S, vr_x, 2, x, 2);
+
+    status = S->status;
+
+TERMINATE:
+
+    if (S->component) {
+        FMI3Terminate(S);
+        FMI3FreeInstance(S);
+    }
+
+    FMIFreeInstance(S);
+
+    return status;
+}
@@ -0,0 +1,639 @@
+/* This benchmark loads each of the Reference FMUs through FMICreateInstance() and measures
+   the time per call (in ns) of
+
+   - fmi3InstantiateCoSimulation() + fmi3FreeInstance()
+   - fmi3Reset()
+   - fmi3GetDirectionalDerivative() in Initialization Mode (if provided)
+   - fmi3Get{Type}() and fmi3Set{Type}() for batches of 1 to 1024 variables in Step Mode
+   - fmi3GetFMUState() (re-using the memory of the FMU state) and fmi3SetFMUState()
+   - fmi3DoStep() with different communication step sizes
+
+   Every measurement repeats the call and doubles the number of calls until the run
+   takes at least minDuration. The batches cycle through the variables of the model,
+   so a batch of 1024 may contain the same variable many times. The results are printed
+   and written as JSON. Models whose shared library cannot be loaded are skipped. Build
+   with CMAKE_BUILD_TYPE=Release to get meaningful numbers.
+
+   Usage: benchmarks [minDuration_ms] [output.json] */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3.h"
+#include "timer.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY(m) m "\\binaries\\x86_64-windows\\" m ".dll"
+#define RESOURCES(m) m "\\resources\\"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#define RESOURCES(m) m "/resources/"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#define RESOURCES(m) m "/resources/"
+#endif
+
+#define MAX_VARIABLES 4
+#define MAX_ELEMENTS 5 // the largest array variable (LinearTransform)
+#define MAX_BATCH_SIZE 1024
+#define MAX_VALUES (MAX_BATCH_SIZE * MAX_ELEMENTS)
+#define N_BATCH_SIZES 11
+#define N_STEP_SIZES 4
+
+typedef enum {
+    Float64,
+    Int32,
+    UInt64,
+    Boolean,
+    String,
+    Binary,
+    N_TYPES
+} VariableType;
+
+static const char *typeNames[N_TYPES] = { "Float64", "Int32", "UInt64", "Boolean", "String", "Binary" };
+
+static const size_t batchSizes[N_BATCH_SIZES] = { 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024 };
+
+static const fmi3Float64 stepSizes[N_STEP_SIZES] = { 1e-3, 1e-2, 1e-1, 1 };
+
+typedef struct {
+    fmi3ValueReference valueReference;
+    size_t nElements; // 0 = end of the list
+} Variable;
+
+typedef struct {
+    const char *modelIdentifier;
+    const char *platformBinary;
+    const char *resources;
+    const char *instantiationToken;
+    Variable get[N_TYPES][MAX_VARIABLES]; // variables to get in Step Mode
+    Variable set[N_TYPES][MAX_VARIABLES]; // variables that can be set in Step Mode
+    fmi3ValueReference unknowns[MAX_VARIABLES];
+    size_t nUnknowns;
+    fmi3ValueReference knowns[MAX_VARIABLES];
+    size_t nKnowns;
+} Model;
+
+static const Model models[] = {
+    {
+        "BouncingBall", PLATFORM_BINARY("BouncingBall"), RESOURCES("BouncingBall"), "{8c4e810f-3df3-4a00-8276-176fa3c9f003}",
+        .get = { [Float64] = { { 1, 1 }, { 3, 1 }, { 5, 1 }, { 6, 1 } } },
+        .set = { [Float64] = { { 1, 1 }, { 3, 1 } } }
+    },
+    {
+        "Dahlquist", PLATFORM_BINARY("Dahlquist"), RESOURCES("Dahlquist"), "{8c4e810f-3df3-4a00-8276-176fa3c9f000}",
+        .get = { [Float64] = { { 1, 1 }, { 3, 1 } } },
+        .set = { [Float64] = { { 1, 1 } } }
+    },
+    {
+        "Feedthrough", PLATFORM_BINARY("Feedthrough"), RESOURCES("Feedthrough"), "{8c4e810f-3df3-4a00-8276-176fa3c9f004}",
+        .get = {
+            [Float64] = { { 3, 1 }, { 4, 1 } },
+            [Int32]   = { { 7, 1 }, { 8, 1 } },
+            [Boolean] = { { 9, 1 }, { 10, 1 } },
+            [String]  = { { 11, 1 } },
+            [Binary]  = { { 12, 1 }, { 13, 1 } }
+        },
+        .set = {
+            [Float64] = { { 3, 1 } },
+            [Int32]   = { { 7, 1 } },
+            [Boolean] = { { 9, 1 } },
+            [String]  = { { 11, 1 } },
+            [Binary]  = { { 12, 1 } }
+        }
+    },
+    {
+        "LinearTransform", PLATFORM_BINARY("LinearTransform"), RESOURCES("LinearTransform"), "{8c4e810f-3df3-4a00-8276-176fa3c9f000}",
+        .get = {
+            [Float64] = { { 3, 2 }, { 4, 4 }, { 5, 2 } },
+            [UInt64]  = { { 1, 1 }, { 2, 1 } }
+        },
+        .set = { [Float64] = { { 3, 2 }, { 4, 4 } } }
+    },
+    {
+        "OscillatorChain", PLATFORM_BINARY("OscillatorChain"), RESOURCES("OscillatorChain"), "{8c4e810f-3df3-4a00-8276-176fa3c9f009}",
+        .get = {
+            [Float64] = { { 4, 1 }, { 5, 1 }, { 6, 1 }, { 7, 1 } },
+            [Int32]   = { { 3, 1 } }
+        },
+        .set = { [Float64] = { { 4, 1 }, { 6, 1 } } },
+        .unknowns = { 5, 7 }, .nUnknowns = 2,
+        .knowns = { 4, 6, 8 }, .nKnowns = 3
+    },
+    {
+        "Resource", PLATFORM_BINARY("Resource"), RESOURCES("Resource"), "{7b9c2114-2ce5-4076-a138-2cbc69e069e5}",
+        .get = { [Int32] = { { 1, 1 } } }
+    },
+    {
+        "Stair", PLATFORM_BINARY("Stair"), RESOURCES("Stair"), "{8c4e810f-3df3-4a00-8276-176fa3c9f008}",
+        .get = { [Int32] = { { 1, 1 } } }
+    },
+    {
+        "VanDerPol", PLATFORM_BINARY("VanDerPol"), RESOURCES("VanDerPol"), "{8c4e810f-3da3-4a00-8276-176fa3c9f000}",
+        .get = { [Float64] = { { 1, 1 }, { 3, 1 }, { 5, 1 } } },
+        .set = { [Float64] = { { 1, 1 }, { 3, 1 } } },
+        .unknowns = { 2, 4 }, .nUnknowns = 2,
+        .knowns = { 1, 3 }, .nKnowns = 2
+    }
+};
+
+#define N_MODELS (sizeof(models) / sizeof(Model))
+
+// ns per call (NAN = not measured)
+typedef struct {
+    bool loaded;
+    double instantiate;
+    double reset;
+    double directionalDerivative;
+    double get[N_TYPES][N_BATCH_SIZES];
+    double set[N_TYPES][N_BATCH_SIZES];
+    double getFMUState;
+    double setFMUState;
+    double doStep[N_STEP_SIZES];
+} Result;
+
+typedef struct {
+
+    FMIInstance *instance;
+    const Model *model;
+    const char *resourcePath;
+
+    // the current batch
+    VariableType type;
+    fmi3ValueReference valueReferences[MAX_BATCH_SIZE];
+    size_t nValueReferences;
+    size_t nValues;
+
+    fmi3Float64 float64Values[MAX_VALUES];
+    fmi3Int32   int32Values[MAX_VALUES];
+    fmi3UInt64  uint64Values[MAX_VALUES];
+    fmi3Boolean booleanValues[MAX_VALUES];
+    fmi3String  stringValues[MAX_VALUES];
+    fmi3Binary  binaryValues[MAX_VALUES];
+    size_t      binarySizes[MAX_VALUES];
+
+    fmi3Float64 seed[MAX_VARIABLES];
+    fmi3Float64 sensitivity[MAX_VARIABLES];
+
+    fmi3FMUState FMUState;
+
+    fmi3Float64 time;
+    fmi3Float64 stepSize;
+
+} Benchmark;
+
+typedef fmi3Status BenchmarkFunction(Benchmark *b, size_t n);
+
+#define CALL(f) status = f; if (status > fmi3Warning) goto TERMINATE;
+
+#define REPEAT(f) for (size_t i = 0; i < n && status <= fmi3Warning; i++) { status = f; }
+
+static const fmi3Byte binaryValue[] = { 0x42, 0x65, 0x6e, 0x63, 0x68 };
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+static fmi3Status instantiateAndFree(Benchmark *b, size_t n) {
+
+    fmi3Status status = fmi3OK;
+
+    for (size_t i = 0; i < n && status <= fmi3Warning; i++) {
+
+        status = FMI3InstantiateCoSimulation(b->instance, b->model->instantiationToken, b->resourcePath, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL);
+
+        if (status <= fmi3Warning) {
+            FMI3FreeInstance(b->instance);
+        }
+    }
+
+    return status;
+}
+
+static fmi3Status reset(Benchmark *b, size_t n) {
+    fmi3Status status = fmi3OK;
+    REPEAT(FMI3Reset(b->instance));
+    return status;
+}
+
+static fmi3Status getDirectionalDerivative(Benchmark *b, size_t n) {
+
+    const Model *m = b->model;
+
+    fmi3Status status = fmi3OK;
+
+    REPEAT(FMI3GetDirectionalDerivative(b->instance, m->unknowns, m->nUnknowns, m->knowns, m->nKnowns, b->seed, m->nKnowns, b->sensitivity, m->nUnknowns));
+
+    return status;
+}
+
+static fmi3Status getValues(Benchmark *b, size_t n) {
+
+    FMIInstance *S = b->instance;
+    const fmi3ValueReference *vr = b->valueReferences;
+    const size_t nvr = b->nValueReferences;
+    const size_t nValues = b->nValues;
+
+    fmi3Status status = fmi3OK;
+
+    switch (b->type) {
+        case Float64: REPEAT(FMI3GetFloat64(S, vr, nvr, b->float64Values, nValues)); break;
+        case Int32:   REPEAT(FMI3GetInt32(S, vr, nvr, b->int32Values, nValues)); break;
+        case UInt64:  REPEAT(FMI3GetUInt64(S, vr, nvr, b->uint64Values, nValues)); break;
+        case Boolean: REPEAT(FMI3GetBoolean(S, vr, nvr, b->booleanValues, nValues)); break;
+        case String:  REPEAT(FMI3GetString(S, vr, nvr, b->stringValues, nValues)); break;
+        case Binary:  REPEAT(FMI3GetBinary(S, vr, nvr, b->binarySizes, b->binaryValues, nValues)); break;
+        default:      status = fmi3Error; break;
+    }
+
+    return status;
+}
+
+static fmi3Status setValues(Benchmark *b, size_t n) {
+
+    FMIInstance *S = b->instance;
+    const fmi3ValueReference *vr = b->valueReferences;
+    const size_t nvr = b->nValueReferences;
+    const size_t nValues = b->nValues;
+
+    fmi3Status status = fmi3OK;
+
+    switch (b->type) {
+        case Float64: REPEAT(FMI3SetFloat64(S, vr, nvr, b->float64Values, nValues)); break;
+        case Int32:   REPEAT(FMI3SetInt32(S, vr, nvr, b->int32Values, nValues)); break;
+        case UInt64:  REPEAT(FMI3SetUInt64(S, vr, nvr, b->uint64Values, nValues)); break;
+        case Boolean: REPEAT(FMI3SetBoolean(S, vr, nvr, b->booleanValues, nValues)); break;
+        case String:  REPEAT(FMI3SetString(S, vr, nvr, b->stringValues, nValues)); break;
+        case Binary:  REPEAT(FMI3SetBinary(S, vr, nvr, b->binarySizes, b->binaryValues, nValues)); break;
+        default:      status = fmi3Error; break;
+    }
+
+    return status;
+}
+
+static fmi3Status getFMUState(Benchmark *b, size_t n) {
+    fmi3Status status = fmi3OK;
+    REPEAT(FMI3GetFMUState(b->instance, &b->FMUState));
+    return status;
+}
+
+static fmi3Status setFMUState(Benchmark *b, size_t n) {
+    fmi3Status status = fmi3OK;
+    REPEAT(FMI3SetFMUState(b->instance, b->FMUState));
+    return status;
+}
+
+static fmi3Status doStep(Benchmark *b, size_t n) {
+
+    fmi3Status status = fmi3OK;
+
+    fmi3Boolean eventEncountered, terminateSimulation, earlyReturn;
+    fmi3Float64 lastSuccessfulTime;
+
+    for (size_t i = 0; i < n && status <= fmi3Warning; i++) {
+        status = FMI3DoStep(b->instance, b->time, b->stepSize, fmi3True, &eventEncountered, &terminateSimulation, &earlyReturn, &lastSuccessfulTime);
+        b->time += b->stepSize;
+    }
+
+    return status;
+}
+
+// run f with 1, 2, 4... calls until it takes at least minDuration and return the time per call
+static double measure(BenchmarkFunction *f, Benchmark *b, double minDuration) {
+
+    for (size_t n = 1; ; n *= 2) {
+
+        const double start = currentTime();
+
+        const fmi3Status status = f(b, n);
+
+        const double elapsed = currentTime() - start;
+
+        if (status > fmi3Warning) {
+            return NAN;
+        }
+
+        if (elapsed >= minDuration) {
+            return elapsed * 1e9 / n;
+        }
+    }
+}
+
+// fill the batch by cycling through the variables
+static void prepareBatch(Benchmark *b, VariableType type, const Variable variables[], size_t batchSize) {
+
+    size_t nVariables = 0;
+
+    while (nVariables < MAX_VARIABLES && variables[nVariables].nElements > 0) {
+        nVariables++;
+    }
+
+    b->type = type;
+    b->nValueReferences = batchSize;
+    b->nValues = 0;
+
+    for (size_t i = 0; i < batchSize; i++) {
+        const Variable *v = &variables[i % nVariables];
+        b->valueReferences[i] = v->valueReference;
+        b->nValues += v->nElements;
+    }
+}
+
+static bool hasVariables(const Variable variables[]) {
+    return variables[0].nElements > 0;
+}
+
+static void runBenchmark(Benchmark *b, Result *result, double minDuration) {
+
+    const Model *m = b->model;
+
+    FMIInstance *S = b->instance;
+
+    fmi3Status status = fmi3OK;
+
+    result->instantiate = measure(instantiateAndFree, b, minDuration);
+
+    CALL(FMI3InstantiateCoSimulation(S, m->instantiationToken, b->resourcePath, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL));
+
+    result->reset = measure(reset, b, minDuration);
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3False, 0));
+
+    if (m->nKnowns > 0) {
+        b->seed[0] = 1;
+        result->directionalDerivative = measure(getDirectionalDerivative, b, minDuration);
+    }
+
+    CALL(FMI3ExitInitializationMode(S));
+
+    for (VariableType type = 0; type < N_TYPES; type++) {
+
+        if (hasVariables(m->get[type])) {
+            for (size_t i = 0; i < N_BATCH_SIZES; i++) {
+                prepareBatch(b, type, m->get[type], batchSizes[i]);
+                result->get[type][i] = measure(getValues, b, minDuration);
+            }
+        }
+
+        if (hasVariables(m->set[type])) {
+            for (size_t i = 0; i < N_BATCH_SIZES; i++) {
+
+                prepareBatch(b, type, m->set[type], batchSizes[i]);
+
+                if (type == String) {
+                    for (size_t j = 0; j < b->nValues; j++) {
+                        b->stringValues[j] = "Benchmark";
+                    }
+                } else if (type == Binary) {
+                    for (size_t j = 0; j < b->nValues; j++) {
+                        b->binarySizes[j]  = sizeof(binaryValue);
+                        b->binaryValues[j] = binaryValue;
+                    }
+                } else {
+                    // set the current values so the state of the model does not change
+                    CALL(getValues(b, 1));
+                }
+
+                result->set[type][i] = measure(setValues, b, minDuration);
+            }
+        }
+    }
+
+    result->getFMUState = measure(getFMUState, b, minDuration);
+    result->setFMUState = measure(setFMUState, b, minDuration);
+
+    for (size_t i = 0; i < N_STEP_SIZES; i++) {
+        b->stepSize = stepSizes[i];
+        result->doStep[i] = measure(doStep, b, minDuration);
+    }
+
+TERMINATE:
+
+    if (status > fmi3Warning) {
+        printf("Benchmark of %s failed.\n", m->modelIdentifier);
+    }
+
+    if (S->component) {
+
+        if (b->FMUState) {
+            FMI3FreeFMUState(S, &b->FMUState);
+        }
+
+        FMI3FreeInstance(S);
+    }
+}
+
+static void printNumber(FILE *file, double value) {
+    if (isnan(value)) {
+        fprintf(file, "null");
+    } else {
+        fprintf(file, "%.2f", value);
+    }
+}
+
+static void printBatches(FILE *file, const char *name, const Variable variables[N_TYPES][MAX_VARIABLES], const double results[N_TYPES][N_BATCH_SIZES], bool last) {
+
+    bool first = true;
+
+    fprintf(file, "      \"%s\": {", name);
+
+    for (VariableType type = 0; type < N_TYPES; type++) {
+
+        if (!hasVariables(variables[type])) {
+            continue;
+        }
+
+        fprintf(file, "%s\n        \"%s\": [", first ? "" : ",", typeNames[type]);
+
+        for (size_t i = 0; i < N_BATCH_SIZES; i++) {
+            fprintf(file, "%s{ \"batchSize\": %zu, \"ns\": ", i > 0 ? ", " : "", batchSizes[i]);
+            printNumber(file, results[type][i]);
+            fprintf(file, " }");
+        }
+
+        fprintf(file, "]");
+
+        first = false;
+    }
+
+    fprintf(file, "%s}%s\n", first ? "" : "\n      ", last ? "" : ",");
+}
+
+static void writeResults(FILE *file, const Result results[], double minDuration) {
+
+    bool first = true;
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"minDuration_ms\": %g,\n", minDuration * 1e3);
+    fprintf(file, "  \"models\": [");
+
+    for (size_t i = 0; i < N_MODELS; i++) {
+
+        const Model *m = &models[i];
+        const Result *r = &results[i];
+
+        if (!r->loaded) {
+            continue;
+        }
+
+        fprintf(file, "%s\n    {\n", first ? "" : ",");
+        fprintf(file, "      \"modelIdentifier\": \"%s\",\n", m->modelIdentifier);
+        fprintf(file, "      \"instantiateFree_ns\": "); printNumber(file, r->instantiate); fprintf(file, ",\n");
+        fprintf(file, "      \"reset_ns\": "); printNumber(file, r->reset); fprintf(file, ",\n");
+        fprintf(file, "      \"getDirectionalDerivative_ns\": "); printNumber(file, r->directionalDerivative); fprintf(file, ",\n");
+
+        printBatches(file, "get", m->get, r->get, false);
+        printBatches(file, "set", m->set, r->set, false);
+
+        fprintf(file, "      \"getFMUState_ns\": "); printNumber(file, r->getFMUState); fprintf(file, ",\n");
+        fprintf(file, "      \"setFMUState_ns\": "); printNumber(file, r->setFMUState); fprintf(file, ",\n");
+        fprintf(file, "      \"doStep\": [");
+
+        for (size_t j = 0; j < N_STEP_SIZES; j++) {
+            fprintf(file, "%s{ \"stepSize\": %g, \"ns\": ", j > 0 ? ", " : "", stepSizes[j]);
+            printNumber(file, r->doStep[j]);
+            fprintf(file, " }");
+        }
+
+        fprintf(file, "]\n");
+        fprintf(file, "    }");
+
+        first = false;
+    }
+
+    fprintf(file, "%s]\n", first ? "" : "\n  ");
+    fprintf(file, "}\n");
+}
+
+static void printResult(const Model *m, const Result *r) {
+
+    printf("%s\n", m->modelIdentifier);
+    printf("  %-28s %10.1f\n", "instantiate + free", r->instantiate);
+    printf("  %-28s %10.1f\n", "reset", r->reset);
+
+    if (!isnan(r->directionalDerivative)) {
+        printf("  %-28s %10.1f\n", "getDirectionalDerivative", r->directionalDerivative);
+    }
+
+    printf("  %-28s %10.1f\n", "getFMUState", r->getFMUState);
+    printf("  %-28s %10.1f\n", "setFMUState", r->setFMUState);
+
+    for (size_t i = 0; i < N_STEP_SIZES; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "doStep (h = %g)", stepSizes[i]);
+        printf("  %-28s %10.1f\n", name, r->doStep[i]);
+    }
+
+    printf("  %-28s", "batch size");
+
+    for (size_t i = 0; i < N_BATCH_SIZES; i++) {
+        printf(" %8zu", batchSizes[i]);
+    }
+
+    printf("\n");
+
+    for (VariableType type = 0; type < N_TYPES; type++) {
+        for (int set = 0; set < 2; set++) {
+
+            if (!hasVariables(set ? m->set[type] : m->get[type])) {
+                continue;
+            }
+
+            char name[64];
+            snprintf(name, sizeof(name), "%s%s", set ? "set" : "get", typeNames[type]);
+            printf("  %-28s", name);
+
+            for (size_t i = 0; i < N_BATCH_SIZES; i++) {
+                printf(" %8.1f", set ? r->set[type][i] : r->get[type][i]);
+            }
+
+            printf("\n");
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    const double minDuration = (argc > 1 ? atof(argv[1]) : 20) * 1e-3;
+    const char *outputFile   = argc > 2 ? argv[2] : "benchmarks.json";
+
+    if (minDuration <= 0) {
+        printf("Usage: benchmarks [minDuration_ms] [output.json]\n");
+        return EXIT_FAILURE;
+    }
+
+    Result results[N_MODELS];
+
+    Benchmark *b = calloc(1, sizeof(Benchmark));
+
+    if (!b) {
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < N_MODELS; i++) {
+
+        const Model *m = &models[i];
+        Result *r = &results[i];
+
+        r->loaded = false;
+        r->instantiate = r->reset = r->directionalDerivative = r->getFMUState = r->setFMUState = NAN;
+
+        for (VariableType type = 0; type < N_TYPES; type++) {
+            for (size_t j = 0; j < N_BATCH_SIZES; j++) {
+                r->get[type][j] = r->set[type][j] = NAN;
+            }
+        }
+
+        for (size_t j = 0; j < N_STEP_SIZES; j++) {
+            r->doStep[j] = NAN;
+        }
+
+        FMIInstance *S = FMICreateInstance("instance1", m->platformBinary, cb_logMessage, NULL);
+
+        if (!S) {
+            printf("Failed to load shared library %s. Skipping %s.\n", m->platformBinary, m->modelIdentifier);
+            continue;
+        }
+
+        char resourcePath[4096] = "";
+
+#ifdef _WIN32
+        const bool hasResources = _fullpath(resourcePath, m->resources, sizeof(resourcePath)) != NULL;
+#else
+        const bool hasResources = realpath(m->resources, resourcePath) != NULL && strcat(resourcePath, "/");
+#endif
+
+        memset(b, 0, sizeof(Benchmark));
+
+        b->instance     = S;
+        b->model        = m;
+        b->resourcePath = hasResources ? resourcePath : NULL;
+
+        runBenchmark(b, r, minDuration);
+
+        r->loaded = true;
+
+        FMIFreeInstance(S);
+
+        printResult(m, r);
+    }
+
+    free(b);
+
+    FILE *file = fopen(outputFile, "w");
+
+    if (!file) {
+        printf("Failed to open %s.\n", outputFile);
+        return EXIT_FAILURE;
+    }
+
+    writeResults(file, results, minDuration);
+
+    fclose(file);
+
+    printf("Results written to %s\n", outputFile);
+
+    return EXIT_SUCCESS;
+}
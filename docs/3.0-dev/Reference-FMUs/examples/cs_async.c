@@ -0,0 +1,187 @@
+/* This example steps a VanDerPol, a Dahlquist and a BouncingBall instance with different
+   communication step sizes on their own worker threads. The master waits for whichever
+   step completes first, records the outputs of that instance and dispatches its next
+   step while the other instances are still stepping. The instances may return early at
+   events, in which case the next step continues from the last successful time to the
+   communication point of the step that has returned early. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FMI3Async.h"
+#include "timer.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY(m) m "\\binaries\\x86_64-windows\\" m ".dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#endif
+
+#define N_INSTANCES 3
+
+static const char *modelIdentifiers[N_INSTANCES] = {
+    "VanDerPol",
+    "Dahlquist",
+    "BouncingBall"
+};
+
+static const char *instantiationTokens[N_INSTANCES] = {
+    "{8c4e810f-3da3-4a00-8276-176fa3c9f000}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f000}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f003}"
+};
+
+static const char *platformBinaries[N_INSTANCES] = {
+    PLATFORM_BINARY("VanDerPol"),
+    PLATFORM_BINARY("Dahlquist"),
+    PLATFORM_BINARY("BouncingBall")
+};
+
+static const fmi3Float64 stepSizes[N_INSTANCES] = { 0.01, 0.05, 0.02 };
+
+// VanDerPol.x0, Dahlquist.x, BouncingBall.h
+static const fmi3ValueReference outputs[N_INSTANCES] = { 1, 1, 1 };
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+int main(int argc, char* argv[]) {
+
+    const fmi3Float64 startTime = 0;
+    const fmi3Float64 stopTime = 10;
+
+    FMIInstance *instances[N_INSTANCES] = { NULL };
+    FMI3StepGroup *group = NULL;
+    FMI3StepWorker *workers[N_INSTANCES] = { NULL };
+    FMI3StepFuture *futures[N_INSTANCES] = { NULL };
+    size_t steps[N_INSTANCES] = { 0 };
+    size_t nEarlyReturns = 0;
+
+    // time and index of the communication point the next step of the instances ends at
+    fmi3Float64 times[N_INSTANCES];
+    size_t communicationPoints[N_INSTANCES];
+
+    FMIStatus status = FMIOK;
+
+    // the master waits for the steps of all workers
+    group = FMI3CreateStepGroup();
+
+    if (!group) {
+        printf("Failed to create the step group.\n");
+        status = FMIFatal;
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        instances[i] = FMICreateInstance(modelIdentifiers[i], platformBinaries[i], cb_logMessage, NULL);
+
+        if (!instances[i]) {
+            printf("Failed to load %s.\n", platformBinaries[i]);
+            status = FMIFatal;
+            goto TERMINATE;
+        }
+
+        CALL(FMI3InstantiateCoSimulation(instances[i], instantiationTokens[i], NULL, fmi3False, fmi3False, fmi3False, fmi3True, NULL, 0, NULL));
+        CALL(FMI3EnterInitializationMode(instances[i], fmi3False, 0, startTime, fmi3True, stopTime));
+        CALL(FMI3ExitInitializationMode(instances[i]));
+
+        workers[i] = FMI3CreateStepWorker(group, instances[i]);
+
+        if (!workers[i]) {
+            printf("Failed to create the worker for %s.\n", modelIdentifiers[i]);
+            status = FMIFatal;
+            goto TERMINATE;
+        }
+    }
+
+    const double wallClockStartTime = currentTime();
+
+    // start the first step of all instances
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+        times[i] = startTime;
+        communicationPoints[i] = 1;
+        futures[i] = FMI3DoStepAsync(workers[i], startTime, stepSizes[i], fmi3True);
+    }
+
+    printf("instance,time,value\n");
+
+    // number of instances that have not reached the stop time
+    size_t nRunning = N_INSTANCES;
+
+    while (nRunning > 0) {
+
+        size_t i;
+        fmi3Boolean terminateSimulation = fmi3False;
+        fmi3Boolean earlyReturn = fmi3False;
+        fmi3Float64 lastSuccessfulTime;
+        fmi3Float64 value;
+
+        CALL(FMI3WaitAny(futures, N_INSTANCES, &i));
+        CALL(FMI3WaitStep(futures[i], NULL, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+
+        steps[i]++;
+
+        const fmi3Float64 communicationPoint = startTime + communicationPoints[i] * stepSizes[i];
+
+        // an event at the end of the step can return early at the communication point
+        if (earlyReturn && lastSuccessfulTime < communicationPoint - 1e-9) {
+            times[i] = lastSuccessfulTime;
+            nEarlyReturns++;
+        } else {
+            times[i] = communicationPoint;
+            communicationPoints[i]++;
+        }
+
+        // record the outputs while the other instances are stepping
+        CALL(FMI3GetFloat64(instances[i], &outputs[i], 1, &value, 1));
+
+        printf("%s,%.16g,%g\n", modelIdentifiers[i], times[i], value);
+
+        const fmi3Float64 nextCommunicationPoint = startTime + communicationPoints[i] * stepSizes[i];
+
+        if (terminateSimulation || nextCommunicationPoint > stopTime + 1e-9) {
+            futures[i] = NULL;
+            nRunning--;
+        } else {
+            futures[i] = FMI3DoStepAsync(workers[i], times[i], nextCommunicationPoint - times[i], fmi3True);
+        }
+    }
+
+    printf("Simulated %zu, %zu and %zu steps (%zu early returns) in %.3f s\n", steps[0], steps[1], steps[2], nEarlyReturns, currentTime() - wallClockStartTime);
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+        printf("%s stopped at t=%g\n", modelIdentifiers[i], times[i]);
+    }
+
+TERMINATE:
+
+    FMI3WaitAll(futures, N_INSTANCES);
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        FMI3FreeStepWorker(workers[i]);
+
+        if (!instances[i]) {
+            continue;
+        }
+
+        if (instances[i]->component) {
+            if (status < FMIError) {
+                FMI3Terminate(instances[i]);
+            }
+            FMI3FreeInstance(instances[i]);
+        }
+
+        FMIFreeInstance(instances[i]);
+    }
+
+    FMI3FreeStepGroup(group);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+/* This example couples a Feedthrough and a LinearTransform instance in an algebraic loop
+   that is driven by a VanDerPol instance and steps them together with an independent
+   BouncingBall instance with the Gauss-Seidel scheme of FMI3Master */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FMI3Master.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY(m) m "\\binaries\\x86_64-windows\\" m ".dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#endif
+
+#define MODEL_DESCRIPTION(m) m "/modelDescription.xml"
+
+#define N_INSTANCES 4
+
+enum {
+    VanDerPol,
+    Feedthrough,
+    LinearTransform,
+    BouncingBall
+};
+
+static const char *modelIdentifiers[N_INSTANCES] = {
+    "VanDerPol",
+    "Feedthrough",
+    "LinearTransform",
+    "BouncingBall"
+};
+
+static const char *instantiationTokens[N_INSTANCES] = {
+    "{8c4e810f-3da3-4a00-8276-176fa3c9f000}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f004}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f000}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f003}"
+};
+
+static const char *platformBinaries[N_INSTANCES] = {
+    PLATFORM_BINARY("VanDerPol"),
+    PLATFORM_BINARY("Feedthrough"),
+    PLATFORM_BINARY("LinearTransform"),
+    PLATFORM_BINARY("BouncingBall")
+};
+
+#define vr_VanDerPol_x0 1
+#define vr_Feedthrough_real_tunable_param 2
+#define vr_Feedthrough_continuous_real_in 3
+#define vr_Feedthrough_continuous_real_out 4
+#define vr_LinearTransform_m 1
+#define vr_LinearTransform_n 2
+#define vr_LinearTransform_u 3
+#define vr_LinearTransform_A 4
+#define vr_LinearTransform_y 5
+
+// gain of the LinearTransform
+#define A 0.5
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+// reduce LinearTransform to a scalar gain
+static FMIStatus configureLinearTransform(FMIInstance *S) {
+
+    FMIStatus status = FMIOK;
+
+    const fmi3ValueReference vr_mn[2] = { vr_LinearTransform_m, vr_LinearTransform_n };
+    const fmi3UInt64 mn[2] = { 1, 1 };
+    const fmi3ValueReference vr_A = vr_LinearTransform_A;
+    const fmi3Float64 a = A;
+
+    CALL(FMI3EnterConfigurationMode(S));
+    CALL(FMI3SetUInt64(S, vr_mn, 2, mn, 2));
+    CALL(FMI3ExitConfigurationMode(S));
+    CALL(FMI3SetFloat64(S, &vr_A, 1, &a, 1));
+
+TERMINATE:
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+
+    const size_t nThreads = argc > 1 ? strtoul(argv[1], NULL, 10) : 0;
+
+    const fmi3Float64 startTime = 0;
+    const fmi3Float64 stopTime = 10;
+    const fmi3Float64 h = 0.1;
+
+    const FMI3Connection connections[] = {
+        // VanDerPol.x0 -> Feedthrough.real_tunable_param
+        { VanDerPol, vr_VanDerPol_x0, Feedthrough, vr_Feedthrough_real_tunable_param, FMIFloat64Type },
+        // Feedthrough.continuous_real_out -> LinearTransform.u
+        { Feedthrough, vr_Feedthrough_continuous_real_out, LinearTransform, vr_LinearTransform_u, FMIFloat64Type },
+        // LinearTransform.y -> Feedthrough.continuous_real_in
+        { LinearTransform, vr_LinearTransform_y, Feedthrough, vr_Feedthrough_continuous_real_in, FMIFloat64Type }
+    };
+
+    const size_t nConnections = sizeof(connections) / sizeof(FMI3Connection);
+
+    const FMIValueReference linearTransformInputs[] = { vr_LinearTransform_u };
+
+    FMIInstance *instances[N_INSTANCES] = { NULL };
+
+    FMI3Master *master = NULL;
+
+    FMIStatus status = FMIOK;
+    fmi3Boolean terminateSimulation = fmi3False;
+    fmi3Float64 time = startTime;
+    size_t nSteps = 0;
+    fmi3Float64 maxError = 0;
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        instances[i] = FMICreateInstance(modelIdentifiers[i], platformBinaries[i], cb_logMessage, NULL);
+
+        if (!instances[i]) {
+            printf("Failed to load %s.\n", platformBinaries[i]);
+            status = FMIFatal;
+            goto TERMINATE;
+        }
+
+        CALL(FMI3InstantiateCoSimulation(instances[i], instantiationTokens[i], NULL, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL));
+
+        if (i == LinearTransform) {
+            CALL(configureLinearTransform(instances[i]));
+        }
+
+        CALL(FMI3EnterInitializationMode(instances[i], fmi3False, 0, startTime, fmi3True, stopTime));
+        CALL(FMI3ExitInitializationMode(instances[i]));
+    }
+
+    master = FMI3CreateMaster(instances, N_INSTANCES, connections, nConnections, nThreads);
+
+    if (!master) {
+        printf("Failed to create the master.\n");
+        status = FMIFatal;
+        goto TERMINATE;
+    }
+
+    CALL(FMI3MasterSetCouplingScheme(master, FMI3GaussSeidelCoupling));
+    // Feedthrough does not implement fmi3GetVariableDependencies(), so the master reads the dependencies from the model description
+    CALL(FMI3MasterSetModelDescription(master, Feedthrough, MODEL_DESCRIPTION("Feedthrough")));
+    CALL(FMI3MasterSetDependencies(master, LinearTransform, vr_LinearTransform_y, linearTransformInputs, 1));
+    CALL(FMI3MasterSetLoopSolverParameters(master, 1e-10, 10));
+
+    while (time < stopTime && !terminateSimulation) {
+
+        CALL(FMI3MasterDoStep(master, time, h, &terminateSimulation));
+
+        nSteps++;
+        time = startTime + nSteps * h;
+
+        const fmi3ValueReference vr_x0 = vr_VanDerPol_x0;
+        const fmi3ValueReference vr_in = vr_Feedthrough_continuous_real_in;
+        fmi3Float64 b, y;
+
+        CALL(FMI3GetFloat64(instances[VanDerPol], &vr_x0, 1, &b, 1));
+        CALL(FMI3GetFloat64(instances[Feedthrough], &vr_in, 1, &y, 1));
+
+        // the solution of the loop y = A * (y + b)
+        const fmi3Float64 error = fabs(y - A * b / (1 - A));
+
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+
+    printf("Simulated %zu steps, maximum error of the algebraic loop = %g\n", nSteps, maxError);
+
+TERMINATE:
+
+    FMI3FreeMaster(master);
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        if (!instances[i]) {
+            continue;
+        }
+
+        if (instances[i]->component) {
+            if (status < FMIError) {
+                FMI3Terminate(instances[i]);
+            }
+            FMI3FreeInstance(instances[i]);
+        }
+
+        FMIFreeInstance(instances[i]);
+    }
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
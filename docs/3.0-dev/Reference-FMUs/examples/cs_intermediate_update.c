@@ -6,6 +6,9 @@
 #include "util.h"
 
 
+// number of calls to intermediateUpdate()
+static size_t nIntermediateUpdates = 0;
+
 // tag::IntermediateUpdateCallback[]
 void intermediateUpdate(fmi3InstanceEnvironment instanceEnvironment,
                            fmi3Float64 intermediateUpdateTime,
@@ -23,6 +26,8 @@ void intermediateUpdate(fmi3InstanceEnvironment instanceEnvironment,
 
     FMIInstance *S = (FMIInstance *)instanceEnvironment;
 
+    nIntermediateUpdates++;
+
     S->time = intermediateUpdateTime;
 
     *earlyReturnRequested = fmi3False;
@@ -84,6 +89,16 @@ void intermediateUpdate(fmi3InstanceEnvironment instanceEnvironment,
 
 int main(int argc, char* argv[]) {
 
+    // the variables that are recorded in intermediateUpdate()
+    const fmi3ValueReference requiredIntermediateVariables[] = { vr_h, vr_v };
+
+    // pass 0 to require no intermediate variables, so the FMU calls intermediateUpdate() only at events
+    size_t nRequiredIntermediateVariables = argc > 1 ? strtoul(argv[1], NULL, 10) : 2;
+
+    if (nRequiredIntermediateVariables > 2) {
+        nRequiredIntermediateVariables = 2;
+    }
+
     CALL(setUp());
 
     // Instantiate the FMU
@@ -94,8 +109,8 @@ int main(int argc, char* argv[]) {
         fmi3False,           // loggingOn
         fmi3False,           // eventModeUsed
         fmi3False,           // earlyReturnAllowed
-        NULL,                // requiredIntermediateVariables
-        0,                   // nRequiredIntermediateVariables
+        requiredIntermediateVariables, // requiredIntermediateVariables
+        nRequiredIntermediateVariables, // nRequiredIntermediateVariables
         intermediateUpdate   // intermediateUpdate
     ));
 
@@ -128,6 +143,8 @@ int main(int argc, char* argv[]) {
         time += stepSize;
     };
 
+    printf("%zu intermediate updates with %zu required intermediate variables\n", nIntermediateUpdates, nRequiredIntermediateVariables);
+
     fmi3Status terminateStatus;
 
 TERMINATE:
@@ -0,0 +1,194 @@
+/* This example couples several VanDerPol, Feedthrough and BouncingBall instances
+   with a Jacobi scheme and steps them in parallel with FMI3Master. The Get and Set
+   calls of the first group are counted to show that the two connections of a group
+   are transferred with one batched call per instance and type. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3Master.h"
+#include "timer.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY(m) m "\\binaries\\x86_64-windows\\" m ".dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#endif
+
+#define N_MODELS 3
+
+static const char *modelIdentifiers[N_MODELS] = {
+    "VanDerPol",
+    "Feedthrough",
+    "BouncingBall"
+};
+
+static const char *instantiationTokens[N_MODELS] = {
+    "{8c4e810f-3da3-4a00-8276-176fa3c9f000}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f004}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f003}"
+};
+
+static const char *platformBinaries[N_MODELS] = {
+    PLATFORM_BINARY("VanDerPol"),
+    PLATFORM_BINARY("Feedthrough"),
+    PLATFORM_BINARY("BouncingBall")
+};
+
+#define vr_VanDerPol_x0 1
+#define vr_VanDerPol_x1 3
+#define vr_Feedthrough_real_tunable_param 2
+#define vr_Feedthrough_continuous_real_in 3
+#define vr_Feedthrough_continuous_real_out 4
+
+// Get calls of VanDerPol0 and Set calls of Feedthrough0 (each made by one thread at a time)
+static size_t nGetCalls = 0;
+static size_t nSetCalls = 0;
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+static void cb_logFunctionCall(FMIInstance *instance, FMIStatus status, const char *message, ...) {
+    if (strncmp(message, "fmi3Get", 7) == 0) {
+        nGetCalls++;
+    } else if (strncmp(message, "fmi3Set", 7) == 0) {
+        nSetCalls++;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    const size_t nGroups  = argc > 1 ? strtoul(argv[1], NULL, 10) : 16;
+    const size_t nThreads = argc > 2 ? strtoul(argv[2], NULL, 10) : 0;
+
+    const fmi3Float64 startTime = 0;
+    const fmi3Float64 stopTime = 10;
+    const fmi3Float64 h = 1e-2;
+
+    const size_t nInstances   = N_MODELS * nGroups;
+    const size_t nConnections = 2 * nGroups;
+
+    FMIInstance **instances = calloc(nInstances, sizeof(FMIInstance *));
+    FMI3Connection *connections = calloc(nConnections, sizeof(FMI3Connection));
+
+    FMI3Master *master = NULL;
+
+    FMIStatus status = FMIOK;
+    fmi3Boolean terminateSimulation = fmi3False;
+    fmi3Float64 time = startTime;
+    char instanceName[64];
+    double start;
+
+    if (!instances || !connections || nGroups == 0) {
+        printf("Usage: cs_jacobi [nGroups] [nThreads]\n");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < nInstances; i++) {
+
+        const size_t model = i % N_MODELS;
+
+        snprintf(instanceName, sizeof(instanceName), "%s%zu", modelIdentifiers[model], i / N_MODELS);
+
+        // count the calls of the first group
+        instances[i] = FMICreateInstance(instanceName, platformBinaries[model], cb_logMessage, i < N_MODELS ? cb_logFunctionCall : NULL);
+
+        if (!instances[i]) {
+            printf("Failed to load %s.\n", platformBinaries[model]);
+            status = FMIFatal;
+            goto TERMINATE;
+        }
+
+        status = FMI3InstantiateCoSimulation(instances[i], instantiationTokens[model], NULL, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL);
+        if (status > FMIWarning) goto TERMINATE;
+
+        status = FMI3EnterInitializationMode(instances[i], fmi3False, 0, startTime, fmi3True, stopTime);
+        if (status > FMIWarning) goto TERMINATE;
+
+        status = FMI3ExitInitializationMode(instances[i]);
+        if (status > FMIWarning) goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < nGroups; i++) {
+
+        // VanDerPol.x0 -> Feedthrough.continuous_real_in
+        connections[2 * i].sourceInstance           = N_MODELS * i;
+        connections[2 * i].sourceValueReference     = vr_VanDerPol_x0;
+        connections[2 * i].targetInstance           = N_MODELS * i + 1;
+        connections[2 * i].targetValueReference     = vr_Feedthrough_continuous_real_in;
+        connections[2 * i].type                     = FMIFloat64Type;
+
+        // VanDerPol.x1 -> Feedthrough.real_tunable_param
+        connections[2 * i + 1].sourceInstance       = N_MODELS * i;
+        connections[2 * i + 1].sourceValueReference = vr_VanDerPol_x1;
+        connections[2 * i + 1].targetInstance       = N_MODELS * i + 1;
+        connections[2 * i + 1].targetValueReference = vr_Feedthrough_real_tunable_param;
+        connections[2 * i + 1].type                 = FMIFloat64Type;
+    }
+
+    master = FMI3CreateMaster(instances, nInstances, connections, nConnections, nThreads);
+
+    if (!master) {
+        printf("Failed to create the master.\n");
+        status = FMIFatal;
+        goto TERMINATE;
+    }
+
+    nGetCalls = 0;
+    nSetCalls = 0;
+
+    start = currentTime();
+
+    size_t nSteps = 0;
+
+    while (time < stopTime && !terminateSimulation) {
+
+        status = FMI3MasterDoStep(master, time, h, &terminateSimulation);
+
+        if (status > FMIWarning) goto TERMINATE;
+
+        nSteps++;
+        time = startTime + nSteps * h;
+    }
+
+    const double elapsed = currentTime() - start;
+
+    printf("%s: %zu Get calls, %s: %zu Set calls\n", instances[0]->name, nGetCalls, instances[1]->name, nSetCalls);
+
+    const fmi3ValueReference vr_out = vr_Feedthrough_continuous_real_out;
+    fmi3Float64 y;
+
+    status = FMI3GetFloat64(instances[1], &vr_out, 1, &y, 1);
+
+    printf("Simulated %zu instances for %zu steps in %g s (%g steps/s), %s.continuous_real_out = %g\n",
+        nInstances, nSteps, elapsed, nSteps / elapsed, instances[1]->name, y);
+
+TERMINATE:
+
+    FMI3FreeMaster(master);
+
+    for (size_t i = 0; i < nInstances; i++) {
+
+        if (!instances[i]) {
+            continue;
+        }
+
+        if (instances[i]->component) {
+            if (status < FMIError) {
+                FMI3Terminate(instances[i]);
+            }
+            FMI3FreeInstance(instances[i]);
+        }
+
+        FMIFreeInstance(instances[i]);
+    }
+
+    free(instances);
+    free(connections);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/* This example steps a VanDerPol, a Feedthrough and a LinearTransform instance with the
+   error-controlled communication step of FMI3Master. VanDerPol drives the Feedthrough,
+   whose output is fed back through the LinearTransform, so the outputs at the end of a
+   step depend on the inputs that are held during the step. The step size is reduced
+   during the fast transitions of the relaxation oscillation and increased in the quiet
+   phases. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3Master.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY(m) m "\\binaries\\x86_64-windows\\" m ".dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#endif
+
+#define N_INSTANCES 3
+
+enum {
+    VanDerPol,
+    Feedthrough,
+    LinearTransform
+};
+
+static const char *modelIdentifiers[N_INSTANCES] = {
+    "VanDerPol",
+    "Feedthrough",
+    "LinearTransform"
+};
+
+static const char *instantiationTokens[N_INSTANCES] = {
+    "{8c4e810f-3da3-4a00-8276-176fa3c9f000}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f004}",
+    "{8c4e810f-3df3-4a00-8276-176fa3c9f000}"
+};
+
+static const char *platformBinaries[N_INSTANCES] = {
+    PLATFORM_BINARY("VanDerPol"),
+    PLATFORM_BINARY("Feedthrough"),
+    PLATFORM_BINARY("LinearTransform")
+};
+
+#define vr_VanDerPol_x0 1
+#define vr_VanDerPol_mu 5
+#define vr_Feedthrough_real_tunable_param 2
+#define vr_Feedthrough_continuous_real_in 3
+#define vr_Feedthrough_continuous_real_out 4
+#define vr_LinearTransform_m 1
+#define vr_LinearTransform_n 2
+#define vr_LinearTransform_u 3
+#define vr_LinearTransform_A 4
+#define vr_LinearTransform_y 5
+
+// gain of the feedback
+#define A 0.5
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+// reduce LinearTransform to a scalar gain
+static FMIStatus configureLinearTransform(FMIInstance *S) {
+
+    FMIStatus status = FMIOK;
+
+    const fmi3ValueReference vr_mn[2] = { vr_LinearTransform_m, vr_LinearTransform_n };
+    const fmi3UInt64 mn[2] = { 1, 1 };
+    const fmi3ValueReference vr_A = vr_LinearTransform_A;
+    const fmi3Float64 a = A;
+
+    CALL(FMI3EnterConfigurationMode(S));
+    CALL(FMI3SetUInt64(S, vr_mn, 2, mn, 2));
+    CALL(FMI3ExitConfigurationMode(S));
+    CALL(FMI3SetFloat64(S, &vr_A, 1, &a, 1));
+
+TERMINATE:
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+
+    const fmi3Float64 tolerance = argc > 1 ? strtod(argv[1], NULL) : 1e-2;
+    const FMI3ErrorEstimator errorEstimator = argc > 2 && strcmp(argv[2], "step-doubling") == 0 ?
+        FMI3StepDoublingErrorEstimator : FMI3ExtrapolationErrorEstimator;
+
+    const fmi3Float64 startTime = 0;
+    const fmi3Float64 stopTime = 20;
+    const fmi3Float64 minStepSize = 2e-2;
+    const fmi3Float64 maxStepSize = 1;
+    const fmi3Float64 mu = 5;
+
+    const FMI3Connection connections[] = {
+        // VanDerPol.x0 -> Feedthrough.continuous_real_in
+        { VanDerPol, vr_VanDerPol_x0, Feedthrough, vr_Feedthrough_continuous_real_in, FMIFloat64Type },
+        // Feedthrough.continuous_real_out -> LinearTransform.u
+        { Feedthrough, vr_Feedthrough_continuous_real_out, LinearTransform, vr_LinearTransform_u, FMIFloat64Type },
+        // LinearTransform.y -> Feedthrough.real_tunable_param
+        { LinearTransform, vr_LinearTransform_y, Feedthrough, vr_Feedthrough_real_tunable_param, FMIFloat64Type }
+    };
+
+    const size_t nConnections = sizeof(connections) / sizeof(FMI3Connection);
+
+    const fmi3ValueReference vr_mu = vr_VanDerPol_mu;
+    const fmi3ValueReference vr_out = vr_Feedthrough_continuous_real_out;
+
+    FMIInstance *instances[N_INSTANCES] = { NULL };
+
+    FMI3Master *master = NULL;
+
+    FMIStatus status = FMIOK;
+    fmi3Boolean terminateSimulation = fmi3False;
+    fmi3Float64 time = startTime;
+    fmi3Float64 h = minStepSize;
+    fmi3Float64 hTaken, hNext, y;
+    fmi3Float64 hMin = maxStepSize, hMax = 0;
+    size_t nSteps = 0;
+
+    if (tolerance <= 0) {
+        printf("Usage: cs_variable_step [tolerance] [extrapolation|step-doubling]\n");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        instances[i] = FMICreateInstance(modelIdentifiers[i], platformBinaries[i], cb_logMessage, NULL);
+
+        if (!instances[i]) {
+            printf("Failed to load %s.\n", platformBinaries[i]);
+            status = FMIFatal;
+            goto TERMINATE;
+        }
+
+        CALL(FMI3InstantiateCoSimulation(instances[i], instantiationTokens[i], NULL, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL));
+
+        if (i == VanDerPol) {
+            CALL(FMI3SetFloat64(instances[i], &vr_mu, 1, &mu, 1));
+        }
+
+        if (i == LinearTransform) {
+            CALL(configureLinearTransform(instances[i]));
+        }
+
+        CALL(FMI3EnterInitializationMode(instances[i], fmi3False, 0, startTime, fmi3True, stopTime));
+        CALL(FMI3ExitInitializationMode(instances[i]));
+    }
+
+    master = FMI3CreateMaster(instances, N_INSTANCES, connections, nConnections, 1);
+
+    if (!master) {
+        printf("Failed to create the master.\n");
+        status = FMIFatal;
+        goto TERMINATE;
+    }
+
+    CALL(FMI3MasterSetStepSizeControl(master, errorEstimator, tolerance, tolerance, minStepSize, maxStepSize));
+
+    printf("time,h,continuous_real_out\n");
+
+    while (time < stopTime && !terminateSimulation) {
+
+        // don't step past the stop time
+        if (time + h > stopTime) {
+            h = stopTime - time;
+        }
+
+        CALL(FMI3MasterDoVariableStep(master, time, h, &hTaken, &hNext, &terminateSimulation));
+        CALL(FMI3GetFloat64(instances[Feedthrough], &vr_out, 1, &y, 1));
+
+        time += hTaken;
+        h = hNext;
+        nSteps++;
+
+        if (time < stopTime) {
+            if (hTaken < hMin) hMin = hTaken;
+            if (hTaken > hMax) hMax = hTaken;
+        }
+
+        printf("%g,%g,%g\n", time, hTaken, y);
+    }
+
+    printf("Simulated to %g s in %zu steps (min. step size = %g, max. step size = %g)\n", time, nSteps, hMin, hMax);
+
+TERMINATE:
+
+    FMI3FreeMaster(master);
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        if (!instances[i]) {
+            continue;
+        }
+
+        if (instances[i]->component) {
+            if (status < FMIError) {
+                FMI3Terminate(instances[i]);
+            }
+            FMI3FreeInstance(instances[i]);
+        }
+
+        FMIFreeInstance(instances[i]);
+    }
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,185 @@
+/* This example compares the throughput of nInstances copies of a model that are
+   stepped one after the other (each with its own ModelInstance) to a structure-of-arrays
+   ensemble that evaluates the model equations for all instances in one loop.
+   The first instance keeps the start value of the parameter and its trajectory in the
+   ensemble is written to ensemble_<model>_out.csv to be validated against the reference
+   result of the FMU. Build with CMAKE_BUILD_TYPE=Release to get meaningful numbers. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "cosimulation.h"
+#include "ensemble.h"
+#include "timer.h"
+
+#define xstr(s) str(s)
+#define str(s) #s
+
+#define OUTPUT_FILE "ensemble_" xstr(MODEL_IDENTIFIER) "_out.csv"
+
+int main(int argc, char* argv[]) {
+
+    const size_t nInstances = argc > 1 ? strtoul(argv[1], NULL, 10) : 10000;
+    const int nSteps = (int)(DEFAULT_STOP_TIME / FIXED_SOLVER_STEP);
+
+    ModelInstance **instances = calloc(nInstances, sizeof(ModelInstance *));
+    double *parameters = calloc(nInstances, sizeof(double));
+    double *x = calloc(NX * nInstances, sizeof(double));
+    double *x_ensemble = calloc(NX * nInstances, sizeof(double));
+
+    // trajectory of the first instance in the ensemble
+    double *trajectory = calloc((size_t)(nSteps + 1) * (NX + 1), sizeof(double));
+
+    const ValueReference states[NX] = ENSEMBLE_STATES;
+    const char *stateNames[NX] = ENSEMBLE_STATE_NAMES;
+
+    Ensemble *ensemble = NULL;
+    FILE *file = NULL;
+
+    int status = EXIT_SUCCESS;
+
+    if (nInstances == 0 || !instances || !parameters || !x || !x_ensemble || !trajectory) {
+        printf("Usage: ensemble_%s [nInstances]\n", xstr(MODEL_IDENTIFIER));
+        status = EXIT_FAILURE;
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < nInstances; i++) {
+
+        instances[i] = createModelInstance(NULL, NULL, NULL, "instance", INSTANTIATION_TOKEN, NULL, false, CoSimulation);
+
+        if (!instances[i]) {
+            printf("Failed to create the instances.\n");
+            status = EXIT_FAILURE;
+            goto TERMINATE;
+        }
+    }
+
+    double startValue;
+    size_t index = 0;
+    getFloat64(instances[0], ENSEMBLE_PARAMETER, &startValue, &index);
+
+    // a different parameter for every instance except the first one
+    for (size_t i = 0; i < nInstances; i++) {
+        parameters[i] = startValue * (1 + (double)i / nInstances);
+        index = 0;
+        setFloat64(instances[i], ENSEMBLE_PARAMETER, &parameters[i], &index);
+    }
+
+    ensemble = createEnsemble(nInstances);
+
+    if (!ensemble) {
+        printf("Failed to create the ensemble.\n");
+        status = EXIT_FAILURE;
+        goto TERMINATE;
+    }
+
+    ensembleSetFloat64(ensemble, ENSEMBLE_PARAMETER, parameters);
+
+    double start = currentTime();
+
+    for (int step = 0; step < nSteps; step++) {
+        for (size_t i = 0; i < nInstances; i++) {
+            bool stateEvent, timeEvent;
+            doFixedStep(instances[i], &stateEvent, &timeEvent);
+        }
+    }
+
+    const double scalarTime = currentTime() - start;
+
+    start = currentTime();
+
+    for (int step = 0; step <= nSteps; step++) {
+
+        if (step > 0) {
+            ensembleDoFixedStep(ensemble);
+        }
+
+        double *row = &trajectory[(size_t)step * (NX + 1)];
+
+        row[0] = ensemble->time;
+
+        for (size_t j = 0; j < NX; j++) {
+            row[j + 1] = E(states[j])[0];
+        }
+    }
+
+    const double ensembleTime = currentTime() - start;
+
+    file = fopen(OUTPUT_FILE, "w");
+
+    if (!file) {
+        printf("Failed to open %s.\n", OUTPUT_FILE);
+        status = EXIT_FAILURE;
+        goto TERMINATE;
+    }
+
+    fputs("time", file);
+
+    for (size_t j = 0; j < NX; j++) {
+        fprintf(file, ",%s", stateNames[j]);
+    }
+
+    fputs("\n", file);
+
+    for (int step = 0; step <= nSteps; step++) {
+
+        const double *row = &trajectory[(size_t)step * (NX + 1)];
+
+        fprintf(file, "%.16g", row[0]);
+
+        for (size_t j = 0; j < NX; j++) {
+            fprintf(file, ",%.16g", row[j + 1]);
+        }
+
+        fputs("\n", file);
+    }
+
+    // the results must be the same
+    for (size_t i = 0; i < nInstances; i++) {
+        double xi[NX];
+        getContinuousStates(instances[i], xi, NX);
+        for (size_t j = 0; j < NX; j++) {
+            x[j * nInstances + i] = xi[j];
+        }
+    }
+
+    ensembleGetContinuousStates(ensemble, x_ensemble);
+
+    double maxError = 0;
+
+    for (size_t i = 0; i < NX * nInstances; i++) {
+        maxError = fmax(maxError, fabs(x[i] - x_ensemble[i]));
+    }
+
+    const double nInstanceSteps = (double)nInstances * nSteps;
+
+    printf("%s: %zu instances, %d steps, max. difference = %g\n", xstr(MODEL_IDENTIFIER), nInstances, nSteps, maxError);
+    printf("%-10s %12s %16s\n", "", "time [s]", "steps/s");
+    printf("%-10s %12.4f %16.4g\n", "instances", scalarTime, nInstanceSteps / scalarTime);
+    printf("%-10s %12.4f %16.4g\n", "ensemble", ensembleTime, nInstanceSteps / ensembleTime);
+    printf("speedup: %.2f\n", scalarTime / ensembleTime);
+
+TERMINATE:
+
+    if (file) {
+        fclose(file);
+    }
+
+    for (size_t i = 0; instances && i < nInstances; i++) {
+        if (instances[i]) {
+            freeModelInstance(instances[i]);
+        }
+    }
+
+    freeEnsemble(ensemble);
+    free(instances);
+    free(parameters);
+    free(x);
+    free(x_ensemble);
+    free(trajectory);
+
+    return status;
+}
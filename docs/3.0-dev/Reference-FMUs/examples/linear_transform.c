@@ -0,0 +1,124 @@
+/* This example resizes LinearTransform in Configuration Mode and Reconfiguration Mode,
+   sets A and u to pseudo-random values and compares y = A * u with a scalar reference.
+   The dimensions are chosen so that the blocks of the columns, the four-row passes and
+   the SIMD lanes all have remainders. */
+
+#define LOG_FILE "linear_transform_log.txt"
+
+#include "util.h"
+
+
+// dimensions m x n to test
+static const fmi3UInt64 dimensions[][2] = {
+    { 37, 2500 },
+    { 5, 3 },
+    { 1, 1 },
+    { 64, 1031 }
+};
+
+#define N_DIMENSIONS (sizeof(dimensions) / sizeof(dimensions[0]))
+
+// pseudo-random multiples of 2^-14 in [-1, 1), so the products and their sums are exact
+// in double precision and y does not depend on the order of the summation
+static double nextValue(unsigned long *seed) {
+    *seed = *seed * 1103515245UL + 12345UL;
+    return (double)((*seed >> 16) & 0x7FFF) / 16384.0 - 1.0;
+}
+
+// difference of y and the scalar reference A * u
+static double maxDifference(size_t m, size_t n, const double *A, const double *u, const double *y) {
+
+    double difference = 0;
+
+    for (size_t i = 0; i < m; i++) {
+
+        double yRef = 0;
+
+        for (size_t j = 0; j < n; j++) {
+            yRef += A[i * n + j] * u[j];
+        }
+
+        const double d = fabs(y[i] - yRef);
+
+        difference = d > difference ? d : difference;
+    }
+
+    return difference;
+}
+
+int main(int argc, char* argv[]) {
+
+    const fmi3ValueReference vr_mn[2] = { vr_m, vr_n };
+    const fmi3ValueReference vr_uA[2] = { vr_u, vr_A };
+    const fmi3ValueReference vr_output = vr_y;
+
+    unsigned long seed = 1;
+    double difference = 0;
+    double *values = NULL;
+    double *y = NULL;
+
+    CALL(setUp());
+
+    CALL(FMI3InstantiateCoSimulation(S,
+        INSTANTIATION_TOKEN, // instantiationToken
+        resourcePath(),      // resourcePath
+        fmi3False,           // visible
+        fmi3False,           // loggingOn
+        fmi3False,           // eventModeUsed
+        fmi3False,           // earlyReturnAllowed
+        NULL,                // requiredIntermediateVariables
+        0,                   // nRequiredIntermediateVariables
+        NULL                 // intermediateUpdate
+    ));
+
+    for (size_t k = 0; k < N_DIMENSIONS; k++) {
+
+        const size_t m = (size_t)dimensions[k][0];
+        const size_t n = (size_t)dimensions[k][1];
+
+        // the first resize happens in Configuration Mode, the others in Reconfiguration Mode
+        CALL(FMI3EnterConfigurationMode(S));
+        CALL(FMI3SetUInt64(S, vr_mn, 2, dimensions[k], 2));
+        CALL(FMI3ExitConfigurationMode(S));
+
+        if (k == 0) {
+            CALL(FMI3EnterInitializationMode(S, fmi3False, 0.0, startTime, fmi3False, 0.0));
+            CALL(FMI3ExitInitializationMode(S));
+        }
+
+        // u followed by A
+        free(values);
+        free(y);
+
+        values = calloc(n + m * n, sizeof(double));
+        y = calloc(m, sizeof(double));
+
+        if (!values || !y) {
+            printf("Failed to allocate memory.\n");
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        for (size_t i = 0; i < n + m * n; i++) {
+            values[i] = nextValue(&seed);
+        }
+
+        CALL(FMI3SetFloat64(S, vr_uA, 2, values, n + m * n));
+        CALL(FMI3GetFloat64(S, &vr_output, 1, y, m));
+
+        const double d = maxDifference(m, n, &values[n], values, y);
+
+        printf("m = %zu, n = %zu: max. difference = %g\n", m, n, d);
+
+        difference = d > difference ? d : difference;
+    }
+
+    printf("max. difference of y = A * u: %g\n", difference);
+
+TERMINATE:
+
+    free(values);
+    free(y);
+
+    return tearDown();
+}
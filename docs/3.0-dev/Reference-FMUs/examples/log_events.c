@@ -0,0 +1,97 @@
+/* This example simulates the BouncingBall with logging switched on and counts the log
+   messages of the events that are passed to the importer during the simulation and
+   by fmi3FreeInstance(). If the FMU has been built with DEFERRED_LOGGING the events
+   are formatted and passed to the importer only when the log is flushed, i.e. when the
+   instance is freed. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY "BouncingBall\\binaries\\x86_64-windows\\BouncingBall.dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY "BouncingBall/binaries/x86_64-darwin/BouncingBall.dylib"
+#else
+#define PLATFORM_BINARY "BouncingBall/binaries/x86_64-linux/BouncingBall.so"
+#endif
+
+#define INSTANTIATION_TOKEN "{8c4e810f-3df3-4a00-8276-176fa3c9f003}"
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+static size_t nEventMessages = 0;
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+
+    if (strcmp(category, "logEvents") == 0) {
+        nEventMessages++;
+    }
+
+    printf("[%s] %s\n", category, message);
+}
+
+int main(int argc, char* argv[]) {
+
+    const fmi3Float64 startTime = 0;
+    const fmi3Float64 stopTime = 3;
+    const fmi3Float64 stepSize = 1e-2;
+
+    fmi3Boolean eventEncountered    = fmi3False;
+    fmi3Boolean terminateSimulation = fmi3False;
+    fmi3Boolean earlyReturn         = fmi3False;
+    fmi3Float64 lastSuccessfulTime  = startTime;
+
+    size_t nSimulationMessages = 0;
+
+    FMIStatus status = FMIOK;
+
+    FMIInstance *S = FMICreateInstance("instance1", PLATFORM_BINARY, cb_logMessage, NULL);
+
+    if (!S) {
+        printf("Failed to load %s.\n", PLATFORM_BINARY);
+        return EXIT_FAILURE;
+    }
+
+    CALL(FMI3InstantiateCoSimulation(S,
+        INSTANTIATION_TOKEN, // instantiationToken
+        NULL,                // resourcePath
+        fmi3False,           // visible
+        fmi3True,            // loggingOn
+        fmi3False,           // eventModeUsed
+        fmi3False,           // earlyReturnAllowed
+        NULL,                // requiredIntermediateVariables
+        0,                   // nRequiredIntermediateVariables
+        NULL                 // intermediateUpdate
+    ));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0.0, startTime, fmi3True, stopTime));
+    CALL(FMI3ExitInitializationMode(S));
+
+    for (size_t step = 0; startTime + step * stepSize < stopTime; step++) {
+        CALL(FMI3DoStep(S, startTime + step * stepSize, stepSize, fmi3True, &eventEncountered, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+    }
+
+    CALL(FMI3Terminate(S));
+
+    nSimulationMessages = nEventMessages;
+
+TERMINATE:
+
+    if (S->component) {
+        FMI3FreeInstance(S);
+    }
+
+    FMIFreeInstance(S);
+
+    if (status > FMIWarning) {
+        return EXIT_FAILURE;
+    }
+
+    printf("Event messages during the simulation: %zu\n", nSimulationMessages);
+    printf("Event messages from fmi3FreeInstance: %zu\n", nEventMessages - nSimulationMessages);
+
+    return nEventMessages > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
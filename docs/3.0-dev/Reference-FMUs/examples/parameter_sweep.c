@@ -0,0 +1,399 @@
+/* This example runs a parameter sweep over one of the Reference FMUs with FMI3RunSweep.
+   The parameter sets are read from a CSV file whose header contains the names of the
+   parameters, e.g.
+
+   g,e
+   -9.81,0.5
+   -9.81,0.6
+
+   and the final values of the outputs of every run are written to a CSV file with one row
+   per run or, if the file name ends with .mat, to a MAT v4 file with one column vector per
+   variable (run status, parameters and outputs) that can be read column by column. In restore
+   mode the parameters are set after the initialization, so only tunable parameters
+   (e.g. the coefficient of restitution e of the BouncingBall) can be swept. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3Sweep.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY(m) m "\\binaries\\x86_64-windows\\" m ".dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#endif
+
+#define MAX_VARIABLES 4
+#define MAX_LINE_LENGTH 4096
+
+typedef struct {
+    const char *name;
+    fmi3ValueReference valueReference;
+    bool tunable;
+} Variable;
+
+typedef struct {
+    int32_t type;
+    int32_t mrows;
+    int32_t ncols;
+    int32_t imagf;
+    int32_t namlen;
+} MatrixHeader;
+
+typedef struct {
+    const char *modelIdentifier;
+    const char *platformBinary;
+    const char *instantiationToken;
+    fmi3Float64 stopTime;
+    fmi3Float64 communicationStepSize;
+    Variable parameters[MAX_VARIABLES];
+    Variable outputs[MAX_VARIABLES];
+} Model;
+
+static const Model models[] = {
+    {
+        "BouncingBall", PLATFORM_BINARY("BouncingBall"), "{8c4e810f-3df3-4a00-8276-176fa3c9f003}", 3, 1e-2,
+        { { "g", 5, false }, { "e", 6, true } },
+        { { "h", 1 }, { "v", 3 } }
+    },
+    {
+        "Dahlquist", PLATFORM_BINARY("Dahlquist"), "{8c4e810f-3df3-4a00-8276-176fa3c9f000}", 10, 0.1,
+        { { "k", 3, false } },
+        { { "x", 1 } }
+    },
+    {
+        "VanDerPol", PLATFORM_BINARY("VanDerPol"), "{8c4e810f-3da3-4a00-8276-176fa3c9f000}", 20, 1e-2,
+        { { "mu", 5, false } },
+        { { "x0", 1 }, { "x1", 3 } }
+    }
+};
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+static const Variable *findVariable(const Variable variables[], const char *name) {
+
+    for (size_t i = 0; i < MAX_VARIABLES && variables[i].name; i++) {
+        if (strcmp(variables[i].name, name) == 0) {
+            return &variables[i];
+        }
+    }
+
+    return NULL;
+}
+
+// read the parameter sets row by row into values (nRuns x nParameters)
+static bool readParameters(const char *filename, const Model *model, const Variable *parameters[], size_t *nParameters, fmi3Float64 **values, size_t *nRuns) {
+
+    char line[MAX_LINE_LENGTH];
+    size_t capacity = 0;
+    bool success = false;
+
+    *nParameters = 0;
+    *values = NULL;
+    *nRuns = 0;
+
+    FILE *file = fopen(filename, "r");
+
+    if (!file) {
+        printf("Failed to open %s.\n", filename);
+        return false;
+    }
+
+    if (!fgets(line, sizeof(line), file)) {
+        printf("%s is empty.\n", filename);
+        goto END;
+    }
+
+    for (char *name = strtok(line, ",\r\n"); name; name = strtok(NULL, ",\r\n")) {
+
+        const Variable *variable = findVariable(model->parameters, name);
+
+        if (!variable || *nParameters == MAX_VARIABLES) {
+            printf("%s has no parameter %s.\n", model->modelIdentifier, name);
+            goto END;
+        }
+
+        parameters[(*nParameters)++] = variable;
+    }
+
+    if (*nParameters == 0) {
+        printf("%s contains no parameters.\n", filename);
+        goto END;
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+
+        if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0') {
+            continue;
+        }
+
+        if (*nRuns == capacity) {
+
+            capacity = capacity > 0 ? 2 * capacity : 1024;
+
+            fmi3Float64 *v = realloc(*values, capacity * *nParameters * sizeof(fmi3Float64));
+
+            if (!v) {
+                printf("Out of memory.\n");
+                goto END;
+            }
+
+            *values = v;
+        }
+
+        char *p = line;
+
+        for (size_t i = 0; i < *nParameters; i++) {
+
+            char *end;
+
+            (*values)[*nRuns * *nParameters + i] = strtod(p, &end);
+
+            if (end == p) {
+                printf("Invalid value in line %zu of %s.\n", *nRuns + 2, filename);
+                goto END;
+            }
+
+            p = *end == ',' ? end + 1 : end;
+        }
+
+        (*nRuns)++;
+    }
+
+    success = true;
+
+END:
+    fclose(file);
+
+    if (!success) {
+        free(*values);
+        *values = NULL;
+    }
+
+    return success;
+}
+
+// write a column vector of doubles to a MAT v4 file
+static bool writeColumn(FILE *file, const char *name, const double values[], size_t n) {
+
+    // M = 0: little endian, 1: big endian
+    const uint16_t one = 1;
+
+    const MatrixHeader header = {
+        .type   = *(const uint8_t *)&one == 1 ? 0 : 1000,
+        .mrows  = (int32_t)n,
+        .ncols  = 1,
+        .imagf  = 0,
+        .namlen = (int32_t)strlen(name) + 1
+    };
+
+    return fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(name, header.namlen, 1, file) == 1 &&
+        fwrite(values, sizeof(double), n, file) == n;
+}
+
+static bool writeMAT(FILE *file,
+    size_t nParameters, const Variable *parameters[], const fmi3Float64 parameterValues[],
+    size_t nOutputs, const Variable outputs[], const fmi3Float64 outputValues[],
+    const FMIStatus runStatus[], size_t nRuns) {
+
+    double *column = calloc(nRuns + 1, sizeof(double));
+
+    bool success = column != NULL;
+
+    for (size_t run = 0; success && run < nRuns; run++) {
+        column[run] = runStatus[run];
+    }
+
+    success = success && writeColumn(file, "status", column, nRuns);
+
+    // the parameter values are stored run by run
+    for (size_t i = 0; success && i < nParameters; i++) {
+
+        for (size_t run = 0; run < nRuns; run++) {
+            column[run] = parameterValues[run * nParameters + i];
+        }
+
+        success = writeColumn(file, parameters[i]->name, column, nRuns);
+    }
+
+    // the output values are already stored column by column
+    for (size_t i = 0; success && i < nOutputs; i++) {
+        success = writeColumn(file, outputs[i].name, &outputValues[i * nRuns], nRuns);
+    }
+
+    free(column);
+
+    return success;
+}
+
+static bool writeCSV(FILE *file,
+    size_t nParameters, const Variable *parameters[], const fmi3Float64 parameterValues[],
+    size_t nOutputs, const Variable outputs[], const fmi3Float64 outputValues[],
+    const FMIStatus runStatus[], size_t nRuns) {
+
+    fputs("run,status", file);
+
+    for (size_t i = 0; i < nParameters; i++) {
+        fprintf(file, ",%s", parameters[i]->name);
+    }
+
+    for (size_t i = 0; i < nOutputs; i++) {
+        fprintf(file, ",%s", outputs[i].name);
+    }
+
+    fputc('\n', file);
+
+    for (size_t run = 0; run < nRuns; run++) {
+
+        fprintf(file, "%zu,%d", run, runStatus[run]);
+
+        for (size_t i = 0; i < nParameters; i++) {
+            fprintf(file, ",%.16g", parameterValues[run * nParameters + i]);
+        }
+
+        // the output values are stored column by column
+        for (size_t i = 0; i < nOutputs; i++) {
+            fprintf(file, ",%.16g", outputValues[i * nRuns + run]);
+        }
+
+        fputc('\n', file);
+    }
+
+    return !ferror(file);
+}
+
+static bool writeResults(const char *filename,
+    size_t nParameters, const Variable *parameters[], const fmi3Float64 parameterValues[],
+    size_t nOutputs, const Variable outputs[], const fmi3Float64 outputValues[],
+    const FMIStatus runStatus[], size_t nRuns) {
+
+    const size_t length = strlen(filename);
+    const bool mat = length > 4 && strcmp(filename + length - 4, ".mat") == 0;
+
+    FILE *file = fopen(filename, mat ? "wb" : "w");
+
+    if (!file) {
+        printf("Failed to create %s.\n", filename);
+        return false;
+    }
+
+    bool success;
+
+    if (mat) {
+        success = writeMAT(file, nParameters, parameters, parameterValues, nOutputs, outputs, outputValues, runStatus, nRuns);
+    } else {
+        success = writeCSV(file, nParameters, parameters, parameterValues, nOutputs, outputs, outputValues, runStatus, nRuns);
+    }
+
+    if (fclose(file) != 0 || !success) {
+        printf("Failed to write %s.\n", filename);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+
+    const Model *model = NULL;
+
+    const Variable *parameterVariables[MAX_VARIABLES];
+    fmi3ValueReference parameters[MAX_VARIABLES];
+    fmi3ValueReference outputs[MAX_VARIABLES];
+    size_t nParameters = 0;
+    size_t nOutputs = 0;
+    size_t nRuns = 0;
+
+    fmi3Float64 *parameterValues = NULL;
+    fmi3Float64 *outputValues = NULL;
+    FMIStatus *runStatus = NULL;
+
+    FMIStatus status = FMIOK;
+
+    FMI3SweepStatistics statistics;
+
+    if (argc < 4) {
+        printf("Usage: parameter_sweep <BouncingBall|Dahlquist|VanDerPol> <parameters.csv> <results.csv|results.mat> [nThreads] [reset|restore]\n");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < sizeof(models) / sizeof(Model); i++) {
+        if (strcmp(models[i].modelIdentifier, argv[1]) == 0) {
+            model = &models[i];
+        }
+    }
+
+    if (!model) {
+        printf("Unknown model %s.\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    if (!readParameters(argv[2], model, parameterVariables, &nParameters, &parameterValues, &nRuns)) {
+        return EXIT_FAILURE;
+    }
+
+    const FMI3SweepMode mode = argc > 5 && strcmp(argv[5], "restore") == 0 ? FMI3SweepRestoreFMUState : FMI3SweepReset;
+
+    for (size_t i = 0; i < nParameters; i++) {
+
+        // fixed parameters can only be set before the initialization
+        if (mode == FMI3SweepRestoreFMUState && !parameterVariables[i]->tunable) {
+            printf("Parameter %s is not tunable and cannot be swept in restore mode.\n", parameterVariables[i]->name);
+            free(parameterValues);
+            return EXIT_FAILURE;
+        }
+
+        parameters[i] = parameterVariables[i]->valueReference;
+    }
+
+    for (; nOutputs < MAX_VARIABLES && model->outputs[nOutputs].name; nOutputs++) {
+        outputs[nOutputs] = model->outputs[nOutputs].valueReference;
+    }
+
+    outputValues = calloc(nOutputs * nRuns + 1, sizeof(fmi3Float64));
+    runStatus = calloc(nRuns + 1, sizeof(FMIStatus));
+
+    if (!outputValues || !runStatus) {
+        printf("Out of memory.\n");
+        status = FMIFatal;
+        goto TERMINATE;
+    }
+
+    const FMI3SweepSettings settings = {
+        .libraryPath           = model->platformBinary,
+        .instantiationToken    = model->instantiationToken,
+        .logMessage            = cb_logMessage,
+        .startTime             = 0,
+        .stopTime              = model->stopTime,
+        .communicationStepSize = model->communicationStepSize,
+        .parameters            = parameters,
+        .nParameters           = nParameters,
+        .outputs               = outputs,
+        .nOutputs              = nOutputs,
+        .mode                  = mode,
+        .nThreads              = argc > 4 ? strtoul(argv[4], NULL, 10) : 0
+    };
+
+    status = FMI3RunSweep(&settings, nRuns, parameterValues, outputValues, runStatus, &statistics);
+
+    printf("%zu runs (%zu failed, %zu stolen) on %zu threads in %g s: %g runs/s, %g runs/s per core\n",
+        statistics.nRuns, statistics.nFailedRuns, statistics.nStolenRuns, statistics.nThreads, statistics.elapsedTime,
+        statistics.nRuns / statistics.elapsedTime, statistics.nRuns / statistics.elapsedTime / statistics.nThreads);
+
+    if (!writeResults(argv[3], nParameters, parameterVariables, parameterValues, nOutputs, model->outputs, outputValues, runStatus, nRuns)) {
+        status = FMIFatal;
+    }
+
+TERMINATE:
+    free(parameterValues);
+    free(outputValues);
+    free(runStatus);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/* This example compares the recording of the results of a long simulation of the VanDerPol
+   FMU with fprintf() (like recordVariables() in the other examples) with FMIRecorder, which
+   writes a binary MAT v4 file on a background thread. The MAT file is converted to CSV
+   afterwards.
+
+   Usage: record_results [nSteps] [decimation] [eventsOnly] */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FMI3.h"
+#include "FMIRecorder.h"
+#include "config.h"
+#include "timer.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY(m) m "\\binaries\\x86_64-windows\\" m ".dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#endif
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+#define CSV_FILE    "record_results_fprintf.csv"
+#define MAT_FILE    "record_results.mat"
+#define EXPORT_FILE "record_results.csv"
+
+#define N_VARIABLES 3
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+typedef struct {
+    FILE *file;
+    FMIRecorder *recorder;
+} Output;
+
+static FMIStatus record(const Output *output, FMIInstance *S, bool event) {
+
+    const fmi3ValueReference valueReferences[N_VARIABLES] = { vr_x0, vr_x1, vr_mu };
+    fmi3Float64 values[N_VARIABLES] = { 0 };
+
+    FMIStatus status = FMI3GetFloat64(S, valueReferences, N_VARIABLES, values, N_VARIABLES);
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
+    if (output->file) {
+        fprintf(output->file, "%g,%g,%g,%g\n", S->time, values[0], values[1], values[2]);
+        return status;
+    }
+
+    return FMIRecorderSample(output->recorder, S->time, values, event);
+}
+
+static FMIStatus simulate(const Output *output, size_t nSteps) {
+
+    const fmi3Float64 h = FIXED_SOLVER_STEP;
+
+    FMIStatus status = FMIOK;
+
+    FMIInstance *S = FMICreateInstance("instance1", PLATFORM_BINARY("VanDerPol"), cb_logMessage, NULL);
+
+    if (!S) {
+        return FMIError;
+    }
+
+    CALL(FMI3InstantiateCoSimulation(S, INSTANTIATION_TOKEN, NULL, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3True, nSteps * h));
+    CALL(FMI3ExitInitializationMode(S));
+
+    CALL(record(output, S, true));
+
+    for (size_t step = 0; step < nSteps; step++) {
+
+        fmi3Boolean eventHandlingNeeded, terminateSimulation, earlyReturn;
+        fmi3Float64 lastSuccessfulTime;
+
+        CALL(FMI3DoStep(S, step * h, h, fmi3True, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+
+        // always record the last sample
+        CALL(record(output, S, step + 1 == nSteps));
+    }
+
+    CALL(FMI3Terminate(S));
+
+TERMINATE:
+
+    if (S->component) {
+        FMI3FreeInstance(S);
+    }
+
+    FMIFreeInstance(S);
+
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+
+    const size_t nSteps = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+
+    const FMIRecorderSettings settings = {
+        .decimation = argc > 2 ? strtoul(argv[2], NULL, 10) : 1,
+        .eventsOnly = argc > 3 && atoi(argv[3]) != 0,
+        .bufferSize = 0,
+        .nBuffers   = 0
+    };
+
+    const char *names[N_VARIABLES] = { "x0", "x1", "mu" };
+
+    FMIStatus status = FMIOK;
+
+    Output output = { NULL, NULL };
+
+    // fprintf()
+    output.file = fopen(CSV_FILE, "w");
+
+    if (!output.file) {
+        printf("Failed to create %s.\n", CSV_FILE);
+        return EXIT_FAILURE;
+    }
+
+    fputs("time,x0,x1,mu\n", output.file);
+
+    double startTime = currentTime();
+
+    status = simulate(&output, nSteps);
+
+    fclose(output.file);
+    output.file = NULL;
+
+    printf("fprintf():     %.3f s\n", currentTime() - startTime);
+
+    if (status > FMIWarning) {
+        return EXIT_FAILURE;
+    }
+
+    // FMIRecorder
+    startTime = currentTime();
+
+    output.recorder = FMICreateRecorder(MAT_FILE, names, N_VARIABLES, &settings);
+
+    if (!output.recorder) {
+        printf("Failed to create %s.\n", MAT_FILE);
+        return EXIT_FAILURE;
+    }
+
+    status = simulate(&output, nSteps);
+
+    FMIRecorderStatistics statistics;
+
+    if (FMIRecorderClose(output.recorder, &statistics) > status) {
+        status = FMIError;
+    }
+
+    printf("FMIRecorder:   %.3f s (%zu of %zu samples recorded, %zu buffers written, %zu waits)\n",
+        currentTime() - startTime, statistics.nRecorded, statistics.nSamples, statistics.nBuffersWritten, statistics.nWaits);
+
+    if (status > FMIWarning) {
+        return EXIT_FAILURE;
+    }
+
+    // CSV export
+    startTime = currentTime();
+
+    status = FMIRecorderExportCSV(MAT_FILE, EXPORT_FILE);
+
+    printf("CSV export:    %.3f s\n", currentTime() - startTime);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/* This example instantiates the Resource model twice with logging switched on. Both
+   instances read y.txt from the same resources directory, so the file is mapped once
+   and its reference count goes up to 2 and back to 0 as the instances are freed. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FMI3.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY "Resource\\binaries\\x86_64-windows\\Resource.dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY "Resource/binaries/x86_64-darwin/Resource.dylib"
+#else
+#define PLATFORM_BINARY "Resource/binaries/x86_64-linux/Resource.so"
+#endif
+
+#define INSTANTIATION_TOKEN "{7b9c2114-2ce5-4076-a138-2cbc69e069e5}"
+
+#define vr_y 1
+
+#define N_INSTANCES 2
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+int main(int argc, char* argv[]) {
+
+    const char *instanceNames[N_INSTANCES] = { "instance1", "instance2" };
+    const fmi3ValueReference valueReferences[1] = { vr_y };
+
+    FMIInstance *instances[N_INSTANCES] = { NULL };
+
+    char resourcePath[4096] = "";
+
+    FMIStatus status = FMIOK;
+
+#ifdef _WIN32
+    _fullpath(resourcePath, "Resource\\resources\\", 4096);
+#else
+    realpath("Resource/resources/", resourcePath);
+#endif
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        instances[i] = FMICreateInstance(instanceNames[i], PLATFORM_BINARY, cb_logMessage, NULL);
+
+        if (!instances[i]) {
+            printf("Failed to load %s.\n", PLATFORM_BINARY);
+            status = FMIError;
+            goto TERMINATE;
+        }
+
+        CALL(FMI3InstantiateCoSimulation(instances[i],
+            INSTANTIATION_TOKEN, // instantiationToken
+            resourcePath,        // resourcePath
+            fmi3False,           // visible
+            fmi3True,            // loggingOn
+            fmi3False,           // eventModeUsed
+            fmi3False,           // earlyReturnAllowed
+            NULL,                // requiredIntermediateVariables
+            0,                   // nRequiredIntermediateVariables
+            NULL                 // intermediateUpdate
+        ));
+    }
+
+    for (size_t i = 0; i < N_INSTANCES; i++) {
+
+        fmi3Int32 y = 0;
+
+        CALL(FMI3EnterInitializationMode(instances[i], fmi3False, 0.0, 0.0, fmi3False, 0.0));
+        CALL(FMI3ExitInitializationMode(instances[i]));
+        CALL(FMI3GetInt32(instances[i], valueReferences, 1, &y, 1));
+
+        printf("%s: y = %d\n", instanceNames[i], y);
+    }
+
+TERMINATE:
+
+    // free the instances in reverse order
+    for (size_t i = N_INSTANCES; i-- > 0;) {
+
+        if (!instances[i]) {
+            continue;
+        }
+
+        if (instances[i]->component) {
+
+            if (status < FMIError) {
+                FMIStatus terminateStatus = FMI3Terminate(instances[i]);
+                status = terminateStatus > status ? terminateStatus : status;
+            }
+
+            FMI3FreeInstance(instances[i]);
+        }
+
+        FMIFreeInstance(instances[i]);
+    }
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/* This example activates the model partitions of the Clocks FMU in real time with
+   FMI3Executor. Every input clock runs on its own SCHED_FIFO thread with a priority
+   that is derived from the clock priority in the modelDescription.xml and all threads
+   are pinned to one CPU.
+
+   inClock1 is periodic, inClock2 is triggered at 0, 1, 8 and 9 by the task of inClock1
+   and the countdown clock inClock3 is triggered from the intermediateUpdate callback.
+
+   Usage: scs_realtime [timeScale] [cpu] */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // sched_getcpu()
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "FMI3ClockScheduler.h"
+#include "FMI3Executor.h"
+#include "config.h"
+
+#if defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#endif
+
+#define MODEL_DESCRIPTION(m) m "/modelDescription.xml"
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+static FMI3Executor *executor = NULL;
+
+// output3 of model partition 3 that is passed to input2 of model partition 2
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static fmi3Int32 output3 = 0;
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+static void cb_intermediateUpdate(fmi3InstanceEnvironment instanceEnvironment,
+    fmi3Float64 intermediateUpdateTime,
+    fmi3Boolean clocksTicked,
+    fmi3Boolean intermediateVariableSetRequested,
+    fmi3Boolean intermediateVariableGetAllowed,
+    fmi3Boolean intermediateStepFinished,
+    fmi3Boolean canReturnEarly,
+    fmi3Boolean *earlyReturnRequested,
+    fmi3Float64 *earlyReturnTime) {
+
+    FMIInstance *S = instanceEnvironment;
+
+    const fmi3ValueReference countdownClocks[1] = { vr_inClock3 };
+    fmi3Float64 intervals[1] = { 0 };
+    fmi3IntervalQualifier qualifiers[1] = { fmi3IntervalNotYetKnown };
+
+    const fmi3ValueReference outputClocks[1] = { vr_outClock };
+    fmi3Clock outputClockValues[1] = { fmi3ClockInactive };
+
+    *earlyReturnRequested = fmi3False;
+
+    if (!clocksTicked) {
+        return;
+    }
+
+    // the partitions access the clocks in critical sections
+    FMI3ExecutorLockPreemption();
+    FMI3GetIntervalDecimal(S, countdownClocks, 1, intervals, qualifiers, 1);
+    FMI3GetClock(S, outputClocks, 1, outputClockValues, 1);
+    FMI3ExecutorUnlockPreemption();
+
+    if (qualifiers[0] == fmi3IntervalChanged) {
+        FMI3ExecutorTrigger(executor, vr_inClock3, intermediateUpdateTime + intervals[0]);
+    }
+
+    if (outputClockValues[0]) {
+        printf("outClock ticked at t=%g\n", intermediateUpdateTime);
+    }
+}
+
+static FMIStatus afterActivation1(FMIInstance *S, fmi3ValueReference clockReference, fmi3Float64 activationTime, void *userData) {
+
+    const int t = (int)activationTime;
+
+    if (t % 8 == 0 || (t - 1) % 8 == 0) {
+        FMI3ExecutorTrigger(executor, vr_inClock2, activationTime);
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus beforeActivation2(FMIInstance *S, fmi3ValueReference clockReference, fmi3Float64 activationTime, void *userData) {
+
+    const fmi3ValueReference valueReferences[1] = { vr_input2 };
+
+    pthread_mutex_lock(&mutex);
+    fmi3Int32 values[1] = { output3 };
+    output3 = 0; // count the output only once
+    pthread_mutex_unlock(&mutex);
+
+    return FMI3SetInt32(S, valueReferences, 1, values, 1);
+}
+
+static FMIStatus afterActivation3(FMIInstance *S, fmi3ValueReference clockReference, fmi3Float64 activationTime, void *userData) {
+
+    const fmi3ValueReference valueReferences[1] = { vr_output3 };
+    fmi3Int32 values[1];
+
+    FMIStatus status = FMI3GetInt32(S, valueReferences, 1, values, 1);
+
+    pthread_mutex_lock(&mutex);
+    output3 = values[0];
+    pthread_mutex_unlock(&mutex);
+
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+
+    const char *names[N_INPUT_CLOCKS] = { "inClock1", "inClock2", "inClock3" };
+
+    const fmi3ValueReference clockReferences[N_INPUT_CLOCKS] = { vr_inClock1, vr_inClock2, vr_inClock3 };
+    fmi3Int32 priorities[N_INPUT_CLOCKS];
+
+    if (FMI3ReadClockPriorities(MODEL_DESCRIPTION("Clocks"), clockReferences, priorities, N_INPUT_CLOCKS) != FMIOK) {
+        printf("Failed to read the clock priorities from %s.\n", MODEL_DESCRIPTION("Clocks"));
+        return EXIT_FAILURE;
+    }
+
+    const FMI3ExecutorTask tasks[N_INPUT_CLOCKS] = {
+        { vr_inClock1, priorities[0], 1, 0, NULL,              afterActivation1, NULL },
+        { vr_inClock2, priorities[1], 0, 0, beforeActivation2, NULL,             NULL },
+        { vr_inClock3, priorities[2], 0, 0, NULL,              afterActivation3, NULL },
+    };
+
+    const fmi3ValueReference outputs[4] = { vr_inClock1Ticks, vr_inClock2Ticks, vr_inClock3Ticks, vr_totalInClockTicks };
+    fmi3Int32 values[4] = { 0 };
+
+    const fmi3Float64 startTime = 0;
+    const fmi3Float64 stopTime = 10;
+
+    FMIStatus status = FMIOK;
+
+    const FMI3ExecutorSettings settings = {
+        .cpu         = argc > 2 ? atoi(argv[2]) : sched_getcpu(),
+        .realTime    = true,
+        .maxPriority = 0,
+        .timeScale   = argc > 1 ? atof(argv[1]) : 0.1
+    };
+
+    FMIInstance *S = FMICreateInstance("instance1", PLATFORM_BINARY("Clocks"), cb_logMessage, NULL);
+
+    if (!S) {
+        return EXIT_FAILURE;
+    }
+
+    CALL(FMI3InstantiateScheduledExecution(S,
+        INSTANTIATION_TOKEN,            // instantiationToken
+        NULL,                           // resourcePath
+        fmi3False,                      // visible
+        fmi3False,                      // loggingOn
+        NULL,                           // requiredIntermediateVariables
+        0,                              // nRequiredIntermediateVariables
+        cb_intermediateUpdate,          // intermediateUpdate
+        FMI3ExecutorLockPreemption,     // lockPreemption
+        FMI3ExecutorUnlockPreemption    // unlockPreemption
+    ));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, startTime, fmi3True, stopTime));
+    CALL(FMI3ExitInitializationMode(S));
+
+    executor = FMI3CreateExecutor(S, tasks, N_INPUT_CLOCKS, &settings);
+
+    if (!executor) {
+        printf("Failed to create the executor.\n");
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    CALL(FMI3ExecutorRun(executor, startTime, stopTime));
+
+    CALL(FMI3GetInt32(S, outputs, 4, values, 4));
+
+    printf("inClock1Ticks=%d, inClock2Ticks=%d, inClock3Ticks=%d, totalInClockTicks=%d\n", values[0], values[1], values[2], values[3]);
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+
+        FMI3TaskStatistics statistics;
+
+        CALL(FMI3ExecutorGetStatistics(executor, tasks[i].clockReference, &statistics));
+
+        printf("%s: %zu activations, %zu overruns, %zu dropped, max. latency %g us, max. execution time %g us\n",
+            names[i], statistics.nActivations, statistics.nOverruns, statistics.nDropped,
+            statistics.maxLatency * 1e6, statistics.maxExecutionTime * 1e6);
+    }
+
+    CALL(FMI3Terminate(S));
+
+TERMINATE:
+
+    if (S->component) {
+        FMI3FreeInstance(S);
+    }
+
+    FMI3FreeExecutor(executor);
+
+    FMIFreeInstance(S);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -2,11 +2,12 @@
 #define LOG_FILE     "scs_synchronous_log.txt"
 
 #include "util.h"
+#include "FMI3ClockScheduler.h"
 
 
-fmi3Float64 countdownClockIntervals[1] = { 0.0 };
-fmi3IntervalQualifier countdownClocksQualifier[1] = { fmi3IntervalNotYetKnown };
+FMI3ClockScheduler *scheduler = NULL;
 fmi3ValueReference vr_countdownClocks[1] = { vr_inClock3 };
+fmi3Int32 countdownClockPriorities[1] = { 2 };
 fmi3ValueReference outClockVRs[1] = { vr_outClock };
 fmi3Clock outClockValues[2];
 
@@ -21,10 +22,9 @@ static void cb_intermediateUpdate(fmi3InstanceEnvironment instanceEnvironment,
                                   fmi3Boolean *earlyReturnRequested,
                                   fmi3Float64 *earlyReturnTime) {
 
+    // schedule the countdown clocks whose interval has changed
     if (clocksTicked) {
-        countdownClockIntervals[0] = 0.0;
-        countdownClocksQualifier[0] = fmi3IntervalNotYetKnown;
-        FMI3GetIntervalDecimal(S, vr_countdownClocks, 1, countdownClockIntervals, countdownClocksQualifier, 1);
+        FMI3ClockSchedulerUpdateCountdownClocks(scheduler, S, vr_countdownClocks, countdownClockPriorities, NULL, 1, intermediateUpdateTime);
     }
 }
 
@@ -33,6 +33,13 @@ int main(int argc, char* argv[]) {
 
     CALL(setUp());
 
+    scheduler = FMI3CreateClockScheduler();
+
+    if (!scheduler) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
     CALL(FMI3InstantiateScheduledExecution(S,
         INSTANTIATION_TOKEN,   // instantiationToken
         NULL,                  // resourceLocation
@@ -51,31 +58,32 @@ int main(int argc, char* argv[]) {
     CALL(FMI3EnterInitializationMode(S, fmi3False, 0, 0, fmi3False, 0));
     CALL(FMI3ExitInitializationMode(S));
 
-    int time = 0;
+    // Model Partition 1 is active every second
+    CALL(FMI3ClockSchedulerAddPeriodicClock(scheduler, S, vr_inClock1, 0, 1, 0, NULL));
 
-    // simulation loop
-    while (time < 10) {
+    // Model Partition 2 is active at 0, 1, 8, and 9
+    CALL(FMI3ClockSchedulerAddPeriodicClock(scheduler, S, vr_inClock2, 1, 8, 0, NULL));
+    CALL(FMI3ClockSchedulerAddPeriodicClock(scheduler, S, vr_inClock2, 1, 8, 1, NULL));
 
-        // Model Partition 1 is active every second
-        CALL(FMI3ActivateModelPartition(S, vr_inClock1, 0, time));
+    fmi3Float64 time;
 
-        // Model Partition 2 is active at 0, 1, 8, and 9
-        if (time % 8 == 0 || (time - 1) % 8 == 0) {
-            CALL(FMI3ActivateModelPartition(S, vr_inClock2, 0, time));
-        }
+    // simulation loop
+    while ((time = FMI3ClockSchedulerNextTime(scheduler)) < 10) {
+
+        FMI3ClockEvent event;
 
-        if (countdownClocksQualifier[0] == fmi3IntervalChanged) {
-            CALL(FMI3ActivateModelPartition(S, vr_inClock3, 0, time));
-            countdownClocksQualifier[0] = fmi3IntervalUnchanged;
+        // activate the due partitions by priority (including the ones scheduled during the activations)
+        while (FMI3ClockSchedulerPop(scheduler, time, &event)) {
+            CALL(FMI3ActivateModelPartition(S, event.clockReference, 0, time));
         }
 
         CALL(FMI3GetClock(S, outClockVRs, 1, outClockValues, 1));
 
         CALL(recordVariables(S, outputFile));
-
-        time++;
     }
 
 TERMINATE:
+    FMI3FreeClockScheduler(scheduler);
+
     return tearDown();
 }
@@ -0,0 +1,205 @@
+/* This example simulates the preemptive scheduling of the model partitions of the Clocks FMU
+   on a single processor in virtual time with FMI3VirtualExecutor. The results do not depend
+   on the wall-clock time and are reproducible. Every finished activation is written to
+   scs_virtual_out.csv.
+
+   inClock1 is periodic, inClock2 is triggered at 0, 1, 8 and 9 by the task of inClock1
+   and the countdown clock inClock3 is triggered from the intermediateUpdate callback.
+
+   Usage: scs_virtual [executionTime1 executionTime2 executionTime3] */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FMI3ClockScheduler.h"
+#include "FMI3VirtualExecutor.h"
+#include "config.h"
+
+#if defined(_WIN32)
+#define PLATFORM_BINARY(m) m "\\binaries\\x86_64-windows\\" m ".dll"
+#elif defined(__APPLE__)
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-darwin/" m ".dylib"
+#else
+#define PLATFORM_BINARY(m) m "/binaries/x86_64-linux/" m ".so"
+#endif
+
+#define MODEL_DESCRIPTION(m) m "/modelDescription.xml"
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+#define OUTPUT_FILE "scs_virtual_out.csv"
+
+static FMI3VirtualExecutor *executor = NULL;
+
+// output3 of model partition 3 that is passed to input2 of model partition 2
+static fmi3Int32 output3 = 0;
+
+static void cb_logMessage(FMIInstance *instance, FMIStatus status, const char *category, const char *message) {
+    printf("[%s] %s\n", instance->name, message);
+}
+
+static void cb_intermediateUpdate(fmi3InstanceEnvironment instanceEnvironment,
+    fmi3Float64 intermediateUpdateTime,
+    fmi3Boolean clocksTicked,
+    fmi3Boolean intermediateVariableSetRequested,
+    fmi3Boolean intermediateVariableGetAllowed,
+    fmi3Boolean intermediateStepFinished,
+    fmi3Boolean canReturnEarly,
+    fmi3Boolean *earlyReturnRequested,
+    fmi3Float64 *earlyReturnTime) {
+
+    FMIInstance *S = instanceEnvironment;
+
+    const fmi3ValueReference countdownClocks[1] = { vr_inClock3 };
+    fmi3Float64 intervals[1] = { 0 };
+    fmi3IntervalQualifier qualifiers[1] = { fmi3IntervalNotYetKnown };
+
+    *earlyReturnRequested = fmi3False;
+
+    if (!clocksTicked) {
+        return;
+    }
+
+    FMI3GetIntervalDecimal(S, countdownClocks, 1, intervals, qualifiers, 1);
+
+    if (qualifiers[0] == fmi3IntervalChanged) {
+        FMI3VirtualExecutorTrigger(executor, vr_inClock3, intermediateUpdateTime + intervals[0]);
+    }
+}
+
+static FMIStatus afterActivation1(FMIInstance *S, fmi3ValueReference clockReference, fmi3Float64 activationTime, void *userData) {
+
+    const int t = (int)activationTime;
+
+    if (t % 8 == 0 || (t - 1) % 8 == 0) {
+        return FMI3VirtualExecutorTrigger(executor, vr_inClock2, activationTime);
+    }
+
+    return FMIOK;
+}
+
+static FMIStatus beforeActivation2(FMIInstance *S, fmi3ValueReference clockReference, fmi3Float64 activationTime, void *userData) {
+
+    const fmi3ValueReference valueReferences[1] = { vr_input2 };
+    fmi3Int32 values[1] = { output3 };
+
+    output3 = 0; // count the output only once
+
+    return FMI3SetInt32(S, valueReferences, 1, values, 1);
+}
+
+static FMIStatus afterActivation3(FMIInstance *S, fmi3ValueReference clockReference, fmi3Float64 activationTime, void *userData) {
+
+    const fmi3ValueReference valueReferences[1] = { vr_output3 };
+
+    return FMI3GetInt32(S, valueReferences, 1, &output3, 1);
+}
+
+static void jobFinished(const FMI3VirtualJob *job, void *userData) {
+
+    FILE *file = userData;
+
+    fprintf(file, "%u,%.16g,%.16g,%.16g,%.16g,%zu\n", job->clockReference,
+        job->activationTime, job->releaseTime, job->startTime, job->finishTime, job->nPreemptions);
+}
+
+int main(int argc, char* argv[]) {
+
+    const char *names[N_INPUT_CLOCKS] = { "inClock1", "inClock2", "inClock3" };
+
+    const fmi3ValueReference clockReferences[N_INPUT_CLOCKS] = { vr_inClock1, vr_inClock2, vr_inClock3 };
+    fmi3Int32 priorities[N_INPUT_CLOCKS];
+
+    if (FMI3ReadClockPriorities(MODEL_DESCRIPTION("Clocks"), clockReferences, priorities, N_INPUT_CLOCKS) != FMIOK) {
+        printf("Failed to read the clock priorities from %s.\n", MODEL_DESCRIPTION("Clocks"));
+        return EXIT_FAILURE;
+    }
+
+    // execution times of the partitions
+    const FMI3ExecutorTask tasks[N_INPUT_CLOCKS] = {
+        { vr_inClock1, priorities[0], 1, 0, NULL,              afterActivation1, NULL, argc > 3 ? atof(argv[1]) : 0.3 },
+        { vr_inClock2, priorities[1], 0, 0, beforeActivation2, NULL,             NULL, argc > 3 ? atof(argv[2]) : 0.2 },
+        { vr_inClock3, priorities[2], 0, 0, NULL,              afterActivation3, NULL, argc > 3 ? atof(argv[3]) : 1.5 },
+    };
+
+    const fmi3ValueReference outputs[5] = { vr_inClock1Ticks, vr_inClock2Ticks, vr_inClock3Ticks, vr_totalInClockTicks, vr_result2 };
+    fmi3Int32 values[5] = { 0 };
+
+    const fmi3Float64 startTime = 0;
+    const fmi3Float64 stopTime = 10;
+
+    FMIStatus status = FMIOK;
+
+    FILE *outputFile = fopen(OUTPUT_FILE, "w");
+
+    if (!outputFile) {
+        printf("Failed to open %s.\n", OUTPUT_FILE);
+        return EXIT_FAILURE;
+    }
+
+    fputs("clock,activationTime,releaseTime,startTime,finishTime,preemptions\n", outputFile);
+
+    FMIInstance *S = FMICreateInstance("instance1", PLATFORM_BINARY("Clocks"), cb_logMessage, NULL);
+
+    if (!S) {
+        fclose(outputFile);
+        return EXIT_FAILURE;
+    }
+
+    CALL(FMI3InstantiateScheduledExecution(S,
+        INSTANTIATION_TOKEN,   // instantiationToken
+        NULL,                  // resourcePath
+        fmi3False,             // visible
+        fmi3False,             // loggingOn
+        NULL,                  // requiredIntermediateVariables
+        0,                     // nRequiredIntermediateVariables
+        cb_intermediateUpdate, // intermediateUpdate
+        NULL,                  // lockPreemption
+        NULL                   // unlockPreemption
+    ));
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0, startTime, fmi3True, stopTime));
+    CALL(FMI3ExitInitializationMode(S));
+
+    executor = FMI3CreateVirtualExecutor(S, tasks, N_INPUT_CLOCKS, jobFinished, outputFile);
+
+    if (!executor) {
+        printf("Failed to create the executor.\n");
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    CALL(FMI3VirtualExecutorRun(executor, startTime, stopTime));
+
+    CALL(FMI3GetInt32(S, outputs, 5, values, 5));
+
+    printf("inClock1Ticks=%d, inClock2Ticks=%d, inClock3Ticks=%d, totalInClockTicks=%d, result2=%d\n",
+        values[0], values[1], values[2], values[3], values[4]);
+
+    for (size_t i = 0; i < N_INPUT_CLOCKS; i++) {
+
+        FMI3VirtualTaskStatistics statistics;
+
+        CALL(FMI3VirtualExecutorGetStatistics(executor, tasks[i].clockReference, &statistics));
+
+        printf("%s: %zu activations, %zu preemptions, %zu overruns, %zu deadline misses, max. latency %g s, max. response time %g s\n",
+            names[i], statistics.nActivations, statistics.nPreemptions, statistics.nOverruns,
+            statistics.nDeadlineMisses, statistics.maxLatency, statistics.maxResponseTime);
+    }
+
+    CALL(FMI3Terminate(S));
+
+TERMINATE:
+
+    if (S->component) {
+        FMI3FreeInstance(S);
+    }
+
+    FMI3FreeVirtualExecutor(executor);
+
+    FMIFreeInstance(S);
+
+    fclose(outputFile);
+
+    return status > FMIWarning ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -2,57 +2,78 @@
 #define LOG_FILE     xstr(MODEL_IDENTIFIER) "_cs_log.txt"
 
 #include "util.h"
+#include "FMI3Simulation.h"
 
 
-int main(int argc, char* argv[]) {
-
-    CALL(setUp());
-
-    // tag::CoSimulation[]
-    CALL(FMI3InstantiateCoSimulation(S,
-        INSTANTIATION_TOKEN, // instantiationToken
-        resourcePath(),      // resourcePath
-        fmi3False,           // visible
-        fmi3False,           // loggingOn
-        fmi3False,           // eventModeUsed
-        fmi3False,           // earlyReturnAllowed
-        NULL,                // requiredIntermediateVariables
-        0,                   // nRequiredIntermediateVariables
-        NULL                 // intermediateUpdate
-    ));
+static FMIStatus cb_applyStartValues(FMIInstance *instance, void *userData) {
+    return applyStartValues(instance);
+}
 
-    // set start values
-    CALL(applyStartValues(S));
+static FMIStatus cb_applyContinuousInputs(FMIInstance *instance, bool afterEvent, void *userData) {
+    return applyContinuousInputs(instance, afterEvent);
+}
 
-    // initialize the FMU
-    CALL(FMI3EnterInitializationMode(S, fmi3False, 0.0, startTime, fmi3True, stopTime));
+static FMIStatus cb_applyDiscreteInputs(FMIInstance *instance, void *userData) {
+    return applyDiscreteInputs(instance);
+}
 
-    CALL(FMI3ExitInitializationMode(S));
+static FMIStatus cb_recordVariables(FMIInstance *instance, void *userData) {
+    return recordVariables(instance, userData);
+}
 
-    for (int step = 0;; step++) {
+int main(int argc, char* argv[]) {
 
-        CALL(recordVariables(S, outputFile));
+    FMIStatus status = FMIError;
 
-        // calculate the current time
-        const fmi3Float64 time = step * h;
+    FILE *outputFile = createOutputFile(OUTPUT_FILE);
+    FILE *logFile = fopen(LOG_FILE, "w");
 
-        CALL(applyContinuousInputs(S, false));
-        CALL(applyDiscreteInputs(S));
+    if (!outputFile || !logFile) {
+        printf("Failed to open %s or %s.\n", OUTPUT_FILE, LOG_FILE);
+        goto TERMINATE;
+    }
 
-        if (time >= stopTime) {
-            break;
+    const FMI3SimulationSettings settings = {
+        .instanceName       = "instance1",
+        .libraryPath        = PLATFORM_BINARY,
+        .instantiationToken = INSTANTIATION_TOKEN,
+        .resourcePath       = resourcePath(),
+        .interfaceType      = FMICoSimulation,
+        .startTime          = startTime,
+        .stopTime           = stopTime,
+        .stepSize           = h,
+        .loggingOn          = fmi3False,
+        .logMessage         = logMessage,
+        .logFile            = logFile,
+        .inputs = {
+            .applyStartValues      = cb_applyStartValues,
+            .applyContinuousInputs = cb_applyContinuousInputs,
+            .applyDiscreteInputs   = cb_applyDiscreteInputs
+        },
+        .results = {
+            .recordVariables = cb_recordVariables,
+            .userData        = outputFile
         }
+    };
 
-        // call instance s1 and check status
-        CALL(FMI3DoStep(S, time, h, fmi3True, &eventEncountered, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+    FMI3SimulationStatistics statistics;
 
-        if (terminateSimulation) {
-            printf("The FMU requested to terminate the simulation.");
-            break;
-        }
+    // instantiate, initialize and simulate the FMU with a fixed communication step
+    status = FMI3Simulate(&settings, &statistics);
+
+    if (statistics.terminated) {
+        printf("The FMU requested to terminate the simulation.");
     }
 
 TERMINATE:
-    return tearDown();
-    // end::CoSimulation[]
+
+    if (outputFile) {
+        fclose(outputFile);
+    }
+
+    if (logFile) {
+        fclose(logFile);
+    }
+
+    return status;
 }
@@ -0,0 +1,152 @@
+/* This example runs simulations of the BouncingBall with different coefficients of
+   restitution as Model Exchange and Co-Simulation on several threads at once with
+   FMI3Simulate(). Every simulation records its results into its own buffer. The results
+   are compared to the ones of the same simulations run one after another. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "FMI3Simulation.h"
+
+#if defined(__APPLE__)
+#define PLATFORM_BINARY "BouncingBall/binaries/x86_64-darwin/BouncingBall.dylib"
+#else
+#define PLATFORM_BINARY "BouncingBall/binaries/x86_64-linux/BouncingBall.so"
+#endif
+
+#define INSTANTIATION_TOKEN "{8c4e810f-3df3-4a00-8276-176fa3c9f003}"
+
+#define N_SIMULATIONS 8
+
+#define RESULT_SIZE 65536
+
+typedef struct {
+    FMIInterfaceType interfaceType;
+    fmi3Float64 e;
+    FMIStatus status;
+    char result[RESULT_SIZE];
+    size_t resultLength;
+} Simulation;
+
+static FMIStatus applyStartValues(FMIInstance *instance, void *userData) {
+
+    const Simulation *simulation = userData;
+
+    const fmi3ValueReference vr_e = 6;
+
+    return FMI3SetFloat64(instance, &vr_e, 1, &simulation->e, 1);
+}
+
+static FMIStatus recordVariables(FMIInstance *instance, void *userData) {
+
+    Simulation *simulation = userData;
+
+    // h, v
+    const fmi3ValueReference vr[2] = { 1, 3 };
+    fmi3Float64 values[2];
+
+    const FMIStatus status = FMI3GetFloat64(instance, vr, 2, values, 2);
+
+    const size_t available = RESULT_SIZE - simulation->resultLength;
+
+    const int length = snprintf(&simulation->result[simulation->resultLength], available, "%.16g,%.16g,%.16g\n", instance->time, values[0], values[1]);
+
+    if (length < 0 || (size_t)length >= available) {
+        return FMIError;
+    }
+
+    simulation->resultLength += (size_t)length;
+
+    return status;
+}
+
+static void *simulate(void *arg) {
+
+    Simulation *simulation = arg;
+
+    const FMI3SimulationSettings settings = {
+        .instanceName       = "instance1",
+        .libraryPath        = PLATFORM_BINARY,
+        .instantiationToken = INSTANTIATION_TOKEN,
+        .resourcePath       = NULL,
+        .interfaceType      = simulation->interfaceType,
+        .startTime          = 0,
+        .stopTime           = 3,
+        .stepSize           = 1e-2,
+        .nx                 = 2,
+        .nz                 = 1,
+        .loggingOn          = fmi3False,
+        .logMessage         = NULL,
+        .logFile            = NULL,
+        .inputs = {
+            .applyStartValues = applyStartValues,
+            .userData         = simulation
+        },
+        .results = {
+            .recordVariables = recordVariables,
+            .userData        = simulation
+        }
+    };
+
+    simulation->resultLength = 0;
+    simulation->status = FMI3Simulate(&settings, NULL);
+
+    return NULL;
+}
+
+int main(int argc, char* argv[]) {
+
+    static Simulation simulations[N_SIMULATIONS];
+    static Simulation references[N_SIMULATIONS];
+
+    pthread_t threads[N_SIMULATIONS];
+
+    size_t nFailed = 0;
+
+    for (size_t i = 0; i < N_SIMULATIONS; i++) {
+        simulations[i].interfaceType = i % 2 == 0 ? FMIModelExchange : FMICoSimulation;
+        simulations[i].e = 0.5 + 0.1 * (i / 2);
+        references[i] = simulations[i];
+    }
+
+    // run the simulations one after another
+    for (size_t i = 0; i < N_SIMULATIONS; i++) {
+        simulate(&references[i]);
+    }
+
+    // run the simulations at once
+    for (size_t i = 0; i < N_SIMULATIONS; i++) {
+        if (pthread_create(&threads[i], NULL, simulate, &simulations[i]) != 0) {
+            printf("Failed to create thread %zu.\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (size_t i = 0; i < N_SIMULATIONS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (size_t i = 0; i < N_SIMULATIONS; i++) {
+
+        const Simulation *s = &simulations[i];
+        const Simulation *r = &references[i];
+
+        const char *interfaceType = s->interfaceType == FMIModelExchange ? "Model Exchange" : "Co-Simulation";
+
+        if (s->status > FMIWarning || r->status > FMIWarning) {
+            printf("%s with e=%g failed.\n", interfaceType, s->e);
+            nFailed++;
+        } else if (s->resultLength != r->resultLength || memcmp(s->result, r->result, s->resultLength) != 0) {
+            printf("%s with e=%g differs from the sequential simulation.\n", interfaceType, s->e);
+            nFailed++;
+        } else {
+            printf("%s with e=%g: %zu bytes of results\n", interfaceType, s->e, s->resultLength);
+        }
+    }
+
+    printf("%zu of %d concurrent simulations failed\n", nFailed, N_SIMULATIONS);
+
+    return nFailed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
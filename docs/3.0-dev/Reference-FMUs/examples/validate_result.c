@@ -0,0 +1,127 @@
+/* This tool validates simulation results against a reference result, e.g. the
+   <Model>_ref.csv of the Reference FMUs or the results of a parameter sweep.
+
+   Usage: validate_result [-r relTol] [-a absTol] [-t timeTolerance] [-v] reference.csv result.csv...
+
+   The reference is loaded once and every result is streamed, resampled at the times of
+   the reference and checked against the tolerance tubes of the columns. The first
+   violation and the maximum error are reported for every column that fails (or for
+   all columns with -v). The exit code is 1 if any of the results fails. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMIValidation.h"
+#include "timer.h"
+
+
+static void printUsage(void) {
+    printf("Usage: validate_result [-r relTol] [-a absTol] [-t timeTolerance] [-v] reference.csv result.csv...\n");
+}
+
+int main(int argc, char* argv[]) {
+
+    FMIValidationSettings settings = {
+        .relTol        = 1e-3,
+        .absTol        = 1e-6,
+        .timeTolerance = 0
+    };
+
+    bool verbose = false;
+
+    int i = 1;
+
+    for (; i < argc && argv[i][0] == '-'; i++) {
+
+        if (!strcmp(argv[i], "-v")) {
+            verbose = true;
+        } else if (i + 1 < argc && !strcmp(argv[i], "-r")) {
+            settings.relTol = atof(argv[++i]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-a")) {
+            settings.absTol = atof(argv[++i]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-t")) {
+            settings.timeTolerance = atof(argv[++i]);
+        } else {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - i < 2) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    const double startTime = currentTime();
+
+    FMIReference *reference = FMILoadReference(argv[i], &settings);
+
+    if (!reference) {
+        printf("Failed to load %s.\n", argv[i]);
+        return EXIT_FAILURE;
+    }
+
+    const size_t nColumns = FMIReferenceColumnCount(reference);
+
+    FMIColumnValidation *columns = calloc(nColumns + 1, sizeof(FMIColumnValidation));
+
+    if (!columns) {
+        FMIFreeReference(reference);
+        return EXIT_FAILURE;
+    }
+
+    size_t nResults = 0, nFailed = 0;
+
+    for (i++; i < argc; i++) {
+
+        bool passed = false;
+
+        nResults++;
+
+        if (FMIValidateResult(reference, argv[i], columns, &passed) > FMIWarning) {
+            printf("ERROR %s: failed to read the result\n", argv[i]);
+            nFailed++;
+            continue;
+        }
+
+        if (!passed) {
+            nFailed++;
+        }
+
+        if (passed && !verbose) {
+            continue;
+        }
+
+        printf("%s %s\n", passed ? "PASS" : "FAIL", argv[i]);
+
+        for (size_t j = 0; j < nColumns; j++) {
+
+            const FMIColumnValidation *c = &columns[j];
+
+            if (c->nViolations == 0 && !verbose) {
+                continue;
+            }
+
+            printf("  %-24s max. error %-12g at t=%-12g", c->name, c->maxError, c->maxErrorTime);
+
+            if (c->nViolations > 0 && isnan(c->firstViolationValue)) {
+                printf(" %zu violations, the result ends before t=%g", c->nViolations, c->firstViolationTime);
+            } else if (c->nViolations > 0) {
+                printf(" %zu violations, first at t=%g: %g not in [%g, %g]", c->nViolations,
+                    c->firstViolationTime, c->firstViolationValue, c->firstViolationLower, c->firstViolationUpper);
+            }
+
+            printf("\n");
+        }
+    }
+
+    printf("%zu of %zu results passed in %.3f s\n", nResults - nFailed, nResults, currentTime() - startTime);
+
+    free(columns);
+
+    FMIFreeReference(reference);
+
+    return nFailed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
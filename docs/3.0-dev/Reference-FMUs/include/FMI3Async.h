@@ -0,0 +1,72 @@
+#ifndef FMI3ASYNC_H
+#define FMI3ASYNC_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI3.h"
+
+/* Asynchronous fmi3DoStep() on worker threads. The implementation uses POSIX threads
+   (pthreads) and is only built on UNIX-like systems. */
+
+typedef struct FMI3StepGroup_ FMI3StepGroup;
+
+typedef struct FMI3StepWorker_ FMI3StepWorker;
+
+typedef struct FMI3StepFuture_ FMI3StepFuture;
+
+/* Create a group of workers that signal the completion of their steps to the threads that
+   wait for the futures of the group (e.g. the master of one simulation). */
+FMI_STATIC FMI3StepGroup *FMI3CreateStepGroup(void);
+
+/* Free a group. The workers of the group must have been freed before. */
+FMI_STATIC void FMI3FreeStepGroup(FMI3StepGroup *group);
+
+/* Create a worker thread in group that calls fmi3DoStep() for a Co-Simulation instance.
+   While a step is in progress the instance must not be used by any other thread. */
+FMI_STATIC FMI3StepWorker *FMI3CreateStepWorker(FMI3StepGroup *group, FMIInstance *instance);
+
+/* Wait for the step in progress (if any) and stop the worker thread. The instance is
+   not freed. */
+FMI_STATIC void FMI3FreeStepWorker(FMI3StepWorker *worker);
+
+/* Dispatch fmi3DoStep() to the worker and return without waiting for the step. The
+   returned future belongs to the worker and is re-used by the next step, so a worker
+   can have only one step in progress. Returns NULL if the previous step has not
+   completed yet. */
+FMI_STATIC FMI3StepFuture *FMI3DoStepAsync(FMI3StepWorker *worker,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 communicationStepSize,
+    fmi3Boolean noSetFMUStatePriorToCurrentPoint);
+
+/* Wait until the step has completed and return the status and outputs of fmi3DoStep()
+   (the outputs may be NULL). */
+FMI_STATIC FMIStatus FMI3WaitStep(FMI3StepFuture *future,
+    fmi3Boolean *eventHandlingNeeded,
+    fmi3Boolean *terminateSimulation,
+    fmi3Boolean *earlyReturn,
+    fmi3Float64 *lastSuccessfulTime);
+
+/* Wait until all steps have completed and return the maximum status. NULL entries of
+   futures are skipped. Returns FMIError if the futures belong to different groups. */
+FMI_STATIC FMIStatus FMI3WaitAll(FMI3StepFuture *futures[], size_t nFutures);
+
+/* Wait until any of the steps has completed and return its index and status. NULL
+   entries of futures are skipped, so the caller can remove the futures it has already
+   handled. Returns FMIError if all entries are NULL or the futures belong to different
+   groups. */
+FMI_STATIC FMIStatus FMI3WaitAny(FMI3StepFuture *futures[], size_t nFutures, size_t *index);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMI3ASYNC_H
@@ -0,0 +1,86 @@
+#ifndef FMI3CLOCKSCHEDULER_H
+#define FMI3CLOCKSCHEDULER_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI3.h"
+
+typedef struct {
+    FMIInstance *instance;
+    fmi3ValueReference clockReference;
+    fmi3Int32 priority;
+    fmi3Float64 time;
+    fmi3Float64 interval; /* interval of a periodic clock, 0 for a single activation */
+    void *userData;
+} FMI3ClockEvent;
+
+/* A priority queue of clock activations of any number of instances. Events are ordered
+   by time, priority (lower value = higher priority) and the order they have been added.
+   Retrieving the next event takes O(log n). The scheduler is not thread-safe. */
+typedef struct FMI3ClockScheduler_ FMI3ClockScheduler;
+
+FMI_STATIC FMI3ClockScheduler *FMI3CreateClockScheduler(void);
+
+FMI_STATIC void FMI3FreeClockScheduler(FMI3ClockScheduler *scheduler);
+
+/* Remove all events */
+FMI_STATIC void FMI3ClockSchedulerClear(FMI3ClockScheduler *scheduler);
+
+/* Add a clock that ticks at firstTime + k * interval. The same clock can be added more than
+   once, e.g. with different shifts. */
+FMI_STATIC FMIStatus FMI3ClockSchedulerAddPeriodicClock(FMI3ClockScheduler *scheduler,
+    FMIInstance *instance,
+    fmi3ValueReference clockReference,
+    fmi3Int32 priority,
+    fmi3Float64 interval,
+    fmi3Float64 firstTime,
+    void *userData);
+
+/* Add a single activation of a triggered or countdown clock */
+FMI_STATIC FMIStatus FMI3ClockSchedulerAddEvent(FMI3ClockScheduler *scheduler,
+    FMIInstance *instance,
+    fmi3ValueReference clockReference,
+    fmi3Int32 priority,
+    fmi3Float64 time,
+    void *userData);
+
+/* Retrieve the intervals of the countdown clocks with fmi3GetIntervalDecimal() (e.g. in the
+   intermediateUpdate callback) and add an activation at time + interval for every clock whose
+   qualifier is fmi3IntervalChanged. userData holds the userData of the activations of the
+   clocks (NULL = no userData). */
+FMI_STATIC FMIStatus FMI3ClockSchedulerUpdateCountdownClocks(FMI3ClockScheduler *scheduler,
+    FMIInstance *instance,
+    const fmi3ValueReference clockReferences[],
+    const fmi3Int32 priorities[],
+    void *const userData[],
+    size_t nClocks,
+    fmi3Float64 time);
+
+/* Time of the next event (INFINITY if there is none) */
+FMI_STATIC fmi3Float64 FMI3ClockSchedulerNextTime(const FMI3ClockScheduler *scheduler);
+
+/* Remove the next event if it is due at time and re-schedule it if the clock is periodic.
+   Returns false if there is no such event. */
+FMI_STATIC bool FMI3ClockSchedulerPop(FMI3ClockScheduler *scheduler, fmi3Float64 time, FMI3ClockEvent *event);
+
+/* Read the priorities of the clocks from the <Clock> elements of a modelDescription.xml.
+   Returns FMIError if the file cannot be read or a clock or its priority is missing. */
+FMI_STATIC FMIStatus FMI3ReadClockPriorities(const char *path,
+    const fmi3ValueReference clockReferences[],
+    fmi3Int32 priorities[],
+    size_t nClocks);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMI3CLOCKSCHEDULER_H
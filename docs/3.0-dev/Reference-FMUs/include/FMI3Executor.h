@@ -0,0 +1,121 @@
+#ifndef FMI3EXECUTOR_H
+#define FMI3EXECUTOR_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI3.h"
+
+typedef FMIStatus FMI3TaskCallback(FMIInstance *instance, fmi3ValueReference clockReference, fmi3Float64 activationTime, void *userData);
+
+typedef struct {
+
+    /* value reference and priority of the input clock as declared in the modelDescription.xml */
+    fmi3ValueReference clockReference;
+    fmi3Int32 priority;
+
+    /* interval and shift of a periodic clock in seconds
+       (interval = 0: the clock is activated with FMI3ExecutorTrigger()) */
+    fmi3Float64 interval;
+    fmi3Float64 shift;
+
+    /* called on the thread of the task before and after fmi3ActivateModelPartition()
+       to set the inputs and get the outputs of the model partition (may be NULL) */
+    FMI3TaskCallback *beforeActivation;
+    FMI3TaskCallback *afterActivation;
+    void *userData;
+
+    /* execution time of the model partition in seconds (only used by FMI3VirtualExecutor) */
+    fmi3Float64 executionTime;
+
+} FMI3ExecutorTask;
+
+typedef struct {
+    fmi3ValueReference clockReference;
+    fmi3Int32 priority;
+    fmi3Float64 activationTime;
+    /* CLOCK_MONOTONIC time in seconds */
+    double releaseTime;
+    double startTime;
+    double finishTime;
+} FMI3ActivationRecord;
+
+typedef void FMI3ActivationCallback(const FMI3ActivationRecord *record, void *userData);
+
+typedef struct {
+
+    /* CPU the threads are pinned to (-1 = no pinning) */
+    int cpu;
+
+    /* run the tasks with SCHED_FIFO (requires CAP_SYS_NICE, otherwise the executor
+       falls back to SCHED_OTHER) */
+    bool realTime;
+
+    /* SCHED_FIFO priority of the task with the highest clock priority (0 = sched_get_priority_max() - 1).
+       The timer thread runs one level above, the other tasks one level below per clock priority. */
+    int maxPriority;
+
+    /* wall-clock seconds per second of simulation time (0 = 1) */
+    fmi3Float64 timeScale;
+
+    /* called on the thread of the task after every activation (may be NULL) */
+    FMI3ActivationCallback *activationFinished;
+    void *userData;
+
+} FMI3ExecutorSettings;
+
+typedef struct {
+    size_t nActivations;
+    size_t nOverruns;     /* activations that have been released before the previous one had finished */
+    size_t nDropped;      /* activations that have been dropped because too many were pending */
+    double maxLatency;    /* maximum delay between the release and the start of an activation in seconds */
+    double maxExecutionTime;
+} FMI3TaskStatistics;
+
+typedef struct FMI3Executor_ FMI3Executor;
+
+/* Create an executor that activates the model partitions of a Scheduled Execution
+   instance on one thread per task. The activations are released in the order of an
+   FMI3ClockScheduler. The instance must be in Clock Activation Mode and
+   must have been instantiated with FMI3ExecutorLockPreemption() and
+   FMI3ExecutorUnlockPreemption(). Only one executor can exist at a time. */
+FMI_STATIC FMI3Executor *FMI3CreateExecutor(FMIInstance *instance,
+    const FMI3ExecutorTask tasks[],
+    size_t nTasks,
+    const FMI3ExecutorSettings *settings);
+
+FMI_STATIC void FMI3FreeExecutor(FMI3Executor *executor);
+
+/* Release the periodic tasks in real time until stopTime and wait for all activations
+   to finish. Returns the worst status of the activations and the callbacks. */
+FMI_STATIC FMIStatus FMI3ExecutorRun(FMI3Executor *executor, fmi3Float64 startTime, fmi3Float64 stopTime);
+
+/* Activate the model partition of a triggered or countdown clock at activationTime
+   (e.g. from the intermediateUpdate callback). Can be called from any thread. */
+FMI_STATIC FMIStatus FMI3ExecutorTrigger(FMI3Executor *executor, fmi3ValueReference clockReference, fmi3Float64 activationTime);
+
+/* Whether the tasks run with SCHED_FIFO */
+FMI_STATIC bool FMI3ExecutorIsRealTime(const FMI3Executor *executor);
+
+FMI_STATIC FMIStatus FMI3ExecutorGetStatistics(FMI3Executor *executor, fmi3ValueReference clockReference, FMI3TaskStatistics *statistics);
+
+/* Callbacks for fmi3InstantiateScheduledExecution(). The critical sections are serialized
+   with a recursive priority inheritance futex. An uncontended lock / unlock is a single
+   atomic compare-and-swap, a thread that blocks on the lock raises the owner to its priority. */
+FMI_STATIC void FMI3ExecutorLockPreemption(void);
+
+FMI_STATIC void FMI3ExecutorUnlockPreemption(void);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMI3EXECUTOR_H
@@ -0,0 +1,80 @@
+#ifndef FMI3MEDRIVER_H
+#define FMI3MEDRIVER_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI3.h"
+
+/* time of the next input event after time (INFINITY = no more input events) */
+typedef fmi3Float64 FMI3MEInputEventTimeCallback(fmi3Float64 time, void *userData);
+
+/* set the continuous inputs at instance->time (afterEvent: the values at the right limit of an input event) */
+typedef FMIStatus FMI3MEContinuousInputsCallback(FMIInstance *instance, bool afterEvent, void *userData);
+
+/* set the discrete inputs at instance->time */
+typedef FMIStatus FMI3MEDiscreteInputsCallback(FMIInstance *instance, void *userData);
+
+/* retrieve the outputs at instance->time */
+typedef FMIStatus FMI3MERecordCallback(FMIInstance *instance, void *userData);
+
+typedef struct {
+
+    fmi3Float64 startTime;
+    fmi3Float64 stopTime;
+
+    /* step size of the forward Euler method. The steps are shortened to end at time
+       and input events. */
+    fmi3Float64 fixedStep;
+
+    /* number of continuous states and event indicators */
+    size_t nx;
+    size_t nz;
+
+    /* maximum width of the interval that contains a state event
+       (0 = 1e-12 * max(1, |time|)) */
+    fmi3Float64 eventTolerance;
+
+    /* maximum number of iterations to locate a state event (0 = 100) */
+    size_t maxEventIterations;
+
+    /* callbacks (may be NULL) */
+    FMI3MEInputEventTimeCallback *nextInputEventTime;
+    FMI3MEContinuousInputsCallback *applyContinuousInputs;
+    FMI3MEDiscreteInputsCallback *applyDiscreteInputs;
+    FMI3MERecordCallback *recordVariables;
+    void *userData;
+
+} FMI3MESettings;
+
+typedef struct {
+    size_t nSteps;
+    size_t nTimeEvents;
+    size_t nInputEvents;
+    size_t nStateEvents;
+    size_t nStepEvents;
+    size_t nEventIterations;          /* iterations to locate the state events */
+    size_t nEventIndicatorEvaluations;
+} FMI3MEStatistics;
+
+/* Initialize a Model Exchange instance and integrate it with the forward Euler method
+   from startTime to stopTime. The instance must have been instantiated and the start
+   values must have been applied. State events are located with the Illinois method on
+   the event indicators of the states interpolated between two steps. The step ends at
+   the right limit of the located interval. statistics may be NULL. The caller has to
+   terminate the instance. */
+FMI_STATIC FMIStatus FMI3MESimulate(FMIInstance *instance, const FMI3MESettings *settings, FMI3MEStatistics *statistics);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMI3MEDRIVER_H
@@ -0,0 +1,109 @@
+#ifndef FMI3MASTER_H
+#define FMI3MASTER_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI3.h"
+
+typedef struct {
+    size_t            sourceInstance;
+    FMIValueReference sourceValueReference;
+    size_t            targetInstance;
+    FMIValueReference targetValueReference;
+    FMIVariableType   type;
+} FMI3Connection;
+
+typedef enum {
+    FMI3JacobiCoupling,
+    FMI3GaussSeidelCoupling
+} FMI3CouplingScheme;
+
+typedef enum {
+    FMI3ExtrapolationErrorEstimator,
+    FMI3StepDoublingErrorEstimator
+} FMI3ErrorEstimator;
+
+typedef struct FMI3Master_ FMI3Master;
+
+/* Create a master that steps the Co-Simulation instances with a Jacobi coupling scheme
+   on nThreads threads (including the calling thread, 0 = number of processors).
+   The instances must be in Step Mode. Connections are between variables of type
+   FMIFloat32Type, FMIFloat64Type, FMIInt32Type or FMIBooleanType. The values of the
+   connections are transferred with one Get per source and one Set per target and type. */
+FMI_STATIC FMI3Master *FMI3CreateMaster(FMIInstance *instances[],
+    size_t nInstances,
+    const FMI3Connection connections[],
+    size_t nConnections,
+    size_t nThreads);
+
+FMI_STATIC void FMI3FreeMaster(FMI3Master *master);
+
+/* With FMI3GaussSeidelCoupling the instances are stepped in the order of the connections.
+   Strongly connected instances are stepped one after the other and independent groups of
+   instances in parallel. Algebraic loops are solved with a Newton iteration that rolls
+   back the instances with fmi3GetFMUState() / fmi3SetFMUState(). */
+FMI_STATIC FMIStatus FMI3MasterSetCouplingScheme(FMI3Master *master, FMI3CouplingScheme couplingScheme);
+
+/* Declare the inputs the output of an instance depends on directly. For outputs without
+   declaration the master calls fmi3GetVariableDependencies() once per output. If the
+   instance does not implement it, the master reads the dependencies of all outputs from
+   the model description (see FMI3MasterSetModelDescription()) and assumes that the
+   outputs that are not listed there depend on all inputs. */
+FMI_STATIC FMIStatus FMI3MasterSetDependencies(FMI3Master *master,
+    size_t instance,
+    FMIValueReference output,
+    const FMIValueReference inputs[],
+    size_t nInputs);
+
+/* Set the path of the modelDescription.xml of an instance. The dependencies in its
+   <ModelStructure> are used if the instance does not implement fmi3GetVariableDependencies(). */
+FMI_STATIC FMIStatus FMI3MasterSetModelDescription(FMI3Master *master, size_t instance, const char *path);
+
+/* Set the relative tolerance (default 1e-8) and the maximum number of iterations
+   (default 20) to solve algebraic loops */
+FMI_STATIC FMIStatus FMI3MasterSetLoopSolverParameters(FMI3Master *master, fmi3Float64 tolerance, size_t maxIterations);
+
+FMI_STATIC FMIStatus FMI3MasterDoStep(FMI3Master *master,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 communicationStepSize,
+    fmi3Boolean *terminateSimulation);
+
+/* Set the estimator and the tolerances of the coupling error and the limits of the communication
+   step size for FMI3MasterDoVariableStep() (defaults: FMI3ExtrapolationErrorEstimator, 1e-6, 1e-4,
+   1e-10, DBL_MAX). FMI3ExtrapolationErrorEstimator compares the outputs at the end of the step
+   to the values the inputs have been held at during the step. FMI3StepDoublingErrorEstimator
+   compares the outputs after one step of size h to the outputs after two steps of size h / 2. */
+FMI_STATIC FMIStatus FMI3MasterSetStepSizeControl(FMI3Master *master,
+    FMI3ErrorEstimator errorEstimator,
+    fmi3Float64 absoluteTolerance,
+    fmi3Float64 relativeTolerance,
+    fmi3Float64 minStepSize,
+    fmi3Float64 maxStepSize);
+
+/* Do a communication step with error control. Rejected steps are rolled back with
+   fmi3GetFMUState() / fmi3SetFMUState() and repeated with a smaller step size.
+   Returns the step size that has been taken and a proposal for the next step.
+   A proposed step size below the minimum step size is taken without error control,
+   so the last step can end exactly at the stop time.
+   The instances must support fmi3GetFMUState() and fmi3SetFMUState(). */
+FMI_STATIC FMIStatus FMI3MasterDoVariableStep(FMI3Master *master,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 proposedStepSize,
+    fmi3Float64 *communicationStepSize,
+    fmi3Float64 *nextStepSize,
+    fmi3Boolean *terminateSimulation);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMI3MASTER_H
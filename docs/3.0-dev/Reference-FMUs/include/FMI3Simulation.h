@@ -0,0 +1,103 @@
+#ifndef FMI3SIMULATION_H
+#define FMI3SIMULATION_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+#include "FMI3.h"
+
+/* Provides the start values and inputs of a simulation. All callbacks may be NULL. */
+typedef struct {
+
+    /* set the start values after the instantiation */
+    FMIStatus (*applyStartValues)(FMIInstance *instance, void *userData);
+
+    /* time of the next input event after time (INFINITY = no more input events) */
+    fmi3Float64 (*nextInputEventTime)(fmi3Float64 time, void *userData);
+
+    /* set the continuous inputs at instance->time (afterEvent: the values at the right limit of an input event) */
+    FMIStatus (*applyContinuousInputs)(FMIInstance *instance, bool afterEvent, void *userData);
+
+    /* set the discrete inputs at instance->time */
+    FMIStatus (*applyDiscreteInputs)(FMIInstance *instance, void *userData);
+
+    void *userData;
+
+} FMI3InputProvider;
+
+/* Receives the results of a simulation. The callback may be NULL. */
+typedef struct {
+
+    /* retrieve the outputs at instance->time */
+    FMIStatus (*recordVariables)(FMIInstance *instance, void *userData);
+
+    void *userData;
+
+} FMI3ResultSink;
+
+typedef struct {
+
+    const char *instanceName;
+    const char *libraryPath;
+    const char *instantiationToken;
+    const char *resourcePath;
+
+    /* FMIModelExchange or FMICoSimulation */
+    FMIInterfaceType interfaceType;
+
+    fmi3Float64 startTime;
+    fmi3Float64 stopTime;
+
+    /* communication step size (Co-Simulation) or step size of the forward Euler
+       method (Model Exchange) */
+    fmi3Float64 stepSize;
+
+    /* number of continuous states and event indicators (Model Exchange) */
+    size_t nx;
+    size_t nz;
+
+    fmi3Boolean loggingOn;
+
+    /* callback for the log messages of the instance (may be NULL) */
+    FMILogMessage *logMessage;
+
+    /* file to log the FMI calls to (may be NULL, must not be shared between
+       concurrent simulations) */
+    FILE *logFile;
+
+    FMI3InputProvider inputs;
+    FMI3ResultSink results;
+
+} FMI3SimulationSettings;
+
+typedef struct {
+    size_t nSteps;
+    size_t nTimeEvents;
+    size_t nStateEvents;
+    size_t nEventIterations;
+    size_t nStepEvents;
+    bool terminated;  /* the FMU requested to terminate the simulation (Co-Simulation) */
+} FMI3SimulationStatistics;
+
+/* Load the FMU, instantiate it, apply the start values and simulate it from startTime
+   to stopTime. The state of the simulation is kept in a context on the stack and the
+   FMI calls are logged through the instance, so any number of simulations can run
+   concurrently in different threads as long as the callbacks are thread-safe. The
+   instance is terminated and freed before the function returns. statistics may be NULL. */
+FMI_STATIC FMIStatus FMI3Simulate(const FMI3SimulationSettings *settings, FMI3SimulationStatistics *statistics);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMI3SIMULATION_H
@@ -0,0 +1,79 @@
+#ifndef FMI3SWEEP_H
+#define FMI3SWEEP_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI3.h"
+
+typedef enum {
+
+    /* re-initialize the instances with fmi3Reset() before every run */
+    FMI3SweepReset,
+
+    /* restore the instances from an FMU state that has been retrieved after
+       the initialization (the parameters of the sweep must be tunable) */
+    FMI3SweepRestoreFMUState
+
+} FMI3SweepMode;
+
+typedef struct {
+
+    const char *libraryPath;
+    const char *instantiationToken;
+
+    /* callback for the log messages of the instances (may be NULL) */
+    FMILogMessage *logMessage;
+
+    fmi3Float64 startTime;
+    fmi3Float64 stopTime;
+    fmi3Float64 communicationStepSize;
+
+    /* Float64 variables that are set before every run */
+    const fmi3ValueReference *parameters;
+    size_t nParameters;
+
+    /* Float64 variables that are retrieved at the end of every run */
+    const fmi3ValueReference *outputs;
+    size_t nOutputs;
+
+    FMI3SweepMode mode;
+
+    /* number of worker threads (0 = number of processors) */
+    size_t nThreads;
+
+} FMI3SweepSettings;
+
+typedef struct {
+    size_t nRuns;
+    size_t nFailedRuns;
+    size_t nThreads;
+    size_t nStolenRuns;
+    double elapsedTime;
+} FMI3SweepStatistics;
+
+/* Simulate the Co-Simulation FMU for every row of parameterValues (nRuns x nParameters)
+   on a pool of worker threads that steal runs from each other. Every worker owns one
+   instance that is re-used for all of its runs. The final values of the outputs are
+   written column by column to outputValues (nOutputs x nRuns) and the status of every
+   run to runStatus (may be NULL). Returns FMIError if any of the runs has failed. */
+FMI_STATIC FMIStatus FMI3RunSweep(const FMI3SweepSettings *settings,
+    size_t nRuns,
+    const fmi3Float64 parameterValues[],
+    fmi3Float64 outputValues[],
+    FMIStatus runStatus[],
+    FMI3SweepStatistics *statistics);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMI3SWEEP_H
@@ -0,0 +1,72 @@
+#ifndef FMI3VIRTUALEXECUTOR_H
+#define FMI3VIRTUALEXECUTOR_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI3Executor.h"
+
+typedef struct {
+    fmi3ValueReference clockReference;
+    fmi3Float64 activationTime;
+    fmi3Float64 releaseTime;
+    fmi3Float64 startTime;
+    fmi3Float64 finishTime;
+    size_t nPreemptions;
+} FMI3VirtualJob;
+
+typedef void FMI3VirtualJobCallback(const FMI3VirtualJob *job, void *userData);
+
+typedef struct {
+    size_t nActivations;
+    size_t nPreemptions;
+    size_t nOverruns;       /* activations that have been released before the previous one had finished */
+    size_t nDropped;        /* activations that have been dropped because too many were pending */
+    size_t nDeadlineMisses; /* activations of periodic clocks with a response time above the interval */
+    fmi3Float64 maxLatency; /* maximum delay between the release and the start of an activation */
+    fmi3Float64 maxResponseTime;
+    fmi3Float64 totalResponseTime;
+} FMI3VirtualTaskStatistics;
+
+typedef struct FMI3VirtualExecutor_ FMI3VirtualExecutor;
+
+/* Create an executor that simulates the preemptive fixed-priority scheduling of the
+   model partitions on a single processor in virtual time. Every activation takes the
+   executionTime of its task. fmi3ActivateModelPartition() and beforeActivation are
+   called when the activation starts, afterActivation when it finishes, so the outputs
+   become visible after the execution time. The runs are deterministic and do not
+   depend on the wall-clock time. jobFinished is called for every finished activation
+   (may be NULL). The instance does not need lockPreemption / unlockPreemption. */
+FMI_STATIC FMI3VirtualExecutor *FMI3CreateVirtualExecutor(FMIInstance *instance,
+    const FMI3ExecutorTask tasks[],
+    size_t nTasks,
+    FMI3VirtualJobCallback *jobFinished,
+    void *userData);
+
+FMI_STATIC void FMI3FreeVirtualExecutor(FMI3VirtualExecutor *executor);
+
+/* Release the tasks until stopTime and finish the pending activations */
+FMI_STATIC FMIStatus FMI3VirtualExecutorRun(FMI3VirtualExecutor *executor, fmi3Float64 startTime, fmi3Float64 stopTime);
+
+/* Activate the model partition of a triggered or countdown clock at activationTime, e.g. from
+   the intermediateUpdate callback. Activations in the past are released at the current time. */
+FMI_STATIC FMIStatus FMI3VirtualExecutorTrigger(FMI3VirtualExecutor *executor, fmi3ValueReference clockReference, fmi3Float64 activationTime);
+
+/* Current virtual time */
+FMI_STATIC fmi3Float64 FMI3VirtualExecutorGetTime(const FMI3VirtualExecutor *executor);
+
+FMI_STATIC FMIStatus FMI3VirtualExecutorGetStatistics(FMI3VirtualExecutor *executor, fmi3ValueReference clockReference, FMI3VirtualTaskStatistics *statistics);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMI3VIRTUALEXECUTOR_H
@@ -0,0 +1,55 @@
+#ifndef FMIINPUTTABLE_H
+#define FMIINPUTTABLE_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI.h"
+
+typedef struct FMIInputTable_ FMIInputTable;
+
+/* Map an input table into memory. The file can be a CSV file with the column names in
+   the first line or a MAT v4 file written by FMIRecorder. The first column is the time,
+   which must not decrease. Two consecutive rows with the same time define a
+   discontinuity. Only the times are indexed when the table is opened, so the values
+   are read from the mapped file on demand.
+
+   The columns in discreteColumns hold their value until the next row. All other
+   columns are interpolated linearly. Rows with the same time and changes of the
+   discrete columns are input events. */
+FMI_STATIC FMIInputTable *FMIOpenInputTable(const char *filename, const char *discreteColumns[], size_t nDiscreteColumns);
+
+FMI_STATIC void FMICloseInputTable(FMIInputTable *table);
+
+FMI_STATIC size_t FMIInputTableRowCount(const FMIInputTable *table);
+
+/* Find the index of a column (0 = time) */
+FMI_STATIC bool FMIInputTableFindColumn(const FMIInputTable *table, const char *name, size_t *column);
+
+/* First input event at or after time (INFINITY = no more input events) */
+FMI_STATIC double FMIInputTableNextEventTime(FMIInputTable *table, double time);
+
+/* Get the values of the columns at time. At a discontinuity the values of the first
+   row are returned, or of the last row if afterEvent is true. Before the first and
+   after the last row the values are extrapolated as constants. Consecutive calls with
+   increasing times are answered from a cursor without a binary search. */
+FMI_STATIC FMIStatus FMIInputTableGetValues(FMIInputTable *table,
+    double time,
+    bool afterEvent,
+    const size_t columns[],
+    size_t nColumns,
+    double values[]);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMIINPUTTABLE_H
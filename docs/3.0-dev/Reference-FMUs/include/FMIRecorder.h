@@ -0,0 +1,65 @@
+#ifndef FMIRECORDER_H
+#define FMIRECORDER_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI.h"
+
+typedef struct {
+
+    /* record only every n-th sample between two events (0 = every sample) */
+    size_t decimation;
+
+    /* record only the samples at events */
+    bool eventsOnly;
+
+    /* size of a write buffer in bytes (0 = 1 MiB) */
+    size_t bufferSize;
+
+    /* number of write buffers (0 = 4) */
+    size_t nBuffers;
+
+} FMIRecorderSettings;
+
+typedef struct {
+    size_t nSamples;        /* samples passed to FMIRecorderSample() */
+    size_t nRecorded;       /* samples written to the file */
+    size_t nBuffersWritten;
+    size_t nWaits;          /* number of times FMIRecorderSample() had to wait for the writer thread */
+} FMIRecorderStatistics;
+
+typedef struct FMIRecorder_ FMIRecorder;
+
+/* Create a recorder that writes the samples to a MAT v4 file with the matrices "name"
+   (time and names as rows of a text matrix) and "data" (one column of doubles per sample,
+   i.e. nVariables + 1 rows). The samples are collected in large buffers that are written
+   by a background thread. */
+FMI_STATIC FMIRecorder *FMICreateRecorder(const char *filename,
+    const char *names[],
+    size_t nVariables,
+    const FMIRecorderSettings *settings);
+
+/* Add a sample. Samples with event = true (e.g. before and after an event or at the
+   stop time) are always recorded. */
+FMI_STATIC FMIStatus FMIRecorderSample(FMIRecorder *recorder, double time, const double values[], bool event);
+
+/* Write the remaining samples, close the file and free the recorder. statistics may be NULL. */
+FMI_STATIC FMIStatus FMIRecorderClose(FMIRecorder *recorder, FMIRecorderStatistics *statistics);
+
+/* Convert a file written by FMIRecorder to CSV */
+FMI_STATIC FMIStatus FMIRecorderExportCSV(const char *filename, const char *csvFilename);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMIRECORDER_H
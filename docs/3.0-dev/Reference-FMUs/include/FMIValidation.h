@@ -0,0 +1,73 @@
+#ifndef FMIVALIDATION_H
+#define FMIVALIDATION_H
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FMI.h"
+
+typedef struct {
+
+    /* tolerance relative to the maximum absolute value of the column */
+    double relTol;
+
+    /* absolute tolerance */
+    double absTol;
+
+    /* the tube around a reference sample includes the neighbouring samples within
+       timeTolerance (samples with the same time, e.g. at events, are always included) */
+    double timeTolerance;
+
+} FMIValidationSettings;
+
+typedef struct {
+
+    const char *name;
+
+    /* maximum deviation from the reference and its time */
+    double maxError;
+    double maxErrorTime;
+
+    /* samples outside the tolerance tube */
+    size_t nViolations;
+
+    /* first sample outside the tube (NAN if none) */
+    double firstViolationTime;
+    double firstViolationValue;
+    double firstViolationLower;
+    double firstViolationUpper;
+
+} FMIColumnValidation;
+
+typedef struct FMIReference_ FMIReference;
+
+/* Load a reference result (CSV with the column names in the first line and the time
+   in the first column) and compute the tolerance tube of every column. The reference
+   can be used to validate any number of results. */
+FMI_STATIC FMIReference *FMILoadReference(const char *filename, const FMIValidationSettings *settings);
+
+FMI_STATIC void FMIFreeReference(FMIReference *reference);
+
+/* number of columns without the time */
+FMI_STATIC size_t FMIReferenceColumnCount(const FMIReference *reference);
+
+/* Stream a result CSV file, resample its columns at the times of the reference by linear
+   interpolation and check them against the tolerance tubes. The columns are matched by
+   name. The samples of the reference after the end of the result are violations with
+   the value NAN. columns must have FMIReferenceColumnCount() elements. Returns FMIError
+   if the file cannot be read or a column is missing. */
+FMI_STATIC FMIStatus FMIValidateResult(FMIReference *reference, const char *filename, FMIColumnValidation columns[], bool *passed);
+
+#ifdef __cplusplus
+}  /* end of extern "C" { */
+#endif
+
+#endif // FMIVALIDATION_H
@@ -0,0 +1,61 @@
+#ifndef ensemble_h
+#define ensemble_h
+
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include "model.h"
+
+#if defined(_MSC_VER)
+#define restrict __restrict
+#endif
+
+// alignment of the arrays in bytes (one cache line, enough for AVX-512)
+#define ENSEMBLE_ALIGNMENT 64
+
+/* Structure-of-arrays ensemble of nInstances copies of a model that share the time
+   grid. Every Float64 variable is stored as an array over the instances at
+   variables + vr * stride, so the model equations can be evaluated for all
+   instances in one vectorizable loop. The models must define ENSEMBLE_N_VARIABLES,
+   ENSEMBLE_STATES, ENSEMBLE_DERIVATIVES and ENSEMBLE_STATE_NAMES in config.h. */
+typedef struct {
+
+    size_t nInstances;
+
+    // number of elements per variable (nInstances rounded up to the alignment)
+    size_t stride;
+
+    double time;
+    int nSteps;
+
+    double *variables;
+
+} Ensemble;
+
+// values of variable v of all instances
+#define E(v) (ensemble->variables + (size_t)(v) * ensemble->stride)
+
+Ensemble *createEnsemble(size_t nInstances);
+void freeEnsemble(Ensemble *ensemble);
+
+// to be implemented by the model
+void ensembleSetStartValues(Ensemble *ensemble);
+void ensembleCalculateValues(Ensemble *ensemble);
+
+// get or set the values of a variable of all instances
+Status ensembleGetFloat64(Ensemble *ensemble, ValueReference vr, double values[]);
+Status ensembleSetFloat64(Ensemble *ensemble, ValueReference vr, const double values[]);
+
+// continuous states and derivatives of all instances (NX x nInstances)
+void ensembleGetContinuousStates(Ensemble *ensemble, double x[]);
+void ensembleSetContinuousStates(Ensemble *ensemble, const double x[]);
+void ensembleGetDerivatives(Ensemble *ensemble, double dx[]);
+
+// forward Euler step with FIXED_SOLVER_STEP for all instances
+void ensembleDoFixedStep(Ensemble *ensemble);
+
+#endif /* ensemble_h */
@@ -82,6 +82,85 @@ typedef enum {
     Pending
 } Status;
 
+// minimum time between two intermediate updates in Co-Simulation (events are always reported)
+#ifndef INTERMEDIATE_UPDATE_INTERVAL
+#define INTERMEDIATE_UPDATE_INTERVAL 0
+#endif
+
+// maximum number of time events the model can schedule (see scheduleTimeEvent())
+#ifndef N_TIME_EVENTS
+#define N_TIME_EVENTS 0
+#endif
+
+#if N_TIME_EVENTS > 0
+
+typedef struct {
+    double time;
+    size_t id;
+} TimeEvent;
+
+// binary min-heap of the scheduled time events ordered by time and id
+typedef struct {
+    size_t nEvents;
+    TimeEvent events[N_TIME_EVENTS];
+    size_t positions[N_TIME_EVENTS]; // index of the event with the id in events (N_TIME_EVENTS if not scheduled)
+} TimeEventQueue;
+
+#endif
+
+typedef enum {
+    LogEvents      = 1 << 0,
+    LogStatusError = 1 << 1
+} LogCategory;
+
+// size of the scratch buffer for log messages (grows for longer messages)
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 1024
+#endif
+
+#ifdef DEFERRED_LOGGING
+
+// number of event log records that are kept until they are formatted
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 256
+#endif
+
+// maximum number of arguments of a deferred message (messages with more arguments are
+// formatted immediately)
+#define LOG_RECORD_MAX_ARGS 8
+
+// size of the copies of the string arguments of a record (including the terminating
+// zeros). Messages whose strings do not fit are formatted immediately.
+#define LOG_RECORD_TEXT_SIZE 64
+
+typedef union {
+    int i;
+    unsigned int u;
+    long l;
+    unsigned long ul;
+    long long ll;
+    unsigned long long ull;
+    size_t z;
+    intmax_t j;
+    ptrdiff_t t;
+    double d;
+    long double ld;
+    const void *p;
+    size_t offset; // of a string in the text of the record
+} LogArgument;
+
+// a log message whose arguments have been captured but not formatted
+typedef struct {
+    int status;
+    const char *category;
+    const char *message; // must remain valid, e.g. a string literal
+    size_t nArgs;
+    LogArgument args[LOG_RECORD_MAX_ARGS];
+    char text[LOG_RECORD_TEXT_SIZE];
+} LogRecord;
+
+#endif
+
 #if FMI_VERSION < 3
 typedef void (*loggerType) (void *componentEnvironment, const char *instanceName, int status, const char *category, const char *message, ...);
 #else
@@ -101,6 +180,9 @@ typedef void (*intermediateUpdateType) (void *instanceEnvironment,
                                         bool *earlyReturnRequested,
                                         double *earlyReturnTime);
 
+// a file in the resources directory that is mapped into memory
+typedef struct ResourceFile_ ResourceFile;
+
 typedef struct {
 
     double time;
@@ -108,6 +190,13 @@ typedef struct {
     InterfaceType type;
     const char *resourceLocation;
 
+    // file system path of the resources directory with a trailing separator (NULL if unknown)
+    const char *resourcePath;
+
+    // resource files used by this instance
+    ResourceFile **resources;
+    size_t nResources;
+
     Status status;
 
     // callback functions
@@ -117,8 +206,20 @@ typedef struct {
     lockPreemptionType lockPreemtion;
     unlockPreemptionType unlockPreemtion;
 
-    bool logEvents;
-    bool logErrors;
+    // bitmask of the enabled LogCategory values
+    unsigned int logCategories;
+
+    // scratch buffer for the formatted log messages
+    char *logBuffer;
+    size_t logBufferSize;
+
+#ifdef DEFERRED_LOGGING
+    // ring of the event log records that have not been formatted yet
+    LogRecord *logRecords;
+    size_t logRecordsStart;
+    size_t nLogRecords;
+    size_t nDroppedLogRecords;
+#endif
 
     void *componentEnvironment;
     ModelState state;
@@ -137,10 +238,22 @@ typedef struct {
 
     ModelData *modelData;
 
+    // number of elements of the values of the current get or set call
+    size_t nValues;
+
     // event indicators
     double *z;
     double *prez;
 
+#if N_TIME_EVENTS > 0
+    // the earliest event sets nextEventTime (see updateNextEventTime())
+    TimeEventQueue timeEvents;
+#endif
+
+    // continuous states and derivatives of the fixed step solver
+    double *x;
+    double *dx;
+
     // internal solver steps
     int nSteps;
 
@@ -148,6 +261,14 @@ typedef struct {
     bool earlyReturnAllowed;
     bool eventModeUsed;
 
+    // variables the importer wants to get in the intermediate update
+    uint32_t *requiredIntermediateVariables;
+    size_t nRequiredIntermediateVariables;
+
+    // minimum time between two intermediate updates without events
+    double intermediateUpdateInterval;
+    double lastIntermediateUpdateTime;
+
 } ModelInstance;
 
 ModelInstance *createModelInstance(
@@ -193,6 +314,20 @@ void getDerivatives(ModelInstance *comp, double dx[], size_t nx);
 Status getPartialDerivative(ModelInstance *comp, ValueReference unknown, ValueReference known, double *partialDerivative);
 void getEventIndicators(ModelInstance *comp, double z[], size_t nz);
 void eventUpdate(ModelInstance *comp);
+
+// time events with the ids 0..N_TIME_EVENTS-1 that are scheduled and cancelled in O(log n)
+#if N_TIME_EVENTS > 0
+Status scheduleTimeEvent(ModelInstance *comp, size_t id, double time);
+void cancelTimeEvent(ModelInstance *comp, size_t id);
+bool popTimeEvent(ModelInstance *comp, size_t *id, double *time);
+#endif
+void clearTimeEvents(ModelInstance *comp);
+void updateNextEventTime(ModelInstance *comp);
+Status copyModelData(ModelInstance *comp, ModelData *dst, const ModelData *src);
+void freeModelData(ModelData *data);
+size_t serializedModelDataSize(const ModelData *data);
+void serializeModelData(const ModelData *data, void *buffer);
+Status deserializeModelData(ModelInstance *comp, ModelData *data, const void *buffer, size_t size);
 //void updateEventTime(ModelInstance *comp);
 
 double epsilon(double value);
@@ -200,9 +335,12 @@ bool invalidNumber(ModelInstance *comp, const char *f, const char *arg, size_t a
 bool invalidState(ModelInstance *comp, const char *f, int statesExpected);
 bool nullPointer(ModelInstance* comp, const char *f, const char *arg, const void *p);
 void logError(ModelInstance *comp, const char *message, ...);
+Status getResource(ModelInstance *comp, const char *name, const char **data, size_t *size);
+Status setRequiredIntermediateVariables(ModelInstance *comp, const uint32_t valueReferences[], size_t nValueReferences);
 Status setDebugLogging(ModelInstance *comp, bool loggingOn, size_t nCategories, const char * const categories[]);
 void logEvent(ModelInstance *comp, const char *message, ...);
 void logError(ModelInstance *comp, const char *message, ...);
+void flushLog(ModelInstance *comp);
 
 // shorthand to access the variables
 #define M(v) (comp->modelData->v)
@@ -25,6 +25,11 @@
 
 FMIInstance *FMICreateInstance(const char *instanceName, const char *libraryPath, FMILogMessage *logMessage, FMILogFunctionCall *logFunctionCall) {
 
+#if defined(FMI3_FUNCTION_PREFIX)
+    // the FMU is linked statically
+    (void)libraryPath;
+#else
+
 # ifdef _WIN32
     TCHAR Buffer[1024];
     GetCurrentDirectory(1024, Buffer);
@@ -56,9 +61,13 @@ FMIInstance *FMICreateInstance(const char *instanceName, const char *libraryPath
         return NULL;
     }
 
+#endif
+
     FMIInstance* instance = (FMIInstance*)calloc(1, sizeof(FMIInstance));
 
+#if !defined(FMI3_FUNCTION_PREFIX)
     instance->libraryHandle = libraryHandle;
+#endif
 
     instance->logMessage      = logMessage;
     instance->logFunctionCall = logFunctionCall;
@@ -92,6 +101,10 @@ void FMIFreeInstance(FMIInstance *instance) {
     free(instance->fmi2Functions);
     free(instance->fmi3Functions);
 
+    free(instance->buf1);
+    free(instance->buf2);
+    free((void *)instance->name);
+
     free(instance);
 }
 
@@ -19,6 +19,11 @@
 #include <stdio.h>
 #include <string.h>
 
+#if defined(FMI3_FUNCTION_PREFIX)
+// the FMU is linked statically and the prefixed functions are called directly
+#include "fmi3Functions.h"
+#endif
+
 #include "FMI3.h"
 
 
@@ -39,7 +44,7 @@ static void cb_logMessage3(fmi3InstanceEnvironment instanceEnvironment,
     instance->logMessage(instance, status, category, message);
 }
 
-#if defined(FMI2_FUNCTION_PREFIX)
+#if defined(FMI3_FUNCTION_PREFIX)
 #define LOAD_SYMBOL(f) \
     instance->fmi3Functions->fmi3 ## f = fmi3 ## f;
 #elif defined(_WIN32)
@@ -58,8 +63,15 @@ static void cb_logMessage3(fmi3InstanceEnvironment instanceEnvironment,
     }
 #endif
 
+#if defined(FMI3_FUNCTION_PREFIX)
+// call the statically linked function so the compiler can inline it (e.g. with LTO)
+#define FMI3_SYMBOL(f) fmi3 ## f
+#else
+#define FMI3_SYMBOL(f) instance->fmi3Functions->fmi3 ## f
+#endif
+
 #define CALL(f) \
-    fmi3Status status = instance->fmi3Functions->fmi3 ## f (instance->component); \
+    fmi3Status status = FMI3_SYMBOL(f)(instance->component); \
     if (instance->logFunctionCall) { \
         instance->logFunctionCall(instance, status, "fmi3" #f "()"); \
     } \
@@ -67,7 +79,7 @@ static void cb_logMessage3(fmi3InstanceEnvironment instanceEnvironment,
     return status;
 
 #define CALL_ARGS(f, m, ...) \
-    fmi3Status status = instance->fmi3Functions-> fmi3 ## f (instance->component, __VA_ARGS__); \
+    fmi3Status status = FMI3_SYMBOL(f)(instance->component, __VA_ARGS__); \
     if (instance->logFunctionCall) { \
         instance->logFunctionCall(instance, status, "fmi3" #f "(" m ")", __VA_ARGS__); \
     } \
@@ -75,7 +87,7 @@ static void cb_logMessage3(fmi3InstanceEnvironment instanceEnvironment,
     return status;
 
 #define CALL_ARRAY(s, t) \
-    fmi3Status status = instance->fmi3Functions->fmi3 ## s ## t(instance->component, valueReferences, nValueReferences, values, nValues); \
+    fmi3Status status = FMI3_SYMBOL(s ## t)(instance->component, valueReferences, nValueReferences, values, nValues); \
     if (instance->logFunctionCall) { \
         FMIValueReferencesToString(instance, valueReferences, nValueReferences); \
         FMIValuesToString(instance, nValues, values, FMI ## t ## Type); \
@@ -93,14 +105,14 @@ const char* FMI3GetVersion(FMIInstance *instance) {
     if (instance->logFunctionCall) {
         instance->logFunctionCall(instance, FMIOK, "fmi3GetVersion()");
     }
-    return instance->fmi3Functions->fmi3GetVersion();
+    return FMI3_SYMBOL(GetVersion)();
 }
 
 fmi3Status FMI3SetDebugLogging(FMIInstance *instance,
     fmi3Boolean loggingOn,
     size_t nCategories,
     const fmi3String categories[]) {
-    fmi3Status status = instance->fmi3Functions->fmi3SetDebugLogging(instance->component, loggingOn, nCategories, categories);
+    fmi3Status status = FMI3_SYMBOL(SetDebugLogging)(instance->component, loggingOn, nCategories, categories);
     if (instance->logFunctionCall) {
         FMIValuesToString(instance, nCategories, categories, FMIStringType);
         instance->logFunctionCall(instance, status, "fmi3SetDebugLogging(loggingOn=%d, nCategories=%zu, categories=%s)",
@@ -251,7 +263,7 @@ fmi3Status FMI3InstantiateModelExchange(
 
     fmi3CallbackLogMessage logMessage = instance->logMessage ? cb_logMessage3 : NULL;
 
-    instance->component = instance->fmi3Functions->fmi3InstantiateModelExchange(instance->name, instantiationToken, resourcePath, visible, loggingOn, instance, logMessage);
+    instance->component = FMI3_SYMBOL(InstantiateModelExchange)(instance->name, instantiationToken, resourcePath, visible, loggingOn, instance, logMessage);
 
     if (instance->logFunctionCall) {
         instance->logFunctionCall(instance, instance->component ? FMIOK : FMIError,
@@ -301,7 +313,7 @@ fmi3Status FMI3InstantiateCoSimulation(
 
     fmi3CallbackLogMessage logMessage = instance->logMessage ? cb_logMessage3 : NULL;
 
-    instance->component = instance->fmi3Functions->fmi3InstantiateCoSimulation(
+    instance->component = FMI3_SYMBOL(InstantiateCoSimulation)(
         instance->name,
         instantiationToken,
         resourcePath,
@@ -375,7 +387,7 @@ fmi3Status FMI3InstantiateScheduledExecution(
 
     fmi3CallbackLogMessage logMessage = instance->logMessage ? cb_logMessage3 : NULL;
 
-    instance->component = instance->fmi3Functions->fmi3InstantiateScheduledExecution(
+    instance->component = FMI3_SYMBOL(InstantiateScheduledExecution)(
         instance->name,
         instantiationToken,
         resourcePath,
@@ -431,7 +443,7 @@ fmi3Status FMI3InstantiateScheduledExecution(
 
 fmi3Status FMI3FreeInstance(FMIInstance *instance) {
 
-    instance->fmi3Functions->fmi3FreeInstance(instance->component);
+    FMI3_SYMBOL(FreeInstance)(instance->component);
 
     instance->component = NULL;
 
@@ -475,7 +487,7 @@ fmi3Status FMI3EnterEventMode(FMIInstance *instance,
     size_t nEventIndicators,
     fmi3Boolean timeEvent) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3EnterEventMode(instance->component, stepEvent, stateEvent, rootsFound, nEventIndicators, timeEvent);
+    fmi3Status status = FMI3_SYMBOL(EnterEventMode)(instance->component, stepEvent, stateEvent, rootsFound, nEventIndicators, timeEvent);
 
     if (instance->logFunctionCall) {
         FMIValuesToString(instance, nEventIndicators, rootsFound, FMIInt32Type);
@@ -601,7 +613,7 @@ fmi3Status FMI3GetBinary(FMIInstance *instance,
     fmi3Binary values[],
     size_t nValues) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3GetBinary(instance->component, valueReferences, nValueReferences, sizes, values, nValues);
+    fmi3Status status = FMI3_SYMBOL(GetBinary)(instance->component, valueReferences, nValueReferences, sizes, values, nValues);
 
     if (instance->logFunctionCall) {
         FMIValueReferencesToString(instance, valueReferences, nValueReferences);
@@ -723,7 +735,7 @@ fmi3Status FMI3SetBinary(FMIInstance *instance,
     const fmi3Binary values[],
     size_t nValues) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3SetBinary(instance->component, valueReferences, nValueReferences, sizes, values, nValues);
+    fmi3Status status = FMI3_SYMBOL(SetBinary)(instance->component, valueReferences, nValueReferences, sizes, values, nValues);
 
     if (instance->logFunctionCall) {
         FMIValueReferencesToString(instance, valueReferences, nValueReferences);
@@ -777,7 +789,7 @@ fmi3Status FMI3FreeFMUState(FMIInstance *instance, fmi3FMUState* FMUState) {
 fmi3Status FMI3SerializedFMUStateSize(FMIInstance *instance,
     fmi3FMUState  FMUState,
     size_t* size) {
-    fmi3Status status = instance->fmi3Functions->fmi3SerializedFMUStateSize(instance->component, FMUState, size);
+    fmi3Status status = FMI3_SYMBOL(SerializedFMUStateSize)(instance->component, FMUState, size);
     if (instance->logFunctionCall) {
         instance->logFunctionCall(instance, status, "fmi3SerializedFMUStateSize(FMUState=0x%p, size=%zu)", FMUState, *size);
     }
@@ -889,7 +901,7 @@ fmi3Status FMI3UpdateDiscreteStates(FMIInstance *instance,
     fmi3Boolean *nextEventTimeDefined,
     fmi3Float64 *nextEventTime) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3UpdateDiscreteStates(instance->component, discreteStatesNeedUpdate, terminateSimulation, nominalsOfContinuousStatesChanged, valuesOfContinuousStatesChanged, nextEventTimeDefined, nextEventTime);
+    fmi3Status status = FMI3_SYMBOL(UpdateDiscreteStates)(instance->component, discreteStatesNeedUpdate, terminateSimulation, nominalsOfContinuousStatesChanged, valuesOfContinuousStatesChanged, nextEventTimeDefined, nextEventTime);
 
     if (instance->logFunctionCall) {
         instance->logFunctionCall(instance, status,
@@ -914,7 +926,7 @@ fmi3Status FMI3CompletedIntegratorStep(FMIInstance *instance,
     fmi3Boolean* enterEventMode,
     fmi3Boolean* terminateSimulation) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3CompletedIntegratorStep(instance->component, noSetFMUStatePriorToCurrentPoint, enterEventMode, terminateSimulation);
+    fmi3Status status = FMI3_SYMBOL(CompletedIntegratorStep)(instance->component, noSetFMUStatePriorToCurrentPoint, enterEventMode, terminateSimulation);
 
     if (instance->logFunctionCall) {
         instance->logFunctionCall(instance, status,
@@ -935,7 +947,7 @@ fmi3Status FMI3SetContinuousStates(FMIInstance *instance,
     const fmi3Float64 continuousStates[],
     size_t nContinuousStates) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3SetContinuousStates(instance->component, continuousStates, nContinuousStates);
+    fmi3Status status = FMI3_SYMBOL(SetContinuousStates)(instance->component, continuousStates, nContinuousStates);
 
     if (instance->logFunctionCall) {
         FMIValuesToString(instance, nContinuousStates, continuousStates, FMIFloat64Type);
@@ -952,7 +964,7 @@ fmi3Status FMI3GetContinuousStateDerivatives(FMIInstance *instance,
     fmi3Float64 derivatives[],
     size_t nContinuousStates) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3GetContinuousStateDerivatives(instance->component, derivatives, nContinuousStates);
+    fmi3Status status = FMI3_SYMBOL(GetContinuousStateDerivatives)(instance->component, derivatives, nContinuousStates);
 
     if (instance->logFunctionCall) {
         FMIValuesToString(instance, nContinuousStates, derivatives, FMIFloat64Type);
@@ -968,7 +980,7 @@ fmi3Status FMI3GetEventIndicators(FMIInstance *instance,
     fmi3Float64 eventIndicators[],
     size_t nEventIndicators) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3GetEventIndicators(instance->component, eventIndicators, nEventIndicators);
+    fmi3Status status = FMI3_SYMBOL(GetEventIndicators)(instance->component, eventIndicators, nEventIndicators);
 
     if (instance->logFunctionCall) {
         FMIValuesToString(instance, nEventIndicators, eventIndicators, FMIFloat64Type);
@@ -984,7 +996,7 @@ fmi3Status FMI3GetContinuousStates(FMIInstance *instance,
     fmi3Float64 continuousStates[],
     size_t nContinuousStates) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3GetContinuousStates(instance->component, continuousStates, nContinuousStates);
+    fmi3Status status = FMI3_SYMBOL(GetContinuousStates)(instance->component, continuousStates, nContinuousStates);
 
     if (instance->logFunctionCall) {
         FMIValuesToString(instance, nContinuousStates, continuousStates, FMIFloat64Type);
@@ -1043,7 +1055,7 @@ fmi3Status FMI3DoStep(FMIInstance *instance,
     fmi3Boolean* earlyReturn,
     fmi3Float64* lastSuccessfulTime) {
 
-    fmi3Status status = instance->fmi3Functions->fmi3DoStep(instance->component, currentCommunicationPoint, communicationStepSize, noSetFMUStatePriorToCurrentPoint, eventEncountered, terminate, earlyReturn, lastSuccessfulTime);
+    fmi3Status status = FMI3_SYMBOL(DoStep)(instance->component, currentCommunicationPoint, communicationStepSize, noSetFMUStatePriorToCurrentPoint, eventEncountered, terminate, earlyReturn, lastSuccessfulTime);
 
     if (instance->logFunctionCall) {
         instance->logFunctionCall(instance, status,
@@ -1066,6 +1078,7 @@ fmi3Status FMI3ActivateModelPartition(FMIInstance *instance,
 }
 
 #undef LOAD_SYMBOL
+#undef FMI3_SYMBOL
 #undef CALL
 #undef CALL_ARGS
 #undef CALL_ARRAY
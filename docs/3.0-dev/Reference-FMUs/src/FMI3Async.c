@@ -0,0 +1,355 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "FMI3Async.h"
+
+
+// The completion of the steps is signaled on one condition variable per group, so
+// FMI3WaitAny() can wait for the futures of the workers of a group at once and a
+// completed step wakes only the threads that wait for the same group.
+struct FMI3StepGroup_ {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+};
+
+// protected by group->mutex
+struct FMI3StepFuture_ {
+    FMI3StepGroup *group;
+    bool running;
+    FMIStatus status;
+    fmi3Boolean eventHandlingNeeded;
+    fmi3Boolean terminateSimulation;
+    fmi3Boolean earlyReturn;
+    fmi3Float64 lastSuccessfulTime;
+};
+
+struct FMI3StepWorker_ {
+
+    FMIInstance *instance;
+
+    pthread_t thread;
+
+    // protects the request
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+
+    // request
+    bool requested;
+    bool stop;
+    fmi3Float64 currentCommunicationPoint;
+    fmi3Float64 communicationStepSize;
+    fmi3Boolean noSetFMUStatePriorToCurrentPoint;
+
+    FMI3StepFuture future;
+};
+
+static void *runWorker(void *arg) {
+
+    FMI3StepWorker *worker = arg;
+
+    pthread_mutex_lock(&worker->mutex);
+
+    for (;;) {
+
+        while (!worker->requested && !worker->stop) {
+            pthread_cond_wait(&worker->cond, &worker->mutex);
+        }
+
+        if (!worker->requested) {
+            break;
+        }
+
+        worker->requested = false;
+
+        const fmi3Float64 currentCommunicationPoint        = worker->currentCommunicationPoint;
+        const fmi3Float64 communicationStepSize            = worker->communicationStepSize;
+        const fmi3Boolean noSetFMUStatePriorToCurrentPoint = worker->noSetFMUStatePriorToCurrentPoint;
+
+        pthread_mutex_unlock(&worker->mutex);
+
+        fmi3Boolean eventHandlingNeeded = fmi3False;
+        fmi3Boolean terminateSimulation = fmi3False;
+        fmi3Boolean earlyReturn         = fmi3False;
+        fmi3Float64 lastSuccessfulTime  = currentCommunicationPoint;
+
+        const FMIStatus status = FMI3DoStep(worker->instance,
+            currentCommunicationPoint,
+            communicationStepSize,
+            noSetFMUStatePriorToCurrentPoint,
+            &eventHandlingNeeded,
+            &terminateSimulation,
+            &earlyReturn,
+            &lastSuccessfulTime);
+
+        FMI3StepGroup *group = worker->future.group;
+
+        pthread_mutex_lock(&group->mutex);
+
+        worker->future.status              = status;
+        worker->future.eventHandlingNeeded = eventHandlingNeeded;
+        worker->future.terminateSimulation = terminateSimulation;
+        worker->future.earlyReturn         = earlyReturn;
+        worker->future.lastSuccessfulTime  = lastSuccessfulTime;
+        worker->future.running             = false;
+
+        pthread_cond_broadcast(&group->cond);
+        pthread_mutex_unlock(&group->mutex);
+
+        pthread_mutex_lock(&worker->mutex);
+    }
+
+    pthread_mutex_unlock(&worker->mutex);
+
+    return NULL;
+}
+
+FMI3StepGroup *FMI3CreateStepGroup(void) {
+
+    FMI3StepGroup *group = calloc(1, sizeof(FMI3StepGroup));
+
+    if (!group) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&group->mutex, NULL);
+    pthread_cond_init(&group->cond, NULL);
+
+    return group;
+}
+
+void FMI3FreeStepGroup(FMI3StepGroup *group) {
+
+    if (!group) {
+        return;
+    }
+
+    pthread_mutex_destroy(&group->mutex);
+    pthread_cond_destroy(&group->cond);
+
+    free(group);
+}
+
+FMI3StepWorker *FMI3CreateStepWorker(FMI3StepGroup *group, FMIInstance *instance) {
+
+    if (!group || !instance) {
+        return NULL;
+    }
+
+    FMI3StepWorker *worker = calloc(1, sizeof(FMI3StepWorker));
+
+    if (!worker) {
+        return NULL;
+    }
+
+    worker->instance = instance;
+    worker->future.group = group;
+    worker->future.status = FMIOK;
+
+    pthread_mutex_init(&worker->mutex, NULL);
+    pthread_cond_init(&worker->cond, NULL);
+
+    if (pthread_create(&worker->thread, NULL, runWorker, worker) != 0) {
+        pthread_mutex_destroy(&worker->mutex);
+        pthread_cond_destroy(&worker->cond);
+        free(worker);
+        return NULL;
+    }
+
+    return worker;
+}
+
+void FMI3FreeStepWorker(FMI3StepWorker *worker) {
+
+    if (!worker) {
+        return;
+    }
+
+    FMI3WaitStep(&worker->future, NULL, NULL, NULL, NULL);
+
+    pthread_mutex_lock(&worker->mutex);
+    worker->stop = true;
+    pthread_cond_signal(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+
+    pthread_join(worker->thread, NULL);
+
+    pthread_mutex_destroy(&worker->mutex);
+    pthread_cond_destroy(&worker->cond);
+
+    free(worker);
+}
+
+FMI3StepFuture *FMI3DoStepAsync(FMI3StepWorker *worker,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 communicationStepSize,
+    fmi3Boolean noSetFMUStatePriorToCurrentPoint) {
+
+    FMI3StepGroup *group = worker->future.group;
+
+    pthread_mutex_lock(&group->mutex);
+
+    const bool running = worker->future.running;
+
+    worker->future.running = true;
+
+    pthread_mutex_unlock(&group->mutex);
+
+    if (running) {
+        if (worker->instance->logMessage) {
+            worker->instance->logMessage(worker->instance, FMIError, "error", "The previous step has not completed.");
+        }
+        return NULL;
+    }
+
+    pthread_mutex_lock(&worker->mutex);
+
+    worker->requested                        = true;
+    worker->currentCommunicationPoint        = currentCommunicationPoint;
+    worker->communicationStepSize            = communicationStepSize;
+    worker->noSetFMUStatePriorToCurrentPoint = noSetFMUStatePriorToCurrentPoint;
+
+    pthread_cond_signal(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+
+    return &worker->future;
+}
+
+FMIStatus FMI3WaitStep(FMI3StepFuture *future,
+    fmi3Boolean *eventHandlingNeeded,
+    fmi3Boolean *terminateSimulation,
+    fmi3Boolean *earlyReturn,
+    fmi3Float64 *lastSuccessfulTime) {
+
+    if (!future) {
+        return FMIError;
+    }
+
+    FMI3StepGroup *group = future->group;
+
+    pthread_mutex_lock(&group->mutex);
+
+    while (future->running) {
+        pthread_cond_wait(&group->cond, &group->mutex);
+    }
+
+    const FMIStatus status = future->status;
+
+    if (eventHandlingNeeded) *eventHandlingNeeded = future->eventHandlingNeeded;
+    if (terminateSimulation) *terminateSimulation = future->terminateSimulation;
+    if (earlyReturn)         *earlyReturn         = future->earlyReturn;
+    if (lastSuccessfulTime)  *lastSuccessfulTime  = future->lastSuccessfulTime;
+
+    pthread_mutex_unlock(&group->mutex);
+
+    return status;
+}
+
+// group of the non-NULL futures (NULL if there are none or they belong to different groups)
+static FMI3StepGroup *commonGroup(FMI3StepFuture *futures[], size_t nFutures) {
+
+    FMI3StepGroup *group = NULL;
+
+    for (size_t i = 0; i < nFutures; i++) {
+
+        if (!futures[i]) {
+            continue;
+        }
+
+        if (group && futures[i]->group != group) {
+            return NULL;
+        }
+
+        group = futures[i]->group;
+    }
+
+    return group;
+}
+
+FMIStatus FMI3WaitAll(FMI3StepFuture *futures[], size_t nFutures) {
+
+    FMIStatus status = FMIOK;
+
+    FMI3StepGroup *group = commonGroup(futures, nFutures);
+
+    if (!group) {
+        // no futures or futures of different groups
+        for (size_t i = 0; i < nFutures; i++) {
+            if (futures[i]) {
+                return FMIError;
+            }
+        }
+        return FMIOK;
+    }
+
+    pthread_mutex_lock(&group->mutex);
+
+    for (size_t i = 0; i < nFutures; i++) {
+
+        if (!futures[i]) {
+            continue;
+        }
+
+        while (futures[i]->running) {
+            pthread_cond_wait(&group->cond, &group->mutex);
+        }
+
+        if (futures[i]->status > status) {
+            status = futures[i]->status;
+        }
+    }
+
+    pthread_mutex_unlock(&group->mutex);
+
+    return status;
+}
+
+FMIStatus FMI3WaitAny(FMI3StepFuture *futures[], size_t nFutures, size_t *index) {
+
+    FMIStatus status = FMIError;
+
+    FMI3StepGroup *group = commonGroup(futures, nFutures);
+
+    if (!group) {
+        return FMIError;
+    }
+
+    pthread_mutex_lock(&group->mutex);
+
+    for (;;) {
+
+        bool pending = false;
+
+        for (size_t i = 0; i < nFutures; i++) {
+
+            if (!futures[i]) {
+                continue;
+            }
+
+            if (!futures[i]->running) {
+                *index = i;
+                status = futures[i]->status;
+                goto TERMINATE;
+            }
+
+            pending = true;
+        }
+
+        if (!pending) {
+            goto TERMINATE;
+        }
+
+        pthread_cond_wait(&group->cond, &group->mutex);
+    }
+
+TERMINATE:
+    pthread_mutex_unlock(&group->mutex);
+
+    return status;
+}
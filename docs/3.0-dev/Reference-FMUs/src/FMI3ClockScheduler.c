@@ -0,0 +1,346 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3ClockScheduler.h"
+
+
+#define INITIAL_CAPACITY 64
+#define MAX_COUNTDOWN_CLOCKS 64
+
+typedef struct {
+    FMI3ClockEvent event;
+    fmi3Float64 firstTime;  // periodic clocks only
+    size_t nTicks;          // periodic clocks only
+    size_t sequence;
+} Entry;
+
+struct FMI3ClockScheduler_ {
+    Entry *heap;
+    size_t nEntries;
+    size_t capacity;
+    size_t nextSequence;
+};
+
+static bool before(const Entry *a, const Entry *b) {
+
+    if (a->event.time != b->event.time) {
+        return a->event.time < b->event.time;
+    }
+
+    if (a->event.priority != b->event.priority) {
+        return a->event.priority < b->event.priority;
+    }
+
+    return a->sequence < b->sequence;
+}
+
+static void siftUp(FMI3ClockScheduler *scheduler, size_t i) {
+
+    Entry *heap = scheduler->heap;
+    const Entry entry = heap[i];
+
+    while (i > 0) {
+
+        const size_t parent = (i - 1) / 2;
+
+        if (!before(&entry, &heap[parent])) {
+            break;
+        }
+
+        heap[i] = heap[parent];
+        i = parent;
+    }
+
+    heap[i] = entry;
+}
+
+static void siftDown(FMI3ClockScheduler *scheduler, size_t i) {
+
+    Entry *heap = scheduler->heap;
+    const size_t n = scheduler->nEntries;
+    const Entry entry = heap[i];
+
+    for (;;) {
+
+        size_t child = 2 * i + 1;
+
+        if (child >= n) {
+            break;
+        }
+
+        if (child + 1 < n && before(&heap[child + 1], &heap[child])) {
+            child++;
+        }
+
+        if (!before(&heap[child], &entry)) {
+            break;
+        }
+
+        heap[i] = heap[child];
+        i = child;
+    }
+
+    heap[i] = entry;
+}
+
+static FMIStatus push(FMI3ClockScheduler *scheduler, const Entry *entry) {
+
+    if (scheduler->nEntries == scheduler->capacity) {
+
+        const size_t capacity = scheduler->capacity > 0 ? 2 * scheduler->capacity : INITIAL_CAPACITY;
+
+        Entry *heap = realloc(scheduler->heap, capacity * sizeof(Entry));
+
+        if (!heap) {
+            return FMIError;
+        }
+
+        scheduler->heap = heap;
+        scheduler->capacity = capacity;
+    }
+
+    scheduler->heap[scheduler->nEntries] = *entry;
+    scheduler->heap[scheduler->nEntries].sequence = scheduler->nextSequence++;
+
+    siftUp(scheduler, scheduler->nEntries++);
+
+    return FMIOK;
+}
+
+FMI3ClockScheduler *FMI3CreateClockScheduler(void) {
+    return calloc(1, sizeof(FMI3ClockScheduler));
+}
+
+void FMI3FreeClockScheduler(FMI3ClockScheduler *scheduler) {
+
+    if (!scheduler) {
+        return;
+    }
+
+    free(scheduler->heap);
+    free(scheduler);
+}
+
+void FMI3ClockSchedulerClear(FMI3ClockScheduler *scheduler) {
+    scheduler->nEntries = 0;
+}
+
+FMIStatus FMI3ClockSchedulerAddPeriodicClock(FMI3ClockScheduler *scheduler,
+    FMIInstance *instance,
+    fmi3ValueReference clockReference,
+    fmi3Int32 priority,
+    fmi3Float64 interval,
+    fmi3Float64 firstTime,
+    void *userData) {
+
+    if (!(interval > 0) || !isfinite(firstTime)) {
+        return FMIError;
+    }
+
+    const Entry entry = {
+        .event = {
+            .instance       = instance,
+            .clockReference = clockReference,
+            .priority       = priority,
+            .time           = firstTime,
+            .interval       = interval,
+            .userData       = userData
+        },
+        .firstTime = firstTime,
+        .nTicks    = 0
+    };
+
+    return push(scheduler, &entry);
+}
+
+FMIStatus FMI3ClockSchedulerAddEvent(FMI3ClockScheduler *scheduler,
+    FMIInstance *instance,
+    fmi3ValueReference clockReference,
+    fmi3Int32 priority,
+    fmi3Float64 time,
+    void *userData) {
+
+    if (!isfinite(time)) {
+        return FMIError;
+    }
+
+    const Entry entry = {
+        .event = {
+            .instance       = instance,
+            .clockReference = clockReference,
+            .priority       = priority,
+            .time           = time,
+            .interval       = 0,
+            .userData       = userData
+        }
+    };
+
+    return push(scheduler, &entry);
+}
+
+FMIStatus FMI3ClockSchedulerUpdateCountdownClocks(FMI3ClockScheduler *scheduler,
+    FMIInstance *instance,
+    const fmi3ValueReference clockReferences[],
+    const fmi3Int32 priorities[],
+    void *const userData[],
+    size_t nClocks,
+    fmi3Float64 time) {
+
+    fmi3Float64 intervals[MAX_COUNTDOWN_CLOCKS];
+    fmi3IntervalQualifier qualifiers[MAX_COUNTDOWN_CLOCKS];
+
+    if (nClocks > MAX_COUNTDOWN_CLOCKS) {
+        return FMIError;
+    }
+
+    if (nClocks == 0) {
+        return FMIOK;
+    }
+
+    FMIStatus status = FMI3GetIntervalDecimal(instance, clockReferences, nClocks, intervals, qualifiers, nClocks);
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
+    for (size_t i = 0; i < nClocks; i++) {
+
+        if (qualifiers[i] != fmi3IntervalChanged) {
+            continue;
+        }
+
+        if (FMI3ClockSchedulerAddEvent(scheduler, instance, clockReferences[i], priorities[i], time + intervals[i], userData ? userData[i] : NULL) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    return status;
+}
+
+fmi3Float64 FMI3ClockSchedulerNextTime(const FMI3ClockScheduler *scheduler) {
+    return scheduler->nEntries > 0 ? scheduler->heap[0].event.time : INFINITY;
+}
+
+bool FMI3ClockSchedulerPop(FMI3ClockScheduler *scheduler, fmi3Float64 time, FMI3ClockEvent *event) {
+
+    if (scheduler->nEntries == 0 || scheduler->heap[0].event.time > time) {
+        return false;
+    }
+
+    Entry *next = &scheduler->heap[0];
+
+    *event = next->event;
+
+    if (next->event.interval > 0) {
+        // compute the ticks from the first time to avoid drift
+        next->nTicks++;
+        next->event.time = next->firstTime + next->nTicks * next->event.interval;
+    } else {
+        *next = scheduler->heap[--scheduler->nEntries];
+    }
+
+    if (scheduler->nEntries > 0) {
+        siftDown(scheduler, 0);
+    }
+
+    return true;
+}
+
+// value of the attribute name="..." in the element that ends at end
+static const char *findAttribute(const char *element, const char *end, const char *name) {
+
+    const size_t length = strlen(name);
+
+    for (const char *p = element; p + length + 2 < end; p++) {
+        if ((*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') && strncmp(p + 1, name, length) == 0 && p[length + 1] == '=' && p[length + 2] == '"') {
+            return p + length + 3;
+        }
+    }
+
+    return NULL;
+}
+
+FMIStatus FMI3ReadClockPriorities(const char *path, const fmi3ValueReference clockReferences[], fmi3Int32 priorities[], size_t nClocks) {
+
+    FMIStatus status = FMIError;
+
+    FILE *file = fopen(path, "rb");
+    char *xml = NULL;
+    size_t nFound = 0;
+
+    if (!file) {
+        goto TERMINATE;
+    }
+
+    if (fseek(file, 0, SEEK_END) != 0) {
+        goto TERMINATE;
+    }
+
+    const long size = ftell(file);
+
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        goto TERMINATE;
+    }
+
+    xml = calloc((size_t)size + 1, sizeof(char));
+
+    if (!xml || fread(xml, 1, (size_t)size, file) != (size_t)size) {
+        goto TERMINATE;
+    }
+
+    for (const char *p = xml; (p = strstr(p, "<Clock ")); p++) {
+
+        const char *end = strchr(p, '>');
+
+        if (!end) {
+            goto TERMINATE;
+        }
+
+        const char *valueReference = findAttribute(p, end, "valueReference");
+        const char *priority = findAttribute(p, end, "priority");
+
+        if (!valueReference) {
+            goto TERMINATE;
+        }
+
+        const fmi3ValueReference clockReference = (fmi3ValueReference)strtoul(valueReference, NULL, 10);
+
+        for (size_t i = 0; i < nClocks; i++) {
+
+            if (clockReferences[i] != clockReference) {
+                continue;
+            }
+
+            // input clocks must have a priority
+            if (!priority) {
+                goto TERMINATE;
+            }
+
+            priorities[i] = (fmi3Int32)strtol(priority, NULL, 10);
+            nFound++;
+        }
+    }
+
+    if (nFound == nClocks) {
+        status = FMIOK;
+    }
+
+TERMINATE:
+
+    free(xml);
+
+    if (file) {
+        fclose(file);
+    }
+
+    return status;
+}
@@ -0,0 +1,752 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // pthread_setaffinity_np()
+#endif
+
+#include <errno.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "FMI3ClockScheduler.h"
+#include "FMI3Executor.h"
+
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+// maximum number of released activations per task that have not been started yet
+#define MAX_PENDING 16
+
+// number of attempts to acquire the preemption lock before the thread blocks in the kernel
+#define PREEMPTION_LOCK_SPIN 100
+
+// time to sleep between the attempts to acquire the preemption lock if FUTEX_LOCK_PI fails
+#define PREEMPTION_LOCK_SLEEP_NS 10000
+
+typedef struct {
+    fmi3Float64 time;
+    double releaseTime; // wall-clock time
+} Activation;
+
+typedef struct {
+
+    FMI3Executor *executor;
+    FMI3ExecutorTask task;
+
+    // SCHED_FIFO priority
+    int priority;
+
+    pthread_t thread;
+    bool started;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    Activation pending[MAX_PENDING];
+    size_t head;
+    size_t nPending;
+    bool busy;
+    bool stop;
+
+    // wall-clock time of the last call to FMI3ExecutorTrigger()
+    double triggerCallTime;
+
+    FMI3TaskStatistics statistics;
+
+} Task;
+
+struct FMI3Executor_ {
+
+    FMIInstance *instance;
+    FMI3ExecutorSettings settings;
+
+    Task *tasks; // by descending priority
+    size_t nTasks;
+
+    bool realTime;
+    int timerPriority;
+
+    // protects the fields below and wakes up the timer
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    FMI3ClockScheduler *scheduler;
+    bool running;
+    bool stopped;
+    FMIStatus status;
+    fmi3Float64 startTime;
+    fmi3Float64 stopTime;
+    double wallStartTime;
+
+    // TID of the thread that holds the preemption lock (0 = unlocked) or'ed with
+    // FUTEX_WAITERS by the kernel if other threads are blocked on it
+    _Atomic uint32_t preemptionLock;
+    int preemptionLockSpin;
+
+    // set when FUTEX_LOCK_PI has failed, so the error is reported only once
+    atomic_bool preemptionLockFailed;
+};
+
+// the preemption callbacks have no arguments
+static FMI3Executor *currentExecutor = NULL;
+
+static _Thread_local uint32_t threadId = 0;
+
+// number of nested calls to FMI3ExecutorLockPreemption() on this thread
+static _Thread_local unsigned int preemptionLockDepth = 0;
+
+static double currentTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static struct timespec toTimespec(double time) {
+    struct timespec ts;
+    ts.tv_sec  = (time_t)time;
+    ts.tv_nsec = (long)((time - ts.tv_sec) * 1e9);
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+static void logMessage(FMI3Executor *executor, FMIStatus status, const char *message) {
+    if (executor->instance->logMessage) {
+        executor->instance->logMessage(executor->instance, status, "logStatusWarning", message);
+    }
+}
+
+static Task *findTask(FMI3Executor *executor, fmi3ValueReference clockReference) {
+
+    for (size_t i = 0; i < executor->nTasks; i++) {
+        if (executor->tasks[i].task.clockReference == clockReference) {
+            return &executor->tasks[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void pinThread(FMI3Executor *executor) {
+
+    if (executor->settings.cpu < 0) {
+        return;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(executor->settings.cpu, &cpuSet);
+
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+}
+
+// check whether the process is allowed to use SCHED_FIFO without changing the calling thread
+static bool canUseRealTime(int priority) {
+
+    int policy;
+    struct sched_param saved, param = { .sched_priority = priority };
+
+    if (pthread_getschedparam(pthread_self(), &policy, &saved) != 0) {
+        return false;
+    }
+
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        return false;
+    }
+
+    pthread_setschedparam(pthread_self(), policy, &saved);
+
+    return true;
+}
+
+static FMIStatus activate(Task *task, fmi3Float64 activationTime) {
+
+    FMIInstance *instance = task->executor->instance;
+    const FMI3ExecutorTask *t = &task->task;
+
+    FMIStatus status = FMIOK;
+
+    if (t->beforeActivation) {
+        CALL(t->beforeActivation(instance, t->clockReference, activationTime, t->userData));
+    }
+
+    CALL(FMI3ActivateModelPartition(instance, t->clockReference, 0, activationTime));
+
+    if (t->afterActivation) {
+        CALL(t->afterActivation(instance, t->clockReference, activationTime, t->userData));
+    }
+
+TERMINATE:
+    return status;
+}
+
+static void *runTask(void *arg) {
+
+    Task *task = arg;
+    FMI3Executor *executor = task->executor;
+
+    pinThread(executor);
+
+    for (;;) {
+
+        pthread_mutex_lock(&task->mutex);
+
+        while (task->nPending == 0 && !task->stop) {
+            pthread_cond_wait(&task->cond, &task->mutex);
+        }
+
+        if (task->nPending == 0) {
+            pthread_mutex_unlock(&task->mutex);
+            break;
+        }
+
+        const Activation activation = task->pending[task->head];
+
+        task->head = (task->head + 1) % MAX_PENDING;
+        task->nPending--;
+        task->busy = true;
+
+        pthread_mutex_unlock(&task->mutex);
+
+        const double start = currentTime();
+
+        FMIStatus status = activate(task, activation.time);
+
+        const double end = currentTime();
+
+        pthread_mutex_lock(&task->mutex);
+
+        FMI3TaskStatistics *s = &task->statistics;
+
+        s->nActivations++;
+        s->maxLatency       = fmax(s->maxLatency, start - activation.releaseTime);
+        s->maxExecutionTime = fmax(s->maxExecutionTime, end - start);
+
+        task->busy = false;
+
+        pthread_mutex_unlock(&task->mutex);
+
+        if (executor->settings.activationFinished) {
+
+            const FMI3ActivationRecord record = {
+                .clockReference = task->task.clockReference,
+                .priority       = task->task.priority,
+                .activationTime = activation.time,
+                .releaseTime    = activation.releaseTime,
+                .startTime      = start,
+                .finishTime     = end
+            };
+
+            executor->settings.activationFinished(&record, executor->settings.userData);
+        }
+
+        pthread_mutex_lock(&executor->mutex);
+
+        if (status > executor->status) {
+            executor->status = status;
+        }
+
+        if (status > FMIWarning) {
+            executor->stopped = true;
+        }
+
+        // the timer waits for the tasks to become idle before it stops
+        pthread_cond_signal(&executor->cond);
+
+        pthread_mutex_unlock(&executor->mutex);
+
+        if (status > FMIWarning) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+// queue an activation of the task (the executor must be locked)
+static void release(Task *task, fmi3Float64 time, double releaseTime) {
+
+    pthread_mutex_lock(&task->mutex);
+
+    FMI3TaskStatistics *s = &task->statistics;
+
+    if (task->busy || task->nPending > 0) {
+        s->nOverruns++;
+    }
+
+    if (task->nPending == MAX_PENDING) {
+        s->nDropped++;
+    } else {
+        Activation *activation = &task->pending[(task->head + task->nPending) % MAX_PENDING];
+        activation->time        = time;
+        activation->releaseTime = releaseTime;
+        task->nPending++;
+        pthread_cond_signal(&task->cond);
+    }
+
+    pthread_mutex_unlock(&task->mutex);
+}
+
+static bool isIdle(FMI3Executor *executor) {
+
+    bool idle = true;
+
+    for (size_t i = 0; idle && i < executor->nTasks; i++) {
+
+        Task *task = &executor->tasks[i];
+
+        pthread_mutex_lock(&task->mutex);
+        idle = !task->busy && task->nPending == 0;
+        pthread_mutex_unlock(&task->mutex);
+    }
+
+    return idle;
+}
+
+static double toWallClockTime(FMI3Executor *executor, fmi3Float64 time) {
+    return executor->wallStartTime + (time - executor->startTime) * executor->settings.timeScale;
+}
+
+// release the tasks in real time (called with the executor locked)
+static void runTimer(FMI3Executor *executor) {
+
+    while (!executor->stopped) {
+
+        const fmi3Float64 time = FMI3ClockSchedulerNextTime(executor->scheduler);
+
+        if (!(time < executor->stopTime)) {
+
+            // running activations can still trigger clocks before stopTime
+            if (!isIdle(executor)) {
+                pthread_cond_wait(&executor->cond, &executor->mutex);
+                continue;
+            }
+
+            break;
+        }
+
+        const double wallClockTime = toWallClockTime(executor, time);
+        const struct timespec ts = toTimespec(wallClockTime);
+
+        // triggers and errors wake up the timer to re-evaluate the next release
+        if (pthread_cond_timedwait(&executor->cond, &executor->mutex, &ts) != ETIMEDOUT) {
+            continue;
+        }
+
+        FMI3ClockEvent event;
+
+        // release the due tasks in the order of their priority
+        while (FMI3ClockSchedulerPop(executor->scheduler, time, &event)) {
+
+            Task *task = event.userData;
+
+            release(task, event.time, event.interval > 0 ? wallClockTime : fmax(wallClockTime, task->triggerCallTime));
+        }
+    }
+}
+
+FMI3Executor *FMI3CreateExecutor(FMIInstance *instance,
+    const FMI3ExecutorTask tasks[],
+    size_t nTasks,
+    const FMI3ExecutorSettings *settings) {
+
+    if (currentExecutor || !instance || nTasks == 0 || (settings->cpu >= CPU_SETSIZE)) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < nTasks; i++) {
+
+        if (tasks[i].interval < 0 || tasks[i].shift < 0) {
+            return NULL;
+        }
+
+        for (size_t j = 0; j < i; j++) {
+            if (tasks[i].clockReference == tasks[j].clockReference) {
+                return NULL;
+            }
+        }
+    }
+
+    FMI3Executor *executor = calloc(1, sizeof(FMI3Executor));
+    Task *sorted = calloc(nTasks, sizeof(Task));
+    FMI3ClockScheduler *scheduler = FMI3CreateClockScheduler();
+
+    if (!executor || !sorted || !scheduler) {
+        free(executor);
+        free(sorted);
+        FMI3FreeClockScheduler(scheduler);
+        return NULL;
+    }
+
+    executor->instance = instance;
+    executor->settings = *settings;
+    executor->tasks     = sorted;
+    executor->nTasks    = nTasks;
+    executor->scheduler = scheduler;
+
+    if (executor->settings.timeScale <= 0) {
+        executor->settings.timeScale = 1;
+    }
+
+    // insertion sort by clock priority (lower value = higher priority)
+    for (size_t i = 0; i < nTasks; i++) {
+
+        size_t j = i;
+
+        while (j > 0 && sorted[j - 1].task.priority > tasks[i].priority) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+
+        sorted[j].task = tasks[i];
+    }
+
+    const int minPriority = sched_get_priority_min(SCHED_FIFO);
+    const int maxPriority = sched_get_priority_max(SCHED_FIFO);
+
+    int priority = settings->maxPriority > 0 ? settings->maxPriority : maxPriority - 1;
+
+    if (priority > maxPriority - 1) {
+        priority = maxPriority - 1;
+    }
+
+    executor->timerPriority = priority + 1;
+
+    // map the distinct clock priorities to consecutive SCHED_FIFO priorities
+    for (size_t i = 0; i < nTasks; i++) {
+
+        Task *task = &sorted[i];
+
+        if (i > 0 && task->task.priority > sorted[i - 1].task.priority && priority > minPriority) {
+            priority--;
+        }
+
+        task->executor = executor;
+        task->priority = priority;
+
+        pthread_mutex_init(&task->mutex, NULL);
+        pthread_cond_init(&task->cond, NULL);
+    }
+
+    executor->realTime = settings->realTime && canUseRealTime(executor->timerPriority);
+
+    if (settings->realTime && !executor->realTime) {
+        logMessage(executor, FMIWarning, "SCHED_FIFO is not permitted. Falling back to SCHED_OTHER.");
+    }
+
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&executor->cond, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+
+    pthread_mutex_init(&executor->mutex, NULL);
+
+    atomic_init(&executor->preemptionLock, 0);
+    atomic_init(&executor->preemptionLockFailed, false);
+
+    // spinning only helps if the owner of the lock can run on another CPU at the same time
+    executor->preemptionLockSpin = (settings->cpu < 0 && sysconf(_SC_NPROCESSORS_ONLN) > 1) ? PREEMPTION_LOCK_SPIN : 0;
+
+    currentExecutor = executor;
+
+    return executor;
+}
+
+void FMI3FreeExecutor(FMI3Executor *executor) {
+
+    if (!executor) {
+        return;
+    }
+
+    for (size_t i = 0; i < executor->nTasks; i++) {
+        pthread_mutex_destroy(&executor->tasks[i].mutex);
+        pthread_cond_destroy(&executor->tasks[i].cond);
+    }
+
+    pthread_mutex_destroy(&executor->mutex);
+    pthread_cond_destroy(&executor->cond);
+
+    FMI3FreeClockScheduler(executor->scheduler);
+
+    if (currentExecutor == executor) {
+        currentExecutor = NULL;
+    }
+
+    free(executor->tasks);
+    free(executor);
+}
+
+static bool startTask(FMI3Executor *executor, Task *task) {
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    if (executor->realTime) {
+        struct sched_param param = { .sched_priority = task->priority };
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+
+    task->started = pthread_create(&task->thread, &attr, runTask, task) == 0;
+
+    pthread_attr_destroy(&attr);
+
+    return task->started;
+}
+
+FMIStatus FMI3ExecutorRun(FMI3Executor *executor, fmi3Float64 startTime, fmi3Float64 stopTime) {
+
+    if (!executor || executor->running || !(stopTime >= startTime)) {
+        return FMIError;
+    }
+
+    FMIStatus status = FMIOK;
+
+    // the timer runs on the calling thread
+    int policy;
+    struct sched_param savedParam;
+    cpu_set_t savedCpuSet;
+
+    const bool restoreScheduling = executor->realTime && pthread_getschedparam(pthread_self(), &policy, &savedParam) == 0;
+    const bool restoreAffinity = executor->settings.cpu >= 0 && pthread_getaffinity_np(pthread_self(), sizeof(savedCpuSet), &savedCpuSet) == 0;
+
+    pinThread(executor);
+
+    if (restoreScheduling) {
+        struct sched_param param = { .sched_priority = executor->timerPriority };
+        pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    }
+
+    pthread_mutex_lock(&executor->mutex);
+
+    executor->running   = true;
+    executor->stopped   = false;
+    executor->status    = FMIOK;
+    executor->startTime = startTime;
+    executor->stopTime  = stopTime;
+
+    for (size_t i = 0; i < executor->nTasks; i++) {
+
+        Task *task = &executor->tasks[i];
+
+        task->stop = false;
+
+        if (task->task.interval > 0 && FMI3ClockSchedulerAddPeriodicClock(executor->scheduler, executor->instance,
+            task->task.clockReference, task->task.priority, task->task.interval, startTime + task->task.shift, task) != FMIOK) {
+            executor->status  = FMIError;
+            executor->stopped = true;
+            break;
+        }
+
+        if (!startTask(executor, task)) {
+            logMessage(executor, FMIError, "Failed to start the thread of a task.");
+            executor->status  = FMIError;
+            executor->stopped = true;
+            break;
+        }
+    }
+
+    executor->wallStartTime = currentTime();
+
+    runTimer(executor);
+
+    executor->stopped = true;
+
+    // discard the activations after stopTime
+    FMI3ClockSchedulerClear(executor->scheduler);
+
+    pthread_mutex_unlock(&executor->mutex);
+
+    // let the tasks finish their pending activations
+    for (size_t i = 0; i < executor->nTasks; i++) {
+
+        Task *task = &executor->tasks[i];
+
+        pthread_mutex_lock(&task->mutex);
+        task->stop = true;
+        pthread_cond_signal(&task->cond);
+        pthread_mutex_unlock(&task->mutex);
+    }
+
+    for (size_t i = 0; i < executor->nTasks; i++) {
+
+        Task *task = &executor->tasks[i];
+
+        if (task->started) {
+            pthread_join(task->thread, NULL);
+            task->started = false;
+        }
+    }
+
+    if (restoreScheduling) {
+        pthread_setschedparam(pthread_self(), policy, &savedParam);
+    }
+
+    if (restoreAffinity) {
+        pthread_setaffinity_np(pthread_self(), sizeof(savedCpuSet), &savedCpuSet);
+    }
+
+    pthread_mutex_lock(&executor->mutex);
+    executor->running = false;
+    status = executor->status;
+    pthread_mutex_unlock(&executor->mutex);
+
+    return status;
+}
+
+FMIStatus FMI3ExecutorTrigger(FMI3Executor *executor, fmi3ValueReference clockReference, fmi3Float64 activationTime) {
+
+    if (!executor) {
+        return FMIError;
+    }
+
+    Task *task = findTask(executor, clockReference);
+
+    if (!task) {
+        return FMIError;
+    }
+
+    pthread_mutex_lock(&executor->mutex);
+
+    task->triggerCallTime = currentTime();
+
+    FMIStatus status = FMI3ClockSchedulerAddEvent(executor->scheduler, executor->instance,
+        clockReference, task->task.priority, activationTime, task);
+
+    pthread_cond_signal(&executor->cond);
+
+    pthread_mutex_unlock(&executor->mutex);
+
+    return status;
+}
+
+bool FMI3ExecutorIsRealTime(const FMI3Executor *executor) {
+    return executor && executor->realTime;
+}
+
+FMIStatus FMI3ExecutorGetStatistics(FMI3Executor *executor, fmi3ValueReference clockReference, FMI3TaskStatistics *statistics) {
+
+    if (!executor || !statistics) {
+        return FMIError;
+    }
+
+    Task *task = findTask(executor, clockReference);
+
+    if (!task) {
+        return FMIError;
+    }
+
+    pthread_mutex_lock(&task->mutex);
+    *statistics = task->statistics;
+    pthread_mutex_unlock(&task->mutex);
+
+    return FMIOK;
+}
+
+static bool tryLockPreemption(FMI3Executor *executor) {
+
+    uint32_t expected = 0;
+
+    return atomic_compare_exchange_strong_explicit(&executor->preemptionLock, &expected, threadId,
+        memory_order_acquire, memory_order_relaxed);
+}
+
+static void lockPreemptionContended(FMI3Executor *executor) {
+
+    for (int i = 0; i < executor->preemptionLockSpin; i++) {
+
+        if (atomic_load_explicit(&executor->preemptionLock, memory_order_relaxed) == 0 && tryLockPreemption(executor)) {
+            return;
+        }
+
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    // the kernel sets FUTEX_WAITERS, boosts the owner to the priority
+    // of the highest waiter and hands the lock over on unlock
+    while (syscall(SYS_futex, (uint32_t *)&executor->preemptionLock, FUTEX_LOCK_PI_PRIVATE, 0, NULL, NULL, 0) != 0) {
+
+        if (errno == EINTR || errno == EAGAIN) {
+            continue;
+        }
+
+        // e.g. ENOSYS if the kernel does not support PI futexes: the lock is not held,
+        // so fall back to polling the lock word without priority inheritance
+        if (!atomic_exchange(&executor->preemptionLockFailed, true)) {
+            char message[128];
+            snprintf(message, sizeof(message), "FUTEX_LOCK_PI failed (errno = %d). The preemption lock does not inherit priorities.", errno);
+            logMessage(executor, FMIWarning, message);
+        }
+
+        const struct timespec delay = { 0, PREEMPTION_LOCK_SLEEP_NS };
+
+        while (!tryLockPreemption(executor)) {
+            nanosleep(&delay, NULL);
+        }
+
+        return;
+    }
+}
+
+void FMI3ExecutorLockPreemption(void) {
+
+    FMI3Executor *executor = currentExecutor;
+
+    if (!executor) {
+        return;
+    }
+
+    if (preemptionLockDepth > 0) {
+        preemptionLockDepth++;
+        return;
+    }
+
+    if (threadId == 0) {
+        threadId = (uint32_t)syscall(SYS_gettid);
+    }
+
+    if (!tryLockPreemption(executor)) {
+        lockPreemptionContended(executor);
+    }
+
+    preemptionLockDepth = 1;
+}
+
+void FMI3ExecutorUnlockPreemption(void) {
+
+    FMI3Executor *executor = currentExecutor;
+
+    if (!executor || preemptionLockDepth == 0) {
+        return;
+    }
+
+    if (--preemptionLockDepth > 0) {
+        return;
+    }
+
+    uint32_t expected = threadId;
+
+    // fails if FUTEX_WAITERS is set
+    if (!atomic_compare_exchange_strong_explicit(&executor->preemptionLock, &expected, 0,
+        memory_order_release, memory_order_relaxed)) {
+        syscall(SYS_futex, (uint32_t *)&executor->preemptionLock, FUTEX_UNLOCK_PI_PRIVATE, 0, NULL, NULL, 0);
+    }
+}
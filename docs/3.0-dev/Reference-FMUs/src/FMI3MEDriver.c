@@ -0,0 +1,393 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMI3MEDriver.h"
+
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+typedef struct {
+
+    FMIInstance *S;
+    const FMI3MESettings *settings;
+    FMI3MEStatistics statistics;
+
+    // start of the current step
+    fmi3Float64 startTime;
+
+    fmi3Float64 *x0;     // continuous states at startTime
+    fmi3Float64 *der_x;  // derivatives at startTime
+    fmi3Float64 *x;      // interpolated continuous states
+
+    fmi3Float64 *zl;     // event indicators at the left end of the interval
+    fmi3Float64 *zr;     // event indicators at the right end of the interval
+    fmi3Float64 *zm;     // event indicators inside the interval
+
+    fmi3Int32 *rootsFound;
+
+} Driver;
+
+// Compare the signs of the event indicators at the left and right end of an interval
+// (-\+ = 1, +/- = -1, no zero crossing = 0). The loop is branch-free so the compiler
+// can vectorize it for a large number of event indicators.
+static bool findZeroCrossings(const fmi3Float64 zl[], const fmi3Float64 zr[], fmi3Int32 rootsFound[], size_t nz) {
+
+    fmi3Int32 any = 0;
+
+    for (size_t i = 0; i < nz; i++) {
+        const fmi3Int32 up   = (zl[i] < 0) & (zr[i] >= 0);
+        const fmi3Int32 down = (zl[i] > 0) & (zr[i] <= 0);
+        rootsFound[i] = up - down;
+        any |= up | down;
+    }
+
+    return any != 0;
+}
+
+// set the time, the interpolated states and the continuous inputs and get the event indicators
+static FMIStatus evaluate(Driver *d, fmi3Float64 time, fmi3Float64 z[]) {
+
+    const FMI3MESettings *s = d->settings;
+
+    FMIStatus status = FMIOK;
+
+    CALL(FMI3SetTime(d->S, time));
+
+    if (s->applyContinuousInputs) {
+        CALL(s->applyContinuousInputs(d->S, false, s->userData));
+    }
+
+    if (s->nx > 0) {
+
+        // the forward Euler step is linear between the start and the end of the step
+        const fmi3Float64 dt = time - d->startTime;
+
+        for (size_t i = 0; i < s->nx; i++) {
+            d->x[i] = d->x0[i] + dt * d->der_x[i];
+        }
+
+        CALL(FMI3SetContinuousStates(d->S, d->x, s->nx));
+    }
+
+    if (s->nz > 0) {
+        CALL(FMI3GetEventIndicators(d->S, z, s->nz));
+        d->statistics.nEventIndicatorEvaluations++;
+    }
+
+TERMINATE:
+    return status;
+}
+
+// Narrow the interval [*tl, *tr] that contains the first zero crossing with the Illinois
+// method. Every iteration takes the earliest secant estimate of the crossing event indicators.
+// The value at an end that has been retained twice in a row is halved to avoid the slow
+// one-sided convergence of the regula falsi.
+static FMIStatus locateStateEvent(Driver *d, fmi3Float64 *tl, fmi3Float64 *tr) {
+
+    const FMI3MESettings *s = d->settings;
+
+    const fmi3Float64 tolerance = s->eventTolerance > 0 ? s->eventTolerance : 1e-12 * fmax(1, fabs(*tr));
+    const size_t maxIterations  = s->maxEventIterations > 0 ? s->maxEventIterations : 100;
+
+    FMIStatus status = FMIOK;
+
+    fmi3Float64 wl = 1, wr = 1;
+    int retained = 0; // end that has been retained in the last iteration (-1 = left, 1 = right)
+
+    for (size_t iteration = 0; iteration < maxIterations && *tr - *tl > tolerance; iteration++) {
+
+        fmi3Float64 fraction = 1;
+
+        for (size_t i = 0; i < s->nz; i++) {
+            if (d->rootsFound[i]) {
+                const fmi3Float64 zl = wl * d->zl[i];
+                const fmi3Float64 zr = wr * d->zr[i];
+                fraction = fmin(fraction, zl / (zl - zr));
+            }
+        }
+
+        fmi3Float64 tm = *tl + fraction * (*tr - *tl);
+
+        // stay inside the interval so it shrinks by at least half of the tolerance
+        tm = fmax(tm, *tl + 0.5 * tolerance);
+        tm = fmin(tm, *tr - 0.5 * tolerance);
+
+        CALL(evaluate(d, tm, d->zm));
+
+        d->statistics.nEventIterations++;
+
+        fmi3Float64 *z = d->zm;
+
+        if (findZeroCrossings(d->zl, d->zm, d->rootsFound, s->nz)) {
+            // the crossing is in [tl, tm]
+            *tr = tm;
+            d->zm = d->zr;
+            d->zr = z;
+            wr = 1;
+            wl = retained == -1 ? 0.5 * wl : 1;
+            retained = -1;
+        } else {
+            // the crossing is in [tm, tr]
+            *tl = tm;
+            d->zm = d->zl;
+            d->zl = z;
+            wl = 1;
+            wr = retained == 1 ? 0.5 * wr : 1;
+            retained = 1;
+            findZeroCrossings(d->zl, d->zr, d->rootsFound, s->nz);
+        }
+    }
+
+TERMINATE:
+    return status;
+}
+
+static void freeDriver(Driver *d) {
+    free(d->x0);
+    free(d->der_x);
+    free(d->x);
+    free(d->zl);
+    free(d->zr);
+    free(d->zm);
+    free(d->rootsFound);
+}
+
+FMIStatus FMI3MESimulate(FMIInstance *instance, const FMI3MESettings *settings, FMI3MEStatistics *statistics) {
+
+    if (!instance || !settings || !(settings->fixedStep > 0) || !(settings->stopTime >= settings->startTime)) {
+        return FMIError;
+    }
+
+    const FMI3MESettings *s = settings;
+
+    FMIStatus status = FMIOK;
+
+    Driver driver = { 0 };
+    Driver *d = &driver;
+
+    d->S        = instance;
+    d->settings = settings;
+
+    d->x0         = calloc(s->nx + 1, sizeof(fmi3Float64));
+    d->der_x      = calloc(s->nx + 1, sizeof(fmi3Float64));
+    d->x          = calloc(s->nx + 1, sizeof(fmi3Float64));
+    d->zl         = calloc(s->nz + 1, sizeof(fmi3Float64));
+    d->zr         = calloc(s->nz + 1, sizeof(fmi3Float64));
+    d->zm         = calloc(s->nz + 1, sizeof(fmi3Float64));
+    d->rootsFound = calloc(s->nz + 1, sizeof(fmi3Int32));
+
+    if (!d->x0 || !d->der_x || !d->x || !d->zl || !d->zr || !d->zm || !d->rootsFound) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    fmi3Boolean inputEvent = fmi3False;
+    fmi3Boolean timeEvent  = fmi3False;
+    fmi3Boolean stateEvent = fmi3False;
+    fmi3Boolean stepEvent  = fmi3False;
+
+    fmi3Boolean discreteStatesNeedUpdate          = fmi3True;
+    fmi3Boolean terminateSimulation               = fmi3False;
+    fmi3Boolean nominalsOfContinuousStatesChanged = fmi3False;
+    fmi3Boolean valuesOfContinuousStatesChanged   = fmi3False;
+    fmi3Boolean nextEventTimeDefined              = fmi3False;
+    fmi3Float64 nextEventTime                     = INFINITY;
+
+    fmi3Float64 time = s->startTime;
+
+    // tag::ModelExchange[]
+    CALL(FMI3EnterInitializationMode(instance, fmi3False, 0.0, time, fmi3True, s->stopTime));
+
+    if (s->applyContinuousInputs) {
+        CALL(s->applyContinuousInputs(instance, false, s->userData));
+    }
+
+    if (s->applyDiscreteInputs) {
+        CALL(s->applyDiscreteInputs(instance, s->userData));
+    }
+
+    CALL(FMI3ExitInitializationMode(instance));
+
+    // intial event iteration
+    while (discreteStatesNeedUpdate) {
+
+        CALL(FMI3UpdateDiscreteStates(instance,
+            &discreteStatesNeedUpdate,
+            &terminateSimulation,
+            &nominalsOfContinuousStatesChanged,
+            &valuesOfContinuousStatesChanged,
+            &nextEventTimeDefined,
+            &nextEventTime));
+
+        if (terminateSimulation) {
+            goto TERMINATE;
+        }
+    }
+
+    CALL(FMI3EnterContinuousTimeMode(instance));
+
+    if (s->nz > 0) {
+        CALL(FMI3GetEventIndicators(instance, d->zl, s->nz));
+    }
+
+    if (s->nx > 0) {
+        CALL(FMI3GetContinuousStates(instance, d->x0, s->nx));
+    }
+
+    if (s->recordVariables) {
+        CALL(s->recordVariables(instance, s->userData));
+    }
+
+    size_t steps = 0;
+
+    while (!terminateSimulation) {
+
+        const fmi3Float64 nextInputEventTime = s->nextInputEventTime ? s->nextInputEventTime(time, s->userData) : INFINITY;
+
+        // detect input and time events
+        inputEvent = time >= nextInputEventTime;
+        timeEvent  = nextEventTimeDefined && time >= nextEventTime;
+
+        // handle events
+        if (inputEvent || timeEvent || stateEvent || stepEvent) {
+
+            d->statistics.nInputEvents += inputEvent;
+            d->statistics.nTimeEvents  += timeEvent;
+            d->statistics.nStateEvents += stateEvent;
+            d->statistics.nStepEvents  += stepEvent;
+
+            CALL(FMI3EnterEventMode(instance, stepEvent, stateEvent, d->rootsFound, s->nz, timeEvent));
+
+            if (inputEvent) {
+
+                if (s->applyContinuousInputs) {
+                    CALL(s->applyContinuousInputs(instance, true, s->userData));
+                }
+
+                if (s->applyDiscreteInputs) {
+                    CALL(s->applyDiscreteInputs(instance, s->userData));
+                }
+            }
+
+            // event iteration
+            do {
+                CALL(FMI3UpdateDiscreteStates(instance,
+                    &discreteStatesNeedUpdate,
+                    &terminateSimulation,
+                    &nominalsOfContinuousStatesChanged,
+                    &valuesOfContinuousStatesChanged,
+                    &nextEventTimeDefined,
+                    &nextEventTime));
+
+                if (terminateSimulation) {
+                    goto TERMINATE;
+                }
+
+            } while (discreteStatesNeedUpdate);
+
+            CALL(FMI3EnterContinuousTimeMode(instance));
+
+            if (s->recordVariables) {
+                CALL(s->recordVariables(instance, s->userData));
+            }
+
+            // the states and event indicators may have been changed by the event
+            if (s->nx > 0) {
+                CALL(FMI3GetContinuousStates(instance, d->x0, s->nx));
+            }
+
+            if (s->nz > 0) {
+                CALL(FMI3GetEventIndicators(instance, d->zl, s->nz));
+            }
+
+            stateEvent = fmi3False;
+        }
+
+        if (time >= s->stopTime) {
+            goto TERMINATE;
+        }
+
+        if (s->nx > 0) {
+            CALL(FMI3GetContinuousStateDerivatives(instance, d->der_x, s->nx));
+        }
+
+        // end the step at the next grid point, time event or input event
+        fmi3Float64 stepEndTime = s->startTime + (steps + 1) * s->fixedStep;
+        bool gridPoint = true;
+
+        if (nextEventTimeDefined && nextEventTime > time && nextEventTime < stepEndTime) {
+            stepEndTime = nextEventTime;
+            gridPoint = false;
+        }
+
+        if (nextInputEventTime > time && nextInputEventTime < stepEndTime) {
+            stepEndTime = nextInputEventTime;
+            gridPoint = false;
+        }
+
+        if (stepEndTime > s->stopTime) {
+            stepEndTime = s->stopTime;
+        }
+
+        d->startTime = time;
+
+        CALL(evaluate(d, stepEndTime, d->zr));
+
+        time = stepEndTime;
+
+        if (s->nz > 0 && findZeroCrossings(d->zl, d->zr, d->rootsFound, s->nz)) {
+
+            fmi3Float64 tl = d->startTime;
+
+            CALL(locateStateEvent(d, &tl, &time));
+
+            // end the step at the right end of the interval, after the zero crossing
+            CALL(evaluate(d, time, d->zr));
+
+            stateEvent = findZeroCrossings(d->zl, d->zr, d->rootsFound, s->nz);
+        }
+
+        // advance to the next grid point only if the step has not been shortened
+        // by a state event, so the next step ends at the skipped grid point
+        if (gridPoint && time == stepEndTime) {
+            steps++;
+        }
+
+        if (s->nx > 0) {
+            memcpy(d->x0, d->x, s->nx * sizeof(fmi3Float64));
+        }
+
+        // the event indicators at the end of the step are the left values of the next step
+        fmi3Float64 *z = d->zl;
+        d->zl = d->zr;
+        d->zr = z;
+
+        d->statistics.nSteps++;
+
+        // inform the model about an accepted step
+        CALL(FMI3CompletedIntegratorStep(instance, fmi3True, &stepEvent, &terminateSimulation));
+
+        if (s->recordVariables) {
+            CALL(s->recordVariables(instance, s->userData));
+        }
+    }
+    // end::ModelExchange[]
+
+TERMINATE:
+
+    if (statistics) {
+        *statistics = d->statistics;
+    }
+
+    freeDriver(d);
+
+    return status;
+}
@@ -0,0 +1,1794 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "FMI3Master.h"
+
+// number of iterations a thread spins in a barrier before it blocks
+#define SPIN_COUNT 10000
+
+#define UNVISITED ((size_t)-1)
+
+#define N_VARIABLE_TYPES (FMIClockType + 1)
+
+
+typedef struct {
+    size_t          nThreads;
+    atomic_size_t   count;
+    atomic_size_t   generation;
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+} Barrier;
+
+typedef struct {
+    FMI3Master *master;
+    size_t      index;
+} Worker;
+
+// batched Get or Set of the values of the connections of one type from or to an instance
+typedef struct {
+    FMIVariableType type;
+    size_t nValues;
+    FMIValueReference *valueReferences;
+    size_t *connections;
+    void *buffer;
+} Transfer;
+
+typedef struct {
+    size_t instance;
+    FMIValueReference output;
+    FMIValueReference *inputs;
+    size_t nInputs;
+    bool allInputs;
+} Dependencies;
+
+// strongly connected component of the connection graph
+typedef struct {
+
+    // instances in the order they are stepped
+    size_t nInstances;
+    size_t *instances;
+
+    // Float64 connections between the instances of the component
+    size_t nLoopConnections;
+    size_t *loopConnections;
+
+    // outputs of the component depend directly on its inputs
+    bool algebraicLoop;
+
+    // FMU states to roll back the instances
+    fmi3FMUState *states;
+
+    // workspace of the Newton iteration
+    fmi3Float64 *u;
+    fmi3Float64 *y;
+    fmi3Float64 *r;
+    fmi3Float64 *uPerturbed;
+    fmi3Float64 *yPerturbed;
+    fmi3Float64 *J;
+
+} Component;
+
+struct FMI3Master_ {
+
+    FMIInstance **instances;
+    size_t nInstances;
+
+    // connections ordered by source instance and type
+    FMI3Connection *connections;
+    size_t nConnections;
+
+    // connections from the outputs of each instance (outputStart[i] to outputStart[i + 1])
+    size_t *outputStart;
+
+    // transfers to the inputs and from the outputs of each instance
+    Transfer *inputTransfers;
+    size_t *inputTransferStart;
+    Transfer *outputTransfers;
+    size_t *outputTransferStart;
+
+    // storage of the value references, connection indices and buffers of the transfers
+    FMIValueReference *transferValueReferences;
+    size_t *transferConnections;
+    fmi3Float64 *transferBuffers;
+
+    // values of the connections (double buffered so the outputs at the end of
+    // the step don't overwrite the inputs of instances that are still stepping)
+    fmi3Float64 *values[2];
+    size_t inputBuffer;
+    bool valuesInitialized;
+
+    FMIStatus *status;
+    fmi3Boolean *terminateSimulation;
+
+    FMI3CouplingScheme couplingScheme;
+
+    // declared and cached direct dependencies of outputs on inputs
+    Dependencies *dependencies;
+    size_t nDependencies;
+
+    // paths of the model descriptions and instances that don't implement fmi3GetVariableDependencies()
+    char **modelDescriptions;
+    bool *variableDependenciesNotImplemented;
+
+    // components ordered by level (components of the same level are independent)
+    bool graphInitialized;
+    Component *components;
+    size_t nComponents;
+    size_t *levelStart;
+    size_t nLevels;
+
+    fmi3Float64 loopTolerance;
+    size_t maxLoopIterations;
+
+    fmi3Float64 currentCommunicationPoint;
+    fmi3Float64 communicationStepSize;
+    fmi3Boolean noSetFMUStatePriorToCurrentPoint;
+
+    // step size control
+    FMI3ErrorEstimator errorEstimator;
+    fmi3Float64 absoluteTolerance;
+    fmi3Float64 relativeTolerance;
+    fmi3Float64 minStepSize;
+    fmi3Float64 maxStepSize;
+
+    // FMU states and values to roll back rejected steps
+    fmi3FMUState *states;
+    fmi3Float64 *savedValues;
+    fmi3Float64 *fullStepValues;
+
+    size_t nThreads;
+    pthread_t *threads;
+    Worker *workers;
+    Barrier barrier;
+    bool shutdown;
+
+};
+
+static void initializeBarrier(Barrier *barrier, size_t nThreads) {
+    barrier->nThreads = nThreads;
+    atomic_init(&barrier->count, 0);
+    atomic_init(&barrier->generation, 0);
+    pthread_mutex_init(&barrier->mutex, NULL);
+    pthread_cond_init(&barrier->cond, NULL);
+}
+
+static void destroyBarrier(Barrier *barrier) {
+    pthread_mutex_destroy(&barrier->mutex);
+    pthread_cond_destroy(&barrier->cond);
+}
+
+static void waitForBarrier(Barrier *barrier) {
+
+    const size_t generation = atomic_load(&barrier->generation);
+
+    if (atomic_fetch_add(&barrier->count, 1) + 1 == barrier->nThreads) {
+        // last thread to arrive releases the others
+        atomic_store(&barrier->count, 0);
+        pthread_mutex_lock(&barrier->mutex);
+        atomic_fetch_add(&barrier->generation, 1);
+        pthread_cond_broadcast(&barrier->cond);
+        pthread_mutex_unlock(&barrier->mutex);
+        return;
+    }
+
+    // spin first to avoid the latency of the condition variable for short steps
+    for (size_t i = 0; i < SPIN_COUNT; i++) {
+        if (atomic_load_explicit(&barrier->generation, memory_order_acquire) != generation) {
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&barrier->mutex);
+
+    while (atomic_load(&barrier->generation) == generation) {
+        pthread_cond_wait(&barrier->cond, &barrier->mutex);
+    }
+
+    pthread_mutex_unlock(&barrier->mutex);
+}
+
+static void updateStatus(FMI3Master *master, size_t instance, FMIStatus status) {
+    if (status > master->status[instance]) {
+        master->status[instance] = status;
+    }
+}
+
+static void setInputs(FMI3Master *master, size_t instance, const fmi3Float64 values[]) {
+
+    FMIInstance *S = master->instances[instance];
+
+    for (size_t i = master->inputTransferStart[instance]; i < master->inputTransferStart[instance + 1]; i++) {
+
+        const Transfer *t = &master->inputTransfers[i];
+
+        FMIStatus status = FMIOK;
+
+        switch (t->type) {
+            case FMIFloat32Type: {
+                fmi3Float32 *buffer = t->buffer;
+                for (size_t j = 0; j < t->nValues; j++) {
+                    buffer[j] = (fmi3Float32)values[t->connections[j]];
+                }
+                status = FMI3SetFloat32(S, t->valueReferences, t->nValues, buffer, t->nValues);
+                break;
+            }
+            case FMIFloat64Type: {
+                fmi3Float64 *buffer = t->buffer;
+                for (size_t j = 0; j < t->nValues; j++) {
+                    buffer[j] = values[t->connections[j]];
+                }
+                status = FMI3SetFloat64(S, t->valueReferences, t->nValues, buffer, t->nValues);
+                break;
+            }
+            case FMIInt32Type: {
+                fmi3Int32 *buffer = t->buffer;
+                for (size_t j = 0; j < t->nValues; j++) {
+                    buffer[j] = (fmi3Int32)values[t->connections[j]];
+                }
+                status = FMI3SetInt32(S, t->valueReferences, t->nValues, buffer, t->nValues);
+                break;
+            }
+            default: {
+                fmi3Boolean *buffer = t->buffer;
+                for (size_t j = 0; j < t->nValues; j++) {
+                    buffer[j] = values[t->connections[j]] != 0;
+                }
+                status = FMI3SetBoolean(S, t->valueReferences, t->nValues, buffer, t->nValues);
+                break;
+            }
+        }
+
+        updateStatus(master, instance, status);
+    }
+}
+
+static void getOutputs(FMI3Master *master, size_t instance, fmi3Float64 values[]) {
+
+    FMIInstance *S = master->instances[instance];
+
+    for (size_t i = master->outputTransferStart[instance]; i < master->outputTransferStart[instance + 1]; i++) {
+
+        const Transfer *t = &master->outputTransfers[i];
+
+        FMIStatus status = FMIOK;
+
+        switch (t->type) {
+            case FMIFloat32Type: {
+                fmi3Float32 *buffer = t->buffer;
+                status = FMI3GetFloat32(S, t->valueReferences, t->nValues, buffer, t->nValues);
+                for (size_t j = 0; j < t->nValues; j++) {
+                    values[t->connections[j]] = buffer[j];
+                }
+                break;
+            }
+            case FMIFloat64Type:
+                // the connections of the transfer are contiguous
+                status = FMI3GetFloat64(S, t->valueReferences, t->nValues, &values[t->connections[0]], t->nValues);
+                break;
+            case FMIInt32Type: {
+                fmi3Int32 *buffer = t->buffer;
+                status = FMI3GetInt32(S, t->valueReferences, t->nValues, buffer, t->nValues);
+                for (size_t j = 0; j < t->nValues; j++) {
+                    values[t->connections[j]] = buffer[j];
+                }
+                break;
+            }
+            default: {
+                fmi3Boolean *buffer = t->buffer;
+                status = FMI3GetBoolean(S, t->valueReferences, t->nValues, buffer, t->nValues);
+                for (size_t j = 0; j < t->nValues; j++) {
+                    values[t->connections[j]] = buffer[j];
+                }
+                break;
+            }
+        }
+
+        updateStatus(master, instance, status);
+    }
+}
+
+static void doStep(FMI3Master *master, size_t instance, fmi3Boolean noSetFMUStatePriorToCurrentPoint) {
+
+    fmi3Boolean eventEncountered, terminateSimulation, earlyReturn;
+    fmi3Float64 lastSuccessfulTime;
+
+    if (master->status[instance] > FMIWarning) {
+        return;
+    }
+
+    FMIStatus status = FMI3DoStep(master->instances[instance],
+        master->currentCommunicationPoint,
+        master->communicationStepSize,
+        noSetFMUStatePriorToCurrentPoint,
+        &eventEncountered,
+        &terminateSimulation,
+        &earlyReturn,
+        &lastSuccessfulTime);
+
+    updateStatus(master, instance, status);
+
+    if (terminateSimulation) {
+        master->terminateSimulation[instance] = fmi3True;
+    }
+}
+
+// set the inputs, step the instances and get the outputs of the instances handled by thread
+static void stepJacobi(FMI3Master *master, size_t thread) {
+
+    const fmi3Float64 *inputs = master->values[master->inputBuffer];
+    fmi3Float64 *outputs = master->values[1 - master->inputBuffer];
+
+    for (size_t i = thread; i < master->nInstances; i += master->nThreads) {
+        setInputs(master, i, inputs);
+        doStep(master, i, master->noSetFMUStatePriorToCurrentPoint);
+        getOutputs(master, i, outputs);
+    }
+}
+
+static Dependencies *findDependencies(FMI3Master *master, size_t instance, FMIValueReference output) {
+
+    for (size_t i = 0; i < master->nDependencies; i++) {
+        if (master->dependencies[i].instance == instance && master->dependencies[i].output == output) {
+            return &master->dependencies[i];
+        }
+    }
+
+    return NULL;
+}
+
+static FMIStatus storeDependencies(FMI3Master *master, size_t instance, FMIValueReference output, const FMIValueReference inputs[], size_t nInputs, bool allInputs) {
+
+    Dependencies *dependencies = findDependencies(master, instance, output);
+
+    if (!dependencies) {
+
+        Dependencies *d = realloc(master->dependencies, (master->nDependencies + 1) * sizeof(Dependencies));
+
+        if (!d) {
+            return FMIError;
+        }
+
+        master->dependencies = d;
+
+        dependencies = &master->dependencies[master->nDependencies++];
+
+        dependencies->instance = instance;
+        dependencies->output   = output;
+        dependencies->inputs   = NULL;
+        dependencies->nInputs  = 0;
+    }
+
+    FMIValueReference *copy = calloc(nInputs + 1, sizeof(FMIValueReference));
+
+    if (!copy) {
+        return FMIError;
+    }
+
+    if (nInputs > 0) {
+        memcpy(copy, inputs, nInputs * sizeof(FMIValueReference));
+    }
+
+    free(dependencies->inputs);
+
+    dependencies->inputs    = copy;
+    dependencies->nInputs   = nInputs;
+    dependencies->allInputs = allInputs;
+
+    return FMIOK;
+}
+
+// value of the attribute name of the element between element and end or NULL
+static const char *findAttribute(const char *element, const char *end, const char *name) {
+
+    const size_t length = strlen(name);
+
+    for (const char *p = element; p + length + 2 < end; p++) {
+        if ((*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') && strncmp(p + 1, name, length) == 0 && p[length + 1] == '=' && p[length + 2] == '"') {
+            return p + length + 3;
+        }
+    }
+
+    return NULL;
+}
+
+// store the dependencies of the outputs in the <ModelStructure> of the model description
+static FMIStatus readModelStructure(FMI3Master *master, size_t instance, const char *path) {
+
+    FMIStatus status = FMIError;
+
+    FILE *file = fopen(path, "rb");
+    char *xml = NULL;
+    FMIValueReference *inputs = NULL;
+
+    if (!file) {
+        goto TERMINATE;
+    }
+
+    if (fseek(file, 0, SEEK_END) != 0) {
+        goto TERMINATE;
+    }
+
+    const long size = ftell(file);
+
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        goto TERMINATE;
+    }
+
+    xml = calloc((size_t)size + 1, sizeof(char));
+
+    if (!xml || fread(xml, 1, (size_t)size, file) != (size_t)size) {
+        goto TERMINATE;
+    }
+
+    const char *p = strstr(xml, "<ModelStructure");
+    const char *modelStructureEnd = p ? strstr(p, "</ModelStructure>") : NULL;
+
+    if (!modelStructureEnd) {
+        goto TERMINATE;
+    }
+
+    while ((p = strstr(p, "<Output")) && p < modelStructureEnd) {
+
+        const char *end = strchr(p, '>');
+
+        if (!end) {
+            goto TERMINATE;
+        }
+
+        const char *valueReference = findAttribute(p, end, "valueReference");
+        const char *dependencies = findAttribute(p, end, "dependencies");
+
+        if (!valueReference) {
+            goto TERMINATE;
+        }
+
+        const FMIValueReference output = (FMIValueReference)strtoul(valueReference, NULL, 10);
+
+        size_t nInputs = 0;
+
+        if (dependencies) {
+
+            // the list has at most one value reference per two characters
+            const char *dependenciesEnd = strchr(dependencies, '"');
+
+            if (!dependenciesEnd) {
+                goto TERMINATE;
+            }
+
+            inputs = calloc((size_t)(dependenciesEnd - dependencies) / 2 + 1, sizeof(FMIValueReference));
+
+            if (!inputs) {
+                goto TERMINATE;
+            }
+
+            for (const char *q = dependencies; q < dependenciesEnd;) {
+
+                char *next;
+
+                const unsigned long input = strtoul(q, &next, 10);
+
+                if (next == q) {
+                    break;
+                }
+
+                inputs[nInputs++] = (FMIValueReference)input;
+                q = next;
+            }
+        }
+
+        // without the attribute dependencies the output depends on all inputs
+        if (storeDependencies(master, instance, output, inputs, nInputs, !dependencies) > FMIWarning) {
+            goto TERMINATE;
+        }
+
+        free(inputs);
+        inputs = NULL;
+
+        p = end;
+    }
+
+    status = FMIOK;
+
+TERMINATE:
+
+    if (file) {
+        fclose(file);
+    }
+
+    free(xml);
+    free(inputs);
+
+    return status;
+}
+
+// get the dependencies of an output from the instance or, if the instance does not
+// implement fmi3GetVariableDependencies(), from the model description and cache them
+static FMIStatus loadDependencies(FMI3Master *master, size_t instance, FMIValueReference output) {
+
+    FMIInstance *S = master->instances[instance];
+
+    if (!master->variableDependenciesNotImplemented[instance]) {
+
+        size_t nDependencies = 0;
+
+        if (FMI3GetNumberOfVariableDependencies(S, output, &nDependencies) <= FMIWarning) {
+
+            size_t *elementIndicesOfDependent = calloc(nDependencies + 1, sizeof(size_t));
+            fmi3ValueReference *independents = calloc(nDependencies + 1, sizeof(fmi3ValueReference));
+            size_t *elementIndicesOfIndependents = calloc(nDependencies + 1, sizeof(size_t));
+            fmi3DependencyKind *dependencyKinds = calloc(nDependencies + 1, sizeof(fmi3DependencyKind));
+
+            FMIStatus status = FMIError;
+
+            if (elementIndicesOfDependent && independents && elementIndicesOfIndependents && dependencyKinds) {
+
+                if (nDependencies == 0 ||
+                    FMI3GetVariableDependencies(S, output, elementIndicesOfDependent, independents, elementIndicesOfIndependents, dependencyKinds, nDependencies) <= FMIWarning) {
+                    status = storeDependencies(master, instance, output, independents, nDependencies, false);
+                } else {
+                    status = storeDependencies(master, instance, output, NULL, 0, true);
+                }
+            }
+
+            free(elementIndicesOfDependent);
+            free(independents);
+            free(elementIndicesOfIndependents);
+            free(dependencyKinds);
+
+            return status;
+        }
+
+        // don't call fmi3GetNumberOfVariableDependencies() again for this instance
+        master->variableDependenciesNotImplemented[instance] = true;
+
+        if (master->modelDescriptions[instance] && readModelStructure(master, instance, master->modelDescriptions[instance]) > FMIWarning && S->logMessage) {
+            S->logMessage(S, FMIWarning, "warning", "Failed to read the dependencies from the model description.");
+        }
+
+        if (findDependencies(master, instance, output)) {
+            return FMIOK;
+        }
+    }
+
+    // if the dependencies are not available, assume that the output depends on all inputs
+    return storeDependencies(master, instance, output, NULL, 0, true);
+}
+
+static bool dependsOn(FMI3Master *master, size_t instance, FMIValueReference output, FMIValueReference input) {
+
+    const Dependencies *dependencies = findDependencies(master, instance, output);
+
+    if (!dependencies) {
+
+        if (loadDependencies(master, instance, output) > FMIWarning) {
+            return true;
+        }
+
+        dependencies = findDependencies(master, instance, output);
+    }
+
+    if (!dependencies || dependencies->allInputs) {
+        return true;
+    }
+
+    for (size_t i = 0; i < dependencies->nInputs; i++) {
+        if (dependencies->inputs[i] == input) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+typedef struct {
+    const size_t *edgeStart;
+    const size_t *edges;
+    size_t *index;
+    size_t *lowLink;
+    size_t *stack;
+    bool *onStack;
+    size_t stackSize;
+    size_t nextIndex;
+    size_t *component;
+    size_t nComponents;
+} Tarjan;
+
+// Tarjan's algorithm (components are found in reverse topological order)
+static void connectStrongly(Tarjan *t, size_t v) {
+
+    t->index[v] = t->nextIndex;
+    t->lowLink[v] = t->nextIndex;
+    t->nextIndex++;
+
+    t->stack[t->stackSize++] = v;
+    t->onStack[v] = true;
+
+    for (size_t i = t->edgeStart[v]; i < t->edgeStart[v + 1]; i++) {
+
+        const size_t w = t->edges[i];
+
+        if (t->index[w] == UNVISITED) {
+            connectStrongly(t, w);
+            if (t->lowLink[w] < t->lowLink[v]) t->lowLink[v] = t->lowLink[w];
+        } else if (t->onStack[w]) {
+            if (t->index[w] < t->lowLink[v]) t->lowLink[v] = t->index[w];
+        }
+    }
+
+    if (t->lowLink[v] == t->index[v]) {
+
+        size_t w;
+
+        do {
+            w = t->stack[--t->stackSize];
+            t->onStack[w] = false;
+            t->component[w] = t->nComponents;
+        } while (w != v);
+
+        t->nComponents++;
+    }
+}
+
+// depth-first search for a cycle in the graph of the loop connections
+static bool hasCycle(const bool *adjacency, size_t n, size_t v, char *color) {
+
+    color[v] = 1;
+
+    for (size_t w = 0; w < n; w++) {
+
+        if (!adjacency[v * n + w]) {
+            continue;
+        }
+
+        if (color[w] == 1 || (color[w] == 0 && hasCycle(adjacency, n, w, color))) {
+            return true;
+        }
+    }
+
+    color[v] = 2;
+
+    return false;
+}
+
+static FMIStatus findAlgebraicLoop(FMI3Master *master, Component *component) {
+
+    const size_t n = component->nLoopConnections;
+
+    if (n == 0) {
+        return FMIOK;
+    }
+
+    bool *adjacency = calloc(n * n, sizeof(bool));
+    char *color = calloc(n, sizeof(char));
+
+    if (!adjacency || !color) {
+        free(adjacency);
+        free(color);
+        return FMIError;
+    }
+
+    // connection a -> connection b if the output of b depends directly on the input of a
+    for (size_t a = 0; a < n; a++) {
+
+        const FMI3Connection *ca = &master->connections[component->loopConnections[a]];
+
+        for (size_t b = 0; b < n; b++) {
+
+            const FMI3Connection *cb = &master->connections[component->loopConnections[b]];
+
+            if (ca->targetInstance == cb->sourceInstance) {
+                adjacency[a * n + b] = dependsOn(master, cb->sourceInstance, cb->sourceValueReference, ca->targetValueReference);
+            }
+        }
+    }
+
+    for (size_t v = 0; v < n && !component->algebraicLoop; v++) {
+        if (color[v] == 0) {
+            component->algebraicLoop = hasCycle(adjacency, n, v, color);
+        }
+    }
+
+    free(adjacency);
+    free(color);
+
+    if (!component->algebraicLoop) {
+        return FMIOK;
+    }
+
+    component->states     = calloc(component->nInstances, sizeof(fmi3FMUState));
+    component->u          = calloc(n, sizeof(fmi3Float64));
+    component->y          = calloc(n, sizeof(fmi3Float64));
+    component->r          = calloc(n, sizeof(fmi3Float64));
+    component->uPerturbed = calloc(n, sizeof(fmi3Float64));
+    component->yPerturbed = calloc(n, sizeof(fmi3Float64));
+    component->J          = calloc(n * n, sizeof(fmi3Float64));
+
+    if (!component->states || !component->u || !component->y || !component->r || !component->uPerturbed || !component->yPerturbed || !component->J) {
+        return FMIError;
+    }
+
+    return FMIOK;
+}
+
+static void freeGraph(FMI3Master *master) {
+
+    for (size_t i = 0; i < master->nComponents; i++) {
+
+        Component *component = &master->components[i];
+
+        if (component->states) {
+            for (size_t j = 0; j < component->nInstances; j++) {
+                if (component->states[j]) {
+                    FMI3FreeFMUState(master->instances[component->instances[j]], &component->states[j]);
+                }
+            }
+        }
+
+        free(component->instances);
+        free(component->loopConnections);
+        free(component->states);
+        free(component->u);
+        free(component->y);
+        free(component->r);
+        free(component->uPerturbed);
+        free(component->yPerturbed);
+        free(component->J);
+    }
+
+    free(master->components);
+    free(master->levelStart);
+
+    master->components = NULL;
+    master->nComponents = 0;
+    master->levelStart = NULL;
+    master->nLevels = 0;
+    master->graphInitialized = false;
+}
+
+static FMIStatus buildGraph(FMI3Master *master) {
+
+    const size_t nInstances = master->nInstances;
+
+    FMIStatus status = FMIOK;
+
+    // edges from the source to the target instances of the connections
+    size_t *edgeStart = calloc(nInstances + 1, sizeof(size_t));
+    size_t *edges     = calloc(master->nConnections + 1, sizeof(size_t));
+
+    Tarjan t = {
+        .edgeStart = edgeStart,
+        .edges     = edges,
+        .index     = calloc(nInstances, sizeof(size_t)),
+        .lowLink   = calloc(nInstances, sizeof(size_t)),
+        .stack     = calloc(nInstances, sizeof(size_t)),
+        .onStack   = calloc(nInstances, sizeof(bool)),
+        .component = calloc(nInstances, sizeof(size_t))
+    };
+
+    size_t *level = calloc(nInstances, sizeof(size_t));
+    size_t *order = calloc(nInstances, sizeof(size_t));
+
+    if (!edgeStart || !edges || !t.index || !t.lowLink || !t.stack || !t.onStack || !t.component || !level || !order) {
+        status = FMIError;
+        goto END;
+    }
+
+    for (size_t v = 0; v < nInstances; v++) {
+
+        edgeStart[v] = master->outputStart[v];
+
+        for (size_t i = master->outputStart[v]; i < master->outputStart[v + 1]; i++) {
+            edges[i] = master->connections[i].targetInstance;
+        }
+    }
+
+    edgeStart[nInstances] = master->outputStart[nInstances];
+
+    for (size_t v = 0; v < nInstances; v++) {
+        t.index[v] = UNVISITED;
+    }
+
+    for (size_t v = 0; v < nInstances; v++) {
+        if (t.index[v] == UNVISITED) {
+            connectStrongly(&t, v);
+        }
+    }
+
+    // longest path from a source of the condensed graph in topological order
+    master->nLevels = nInstances > 0 ? 1 : 0;
+
+    for (size_t c = t.nComponents; c-- > 0;) {
+
+        for (size_t v = 0; v < nInstances; v++) {
+
+            if (t.component[v] != c) {
+                continue;
+            }
+
+            for (size_t i = edgeStart[v]; i < edgeStart[v + 1]; i++) {
+
+                const size_t d = t.component[edges[i]];
+
+                if (d != c && level[d] < level[c] + 1) {
+                    level[d] = level[c] + 1;
+                    if (level[d] + 1 > master->nLevels) master->nLevels = level[d] + 1;
+                }
+            }
+        }
+    }
+
+    master->nComponents = t.nComponents;
+    master->components  = calloc(t.nComponents, sizeof(Component));
+    master->levelStart  = calloc(master->nLevels + 1, sizeof(size_t));
+
+    if (!master->components || !master->levelStart) {
+        status = FMIError;
+        goto END;
+    }
+
+    // sort the components by level and in topological order
+    size_t nSorted = 0;
+
+    for (size_t l = 0; l < master->nLevels; l++) {
+
+        master->levelStart[l] = nSorted;
+
+        for (size_t c = t.nComponents; c-- > 0;) {
+            if (level[c] == l) {
+                order[c] = nSorted++;
+            }
+        }
+    }
+
+    master->levelStart[master->nLevels] = nSorted;
+
+    for (size_t v = 0; v < nInstances; v++) {
+        master->components[order[t.component[v]]].nInstances++;
+    }
+
+    for (size_t i = 0; i < master->nConnections; i++) {
+
+        const FMI3Connection *connection = &master->connections[i];
+
+        if (connection->type == FMIFloat64Type && t.component[connection->sourceInstance] == t.component[connection->targetInstance]) {
+            master->components[order[t.component[connection->sourceInstance]]].nLoopConnections++;
+        }
+    }
+
+    for (size_t c = 0; c < master->nComponents; c++) {
+
+        Component *component = &master->components[c];
+
+        component->instances       = calloc(component->nInstances, sizeof(size_t));
+        component->loopConnections = calloc(component->nLoopConnections + 1, sizeof(size_t));
+
+        if (!component->instances || !component->loopConnections) {
+            status = FMIError;
+            goto END;
+        }
+
+        component->nInstances = 0;
+        component->nLoopConnections = 0;
+    }
+
+    for (size_t v = 0; v < nInstances; v++) {
+        Component *component = &master->components[order[t.component[v]]];
+        component->instances[component->nInstances++] = v;
+    }
+
+    for (size_t i = 0; i < master->nConnections; i++) {
+
+        const FMI3Connection *connection = &master->connections[i];
+
+        if (connection->type == FMIFloat64Type && t.component[connection->sourceInstance] == t.component[connection->targetInstance]) {
+            Component *component = &master->components[order[t.component[connection->sourceInstance]]];
+            component->loopConnections[component->nLoopConnections++] = i;
+        }
+    }
+
+    for (size_t c = 0; c < master->nComponents && status == FMIOK; c++) {
+        status = findAlgebraicLoop(master, &master->components[c]);
+    }
+
+    master->graphInitialized = status == FMIOK;
+
+END:
+    free(edgeStart);
+    free(edges);
+    free(t.index);
+    free(t.lowLink);
+    free(t.stack);
+    free(t.onStack);
+    free(t.component);
+    free(level);
+    free(order);
+
+    if (status != FMIOK) {
+        freeGraph(master);
+    }
+
+    return status;
+}
+
+// step the instances of a component one after the other
+static void stepSequence(FMI3Master *master, Component *component) {
+
+    fmi3Float64 *values = master->values[master->inputBuffer];
+
+    for (size_t i = 0; i < component->nInstances; i++) {
+        const size_t instance = component->instances[i];
+        setInputs(master, instance, values);
+        doStep(master, instance, master->noSetFMUStatePriorToCurrentPoint);
+        getOutputs(master, instance, values);
+    }
+}
+
+// roll back the instances, step them with the loop inputs u and get the loop outputs y
+static FMIStatus evaluateLoop(FMI3Master *master, Component *component, const fmi3Float64 u[], fmi3Float64 y[]) {
+
+    fmi3Float64 *values = master->values[master->inputBuffer];
+
+    FMIStatus status = FMIOK;
+
+    for (size_t i = 0; i < component->nInstances; i++) {
+
+        const size_t instance = component->instances[i];
+
+        // the rollback discards the status of the previous iteration
+        master->status[instance] = FMI3SetFMUState(master->instances[instance], component->states[i]);
+
+        setInputs(master, instance, values);
+
+        for (size_t j = 0; j < component->nLoopConnections; j++) {
+
+            const FMI3Connection *connection = &master->connections[component->loopConnections[j]];
+
+            if (connection->targetInstance == instance) {
+                updateStatus(master, instance, FMI3SetFloat64(master->instances[instance], &connection->targetValueReference, 1, &u[j], 1));
+            }
+        }
+
+        doStep(master, instance, fmi3False);
+    }
+
+    for (size_t j = 0; j < component->nLoopConnections; j++) {
+        const FMI3Connection *connection = &master->connections[component->loopConnections[j]];
+        updateStatus(master, connection->sourceInstance, FMI3GetFloat64(master->instances[connection->sourceInstance], &connection->sourceValueReference, 1, &y[j], 1));
+    }
+
+    for (size_t i = 0; i < component->nInstances; i++) {
+        if (master->status[component->instances[i]] > status) {
+            status = master->status[component->instances[i]];
+        }
+    }
+
+    return status;
+}
+
+// solve A * x = b with Gaussian elimination and partial pivoting (x is returned in b)
+static bool solveLinearSystem(fmi3Float64 A[], fmi3Float64 b[], size_t n) {
+
+    for (size_t k = 0; k < n; k++) {
+
+        size_t p = k;
+
+        for (size_t i = k + 1; i < n; i++) {
+            if (fabs(A[i * n + k]) > fabs(A[p * n + k])) {
+                p = i;
+            }
+        }
+
+        if (A[p * n + k] == 0) {
+            return false;
+        }
+
+        if (p != k) {
+            for (size_t j = 0; j < n; j++) {
+                const fmi3Float64 a = A[k * n + j];
+                A[k * n + j] = A[p * n + j];
+                A[p * n + j] = a;
+            }
+            const fmi3Float64 c = b[k];
+            b[k] = b[p];
+            b[p] = c;
+        }
+
+        for (size_t i = k + 1; i < n; i++) {
+
+            const fmi3Float64 f = A[i * n + k] / A[k * n + k];
+
+            for (size_t j = k; j < n; j++) {
+                A[i * n + j] -= f * A[k * n + j];
+            }
+
+            b[i] -= f * b[k];
+        }
+    }
+
+    for (size_t k = n; k-- > 0;) {
+
+        for (size_t j = k + 1; j < n; j++) {
+            b[k] -= A[k * n + j] * b[j];
+        }
+
+        b[k] /= A[k * n + k];
+    }
+
+    return true;
+}
+
+// solve the algebraic loop u = y(u) of a component with a Newton iteration
+static void solveLoop(FMI3Master *master, Component *component) {
+
+    const size_t n = component->nLoopConnections;
+
+    fmi3Float64 *values = master->values[master->inputBuffer];
+
+    bool converged = false;
+
+    for (size_t i = 0; i < component->nInstances; i++) {
+        const size_t instance = component->instances[i];
+        updateStatus(master, instance, FMI3GetFMUState(master->instances[instance], &component->states[i]));
+    }
+
+    for (size_t j = 0; j < n; j++) {
+        component->u[j] = values[component->loopConnections[j]];
+    }
+
+    if (evaluateLoop(master, component, component->u, component->y) > FMIWarning) {
+        return;
+    }
+
+    for (size_t iteration = 0; ; iteration++) {
+
+        converged = true;
+
+        for (size_t j = 0; j < n; j++) {
+            component->r[j] = component->y[j] - component->u[j];
+            converged &= fabs(component->r[j]) <= master->loopTolerance * (1 + fabs(component->u[j]));
+        }
+
+        if (converged || iteration >= master->maxLoopIterations) {
+            break;
+        }
+
+        // Jacobian of the residual r(u) = y(u) - u by finite differences
+        for (size_t k = 0; k < n; k++) {
+
+            const fmi3Float64 delta = sqrt(DBL_EPSILON) * fmax(1, fabs(component->u[k]));
+
+            memcpy(component->uPerturbed, component->u, n * sizeof(fmi3Float64));
+
+            component->uPerturbed[k] += delta;
+
+            if (evaluateLoop(master, component, component->uPerturbed, component->yPerturbed) > FMIWarning) {
+                return;
+            }
+
+            for (size_t j = 0; j < n; j++) {
+                component->J[j * n + k] = ((component->yPerturbed[j] - component->uPerturbed[j]) - component->r[j]) / delta;
+            }
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            component->r[j] = -component->r[j];
+        }
+
+        if (!solveLinearSystem(component->J, component->r, n)) {
+            break;
+        }
+
+        for (size_t j = 0; j < n; j++) {
+            component->u[j] += component->r[j];
+        }
+
+        if (evaluateLoop(master, component, component->u, component->y) > FMIWarning) {
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < component->nInstances; i++) {
+
+        const size_t instance = component->instances[i];
+
+        if (!converged) {
+            updateStatus(master, instance, FMIError);
+        }
+
+        getOutputs(master, instance, values);
+    }
+}
+
+static void stepGaussSeidel(FMI3Master *master, size_t thread) {
+
+    for (size_t l = 0; l < master->nLevels; l++) {
+
+        // wait until the components of the previous level have been stepped
+        if (l > 0) {
+            waitForBarrier(&master->barrier);
+        }
+
+        for (size_t c = master->levelStart[l] + thread; c < master->levelStart[l + 1]; c += master->nThreads) {
+
+            Component *component = &master->components[c];
+
+            if (component->algebraicLoop) {
+                solveLoop(master, component);
+            } else {
+                stepSequence(master, component);
+            }
+        }
+    }
+}
+
+static void step(FMI3Master *master, size_t thread) {
+    if (master->couplingScheme == FMI3GaussSeidelCoupling) {
+        stepGaussSeidel(master, thread);
+    } else {
+        stepJacobi(master, thread);
+    }
+}
+
+static void *runWorker(void *arg) {
+
+    Worker *worker = arg;
+    FMI3Master *master = worker->master;
+
+    for (;;) {
+
+        // wait for the next step
+        waitForBarrier(&master->barrier);
+
+        if (master->shutdown) {
+            break;
+        }
+
+        step(master, worker->index);
+
+        // signal that the step is complete
+        waitForBarrier(&master->barrier);
+    }
+
+    return NULL;
+}
+
+// stable order of the connections by target (or source) instance and type
+static bool orderByInstanceAndType(const FMI3Connection connections[], size_t nConnections, size_t nInstances, bool byTarget, size_t order[], size_t instanceStart[]) {
+
+    const size_t nKeys = nInstances * N_VARIABLE_TYPES;
+
+    size_t *start = calloc(nKeys + 1, sizeof(size_t));
+
+    if (!start) {
+        return false;
+    }
+
+    for (size_t i = 0; i < nConnections; i++) {
+        const size_t instance = byTarget ? connections[i].targetInstance : connections[i].sourceInstance;
+        start[instance * N_VARIABLE_TYPES + connections[i].type + 1]++;
+    }
+
+    for (size_t i = 0; i < nKeys; i++) {
+        start[i + 1] += start[i];
+    }
+
+    for (size_t i = 0; i <= nInstances; i++) {
+        instanceStart[i] = start[i * N_VARIABLE_TYPES];
+    }
+
+    for (size_t i = 0; i < nConnections; i++) {
+        const size_t instance = byTarget ? connections[i].targetInstance : connections[i].sourceInstance;
+        order[start[instance * N_VARIABLE_TYPES + connections[i].type]++] = i;
+    }
+
+    free(start);
+
+    return true;
+}
+
+// add a transfer for every group of connections of the same instance and type in order
+static void addTransfers(FMI3Master *master, const size_t order[], const size_t instanceStart[], bool inputs, size_t *nValues) {
+
+    Transfer *transfers = inputs ? master->inputTransfers : master->outputTransfers;
+    size_t *transferStart = inputs ? master->inputTransferStart : master->outputTransferStart;
+
+    size_t nTransfers = 0;
+
+    for (size_t i = 0; i < master->nInstances; i++) {
+
+        transferStart[i] = nTransfers;
+
+        for (size_t j = instanceStart[i]; j < instanceStart[i + 1]; j++) {
+
+            const FMI3Connection *connection = &master->connections[order[j]];
+
+            if (j == instanceStart[i] || master->connections[order[j - 1]].type != connection->type) {
+
+                Transfer *t = &transfers[nTransfers++];
+
+                t->type            = connection->type;
+                t->nValues         = 0;
+                t->valueReferences = &master->transferValueReferences[*nValues];
+                t->connections     = &master->transferConnections[*nValues];
+                t->buffer          = &master->transferBuffers[*nValues];
+            }
+
+            Transfer *t = &transfers[nTransfers - 1];
+
+            t->valueReferences[t->nValues] = inputs ? connection->targetValueReference : connection->sourceValueReference;
+            t->connections[t->nValues]     = order[j];
+            t->nValues++;
+
+            (*nValues)++;
+        }
+    }
+
+    transferStart[master->nInstances] = nTransfers;
+}
+
+// compile the connections into one batched Get per source and one Set per target and type
+static bool createTransfers(FMI3Master *master) {
+
+    size_t *order = calloc(master->nConnections + 1, sizeof(size_t));
+    size_t *inputStart = calloc(master->nInstances + 1, sizeof(size_t));
+
+    bool success = order && inputStart &&
+        orderByInstanceAndType(master->connections, master->nConnections, master->nInstances, true, order, inputStart);
+
+    if (success) {
+
+        size_t nValues = 0;
+
+        addTransfers(master, order, inputStart, true, &nValues);
+
+        // the connections are already ordered by source instance and type
+        for (size_t i = 0; i < master->nConnections; i++) {
+            order[i] = i;
+        }
+
+        addTransfers(master, order, master->outputStart, false, &nValues);
+    }
+
+    free(order);
+    free(inputStart);
+
+    return success;
+}
+
+FMI3Master *FMI3CreateMaster(FMIInstance *instances[],
+    size_t nInstances,
+    const FMI3Connection connections[],
+    size_t nConnections,
+    size_t nThreads) {
+
+    for (size_t i = 0; i < nConnections; i++) {
+
+        if (connections[i].sourceInstance >= nInstances || connections[i].targetInstance >= nInstances) {
+            return NULL;
+        }
+
+        switch (connections[i].type) {
+            case FMIFloat32Type:
+            case FMIFloat64Type:
+            case FMIInt32Type:
+            case FMIBooleanType:
+                break;
+            default:
+                return NULL;
+        }
+    }
+
+    if (nThreads == 0) {
+        long nProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+        nThreads = nProcessors > 0 ? (size_t)nProcessors : 1;
+    }
+
+    if (nThreads > nInstances) {
+        nThreads = nInstances > 0 ? nInstances : 1;
+    }
+
+    FMI3Master *master = calloc(1, sizeof(FMI3Master));
+
+    if (!master) {
+        return NULL;
+    }
+
+    master->nInstances          = nInstances;
+    master->nConnections        = nConnections;
+    master->nThreads            = nThreads;
+    master->couplingScheme      = FMI3JacobiCoupling;
+    master->loopTolerance       = 1e-8;
+    master->maxLoopIterations   = 20;
+    master->noSetFMUStatePriorToCurrentPoint = fmi3True;
+    master->errorEstimator      = FMI3ExtrapolationErrorEstimator;
+    master->absoluteTolerance   = 1e-6;
+    master->relativeTolerance   = 1e-4;
+    master->minStepSize         = 1e-10;
+    master->maxStepSize         = DBL_MAX;
+    master->instances           = calloc(nInstances, sizeof(FMIInstance *));
+    master->connections         = calloc(nConnections, sizeof(FMI3Connection));
+    master->outputStart         = calloc(nInstances + 1, sizeof(size_t));
+    master->inputTransfers      = calloc(nConnections + 1, sizeof(Transfer));
+    master->inputTransferStart  = calloc(nInstances + 1, sizeof(size_t));
+    master->outputTransfers     = calloc(nConnections + 1, sizeof(Transfer));
+    master->outputTransferStart = calloc(nInstances + 1, sizeof(size_t));
+    master->transferValueReferences = calloc(2 * nConnections + 1, sizeof(FMIValueReference));
+    master->transferConnections = calloc(2 * nConnections + 1, sizeof(size_t));
+    master->transferBuffers     = calloc(2 * nConnections + 1, sizeof(fmi3Float64));
+    master->values[0]           = calloc(nConnections, sizeof(fmi3Float64));
+    master->values[1]           = calloc(nConnections, sizeof(fmi3Float64));
+    master->status              = calloc(nInstances, sizeof(FMIStatus));
+    master->terminateSimulation = calloc(nInstances, sizeof(fmi3Boolean));
+    master->modelDescriptions   = calloc(nInstances, sizeof(char *));
+    master->variableDependenciesNotImplemented = calloc(nInstances, sizeof(bool));
+    master->threads             = calloc(nThreads, sizeof(pthread_t));
+    master->workers             = calloc(nThreads, sizeof(Worker));
+
+    if ((nInstances > 0 && (!master->instances || !master->status || !master->terminateSimulation || !master->modelDescriptions || !master->variableDependenciesNotImplemented)) ||
+        (nConnections > 0 && (!master->connections || !master->values[0] || !master->values[1])) ||
+        !master->outputStart || !master->inputTransfers || !master->inputTransferStart || !master->outputTransfers || !master->outputTransferStart ||
+        !master->transferValueReferences || !master->transferConnections || !master->transferBuffers ||
+        !master->threads || !master->workers) {
+        master->nThreads = 0;
+        FMI3FreeMaster(master);
+        return NULL;
+    }
+
+    if (nInstances > 0) {
+        memcpy(master->instances, instances, nInstances * sizeof(FMIInstance *));
+    }
+
+    // order the connections by source instance and type, so the outputs of an instance
+    // can be retrieved with one call per type directly into the values of the connections
+    size_t *order = calloc(nConnections + 1, sizeof(size_t));
+
+    if (!order || !orderByInstanceAndType(connections, nConnections, nInstances, false, order, master->outputStart)) {
+        free(order);
+        master->nThreads = 0;
+        FMI3FreeMaster(master);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < nConnections; i++) {
+        master->connections[i] = connections[order[i]];
+    }
+
+    free(order);
+
+    if (!createTransfers(master)) {
+        master->nThreads = 0;
+        FMI3FreeMaster(master);
+        return NULL;
+    }
+
+    initializeBarrier(&master->barrier, nThreads);
+
+    // the calling thread is worker 0
+    for (size_t i = 1; i < nThreads; i++) {
+
+        master->workers[i].master = master;
+        master->workers[i].index  = i;
+
+        if (pthread_create(&master->threads[i], NULL, runWorker, &master->workers[i]) != 0) {
+            // release the threads that have already been started
+            master->barrier.nThreads = i;
+            master->nThreads = i;
+            FMI3FreeMaster(master);
+            return NULL;
+        }
+    }
+
+    return master;
+}
+
+void FMI3FreeMaster(FMI3Master *master) {
+
+    if (!master) {
+        return;
+    }
+
+    if (master->nThreads > 0) {
+
+        master->shutdown = true;
+
+        waitForBarrier(&master->barrier);
+
+        for (size_t i = 1; i < master->nThreads; i++) {
+            pthread_join(master->threads[i], NULL);
+        }
+
+        destroyBarrier(&master->barrier);
+    }
+
+    freeGraph(master);
+
+    if (master->states) {
+        for (size_t i = 0; i < master->nInstances; i++) {
+            if (master->states[i]) {
+                FMI3FreeFMUState(master->instances[i], &master->states[i]);
+            }
+        }
+    }
+
+    free(master->states);
+    free(master->savedValues);
+    free(master->fullStepValues);
+
+    for (size_t i = 0; i < master->nDependencies; i++) {
+        free(master->dependencies[i].inputs);
+    }
+
+    free(master->dependencies);
+
+    if (master->modelDescriptions) {
+        for (size_t i = 0; i < master->nInstances; i++) {
+            free(master->modelDescriptions[i]);
+        }
+    }
+
+    free(master->modelDescriptions);
+    free(master->variableDependenciesNotImplemented);
+    free(master->instances);
+    free(master->connections);
+    free(master->outputStart);
+    free(master->inputTransfers);
+    free(master->inputTransferStart);
+    free(master->outputTransfers);
+    free(master->outputTransferStart);
+    free(master->transferValueReferences);
+    free(master->transferConnections);
+    free(master->transferBuffers);
+    free(master->values[0]);
+    free(master->values[1]);
+    free(master->status);
+    free(master->terminateSimulation);
+    free(master->threads);
+    free(master->workers);
+    free(master);
+}
+
+FMIStatus FMI3MasterSetCouplingScheme(FMI3Master *master, FMI3CouplingScheme couplingScheme) {
+
+    if (couplingScheme != FMI3JacobiCoupling && couplingScheme != FMI3GaussSeidelCoupling) {
+        return FMIError;
+    }
+
+    master->couplingScheme = couplingScheme;
+
+    return FMIOK;
+}
+
+FMIStatus FMI3MasterSetDependencies(FMI3Master *master, size_t instance, FMIValueReference output, const FMIValueReference inputs[], size_t nInputs) {
+
+    if (instance >= master->nInstances) {
+        return FMIError;
+    }
+
+    const FMIStatus status = storeDependencies(master, instance, output, inputs, nInputs, false);
+
+    // re-build the graph on the next step
+    freeGraph(master);
+
+    return status;
+}
+
+FMIStatus FMI3MasterSetModelDescription(FMI3Master *master, size_t instance, const char *path) {
+
+    if (instance >= master->nInstances || !path) {
+        return FMIError;
+    }
+
+    char *copy = strdup(path);
+
+    if (!copy) {
+        return FMIError;
+    }
+
+    free(master->modelDescriptions[instance]);
+
+    master->modelDescriptions[instance] = copy;
+
+    // re-build the graph on the next step
+    freeGraph(master);
+
+    return FMIOK;
+}
+
+FMIStatus FMI3MasterSetLoopSolverParameters(FMI3Master *master, fmi3Float64 tolerance, size_t maxIterations) {
+
+    if (tolerance <= 0) {
+        return FMIError;
+    }
+
+    master->loopTolerance     = tolerance;
+    master->maxLoopIterations = maxIterations;
+
+    return FMIOK;
+}
+
+FMIStatus FMI3MasterDoStep(FMI3Master *master,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 communicationStepSize,
+    fmi3Boolean *terminateSimulation) {
+
+    FMIStatus status = FMIOK;
+
+    *terminateSimulation = fmi3False;
+
+    // the status of every step starts over
+    for (size_t i = 0; i < master->nInstances; i++) {
+        master->status[i] = FMIOK;
+    }
+
+    if (master->couplingScheme == FMI3GaussSeidelCoupling && !master->graphInitialized) {
+        if (buildGraph(master) != FMIOK) {
+            return FMIError;
+        }
+    }
+
+    if (!master->valuesInitialized) {
+
+        for (size_t i = 0; i < master->nInstances; i++) {
+            getOutputs(master, i, master->values[master->inputBuffer]);
+        }
+
+        master->valuesInitialized = true;
+    }
+
+    master->currentCommunicationPoint = currentCommunicationPoint;
+    master->communicationStepSize     = communicationStepSize;
+
+    // start the step on the worker threads
+    waitForBarrier(&master->barrier);
+
+    step(master, 0);
+
+    // wait for the worker threads to complete the step
+    waitForBarrier(&master->barrier);
+
+    if (master->couplingScheme == FMI3JacobiCoupling) {
+        master->inputBuffer = 1 - master->inputBuffer;
+    }
+
+    for (size_t i = 0; i < master->nInstances; i++) {
+
+        if (master->status[i] > status) {
+            status = master->status[i];
+        }
+
+        if (master->terminateSimulation[i]) {
+            *terminateSimulation = fmi3True;
+        }
+    }
+
+    return status;
+}
+
+FMIStatus FMI3MasterSetStepSizeControl(FMI3Master *master,
+    FMI3ErrorEstimator errorEstimator,
+    fmi3Float64 absoluteTolerance,
+    fmi3Float64 relativeTolerance,
+    fmi3Float64 minStepSize,
+    fmi3Float64 maxStepSize) {
+
+    if ((errorEstimator != FMI3ExtrapolationErrorEstimator && errorEstimator != FMI3StepDoublingErrorEstimator) ||
+        absoluteTolerance < 0 || relativeTolerance < 0 || absoluteTolerance + relativeTolerance <= 0 ||
+        minStepSize <= 0 || maxStepSize < minStepSize) {
+        return FMIError;
+    }
+
+    master->errorEstimator    = errorEstimator;
+    master->absoluteTolerance = absoluteTolerance;
+    master->relativeTolerance = relativeTolerance;
+    master->minStepSize       = minStepSize;
+    master->maxStepSize       = maxStepSize;
+
+    return FMIOK;
+}
+
+static FMIStatus saveState(FMI3Master *master) {
+
+    FMIStatus status = FMIOK;
+
+    for (size_t i = 0; i < master->nInstances; i++) {
+
+        const FMIStatus s = FMI3GetFMUState(master->instances[i], &master->states[i]);
+
+        if (s > status) {
+            status = s;
+        }
+    }
+
+    memcpy(master->savedValues, master->values[master->inputBuffer], master->nConnections * sizeof(fmi3Float64));
+
+    return status;
+}
+
+static FMIStatus restoreState(FMI3Master *master) {
+
+    FMIStatus status = FMIOK;
+
+    for (size_t i = 0; i < master->nInstances; i++) {
+
+        const FMIStatus s = FMI3SetFMUState(master->instances[i], master->states[i]);
+
+        if (s > status) {
+            status = s;
+        }
+
+        // discard the status of the rejected step
+        master->status[i] = s;
+        master->terminateSimulation[i] = fmi3False;
+    }
+
+    memcpy(master->values[master->inputBuffer], master->savedValues, master->nConnections * sizeof(fmi3Float64));
+
+    return status;
+}
+
+// weighted maximum norm of the difference between the current values of the connections and reference
+static fmi3Float64 estimateError(FMI3Master *master, const fmi3Float64 reference[]) {
+
+    const fmi3Float64 *values = master->values[master->inputBuffer];
+
+    fmi3Float64 error = 0;
+
+    for (size_t i = 0; i < master->nConnections; i++) {
+
+        const fmi3Float64 scale = master->absoluteTolerance + master->relativeTolerance * fmax(fabs(values[i]), fabs(reference[i]));
+        const fmi3Float64 e = fabs(values[i] - reference[i]) / scale;
+
+        if (e > error) {
+            error = e;
+        }
+    }
+
+    return error;
+}
+
+// take a step with h and return the estimated error
+static FMIStatus tryStep(FMI3Master *master, fmi3Float64 currentCommunicationPoint, fmi3Float64 h, fmi3Float64 *error, fmi3Boolean *terminateSimulation) {
+
+    FMIStatus status;
+
+    if (master->errorEstimator == FMI3ExtrapolationErrorEstimator) {
+
+        status = FMI3MasterDoStep(master, currentCommunicationPoint, h, terminateSimulation);
+
+        // the inputs have been held constant at the values of the previous communication point
+        *error = estimateError(master, master->savedValues);
+
+        return status;
+    }
+
+    // one step with h
+    status = FMI3MasterDoStep(master, currentCommunicationPoint, h, terminateSimulation);
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
+    memcpy(master->fullStepValues, master->values[master->inputBuffer], master->nConnections * sizeof(fmi3Float64));
+
+    status = restoreState(master);
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
+    // two steps with h / 2
+    status = FMI3MasterDoStep(master, currentCommunicationPoint, h / 2, terminateSimulation);
+
+    if (status <= FMIWarning && !*terminateSimulation) {
+        status = FMI3MasterDoStep(master, currentCommunicationPoint + h / 2, h / 2, terminateSimulation);
+    }
+
+    *error = estimateError(master, master->fullStepValues);
+
+    return status;
+}
+
+FMIStatus FMI3MasterDoVariableStep(FMI3Master *master,
+    fmi3Float64 currentCommunicationPoint,
+    fmi3Float64 proposedStepSize,
+    fmi3Float64 *communicationStepSize,
+    fmi3Float64 *nextStepSize,
+    fmi3Boolean *terminateSimulation) {
+
+    // safety factor and limits of the step size ratio
+    const fmi3Float64 safety = 0.9;
+    const fmi3Float64 minFactor = 0.2;
+    const fmi3Float64 maxFactor = 5;
+
+    // the error of the extrapolated inputs is O(h), the difference to two half steps O(h^2)
+    const fmi3Float64 exponent = master->errorEstimator == FMI3ExtrapolationErrorEstimator ? 1 : 0.5;
+
+    FMIStatus status = FMIOK;
+
+    // a proposed step below the minimum step size (e.g. the last step to the stop time) is not enlarged
+    fmi3Float64 h = fmin(proposedStepSize, master->maxStepSize);
+
+    *communicationStepSize = 0;
+    *nextStepSize = h;
+    *terminateSimulation = fmi3False;
+
+    if (!master->states) {
+
+        master->states         = calloc(master->nInstances, sizeof(fmi3FMUState));
+        master->savedValues    = calloc(master->nConnections + 1, sizeof(fmi3Float64));
+        master->fullStepValues = calloc(master->nConnections + 1, sizeof(fmi3Float64));
+
+        if (!master->states || !master->savedValues || !master->fullStepValues) {
+            return FMIError;
+        }
+    }
+
+    if (!master->valuesInitialized) {
+
+        for (size_t i = 0; i < master->nInstances; i++) {
+            getOutputs(master, i, master->values[master->inputBuffer]);
+        }
+
+        master->valuesInitialized = true;
+    }
+
+    status = saveState(master);
+
+    if (status > FMIWarning) {
+        return status;
+    }
+
+    master->noSetFMUStatePriorToCurrentPoint = fmi3False;
+
+    for (;;) {
+
+        fmi3Float64 error;
+        fmi3Boolean terminate;
+
+        status = tryStep(master, currentCommunicationPoint, h, &error, &terminate);
+
+        if (status > FMIWarning) {
+            break;
+        }
+
+        const fmi3Float64 factor = error > 0 ? safety * pow(error, -exponent) : maxFactor;
+
+        if (error <= 1 || terminate || h <= master->minStepSize) {
+
+            if (error > 1) {
+                status = FMIWarning;
+            }
+
+            *communicationStepSize = h;
+            *nextStepSize = fmin(fmax(h * fmin(factor, maxFactor), master->minStepSize), master->maxStepSize);
+            *terminateSimulation = terminate;
+            break;
+        }
+
+        // reject the step and try again with a smaller step size
+        status = restoreState(master);
+
+        if (status > FMIWarning) {
+            break;
+        }
+
+        h = fmax(h * fmax(factor, minFactor), master->minStepSize);
+    }
+
+    master->noSetFMUStatePriorToCurrentPoint = fmi3True;
+
+    return status;
+}
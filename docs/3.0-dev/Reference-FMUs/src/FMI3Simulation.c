@@ -0,0 +1,250 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "FMI3Simulation.h"
+#include "FMI3MEDriver.h"
+
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+// context of a simulation that is passed to the callbacks through instance->userData
+typedef struct {
+    const FMI3SimulationSettings *settings;
+    FMIInstance *instance;
+    FMI3SimulationStatistics statistics;
+} Simulation;
+
+static void logFunctionCall(FMIInstance *instance, FMIStatus status, const char *message, ...) {
+
+    const Simulation *simulation = instance->userData;
+
+    FILE *logFile = simulation->settings->logFile;
+
+    va_list args;
+    va_start(args, message);
+
+    vfprintf(logFile, message, args);
+
+    switch (status) {
+    case FMIOK:
+        fprintf(logFile, " -> OK\n");
+        break;
+    case FMIWarning:
+        fprintf(logFile, " -> Warning\n");
+        break;
+    case FMIDiscard:
+        fprintf(logFile, " -> Discard\n");
+        break;
+    case FMIError:
+        fprintf(logFile, " -> Error\n");
+        break;
+    case FMIFatal:
+        fprintf(logFile, " -> Fatal\n");
+        break;
+    case FMIPending:
+        fprintf(logFile, " -> Pending\n");
+        break;
+    default:
+        fprintf(logFile, " -> Unknown status (%d)\n", status);
+        break;
+    }
+
+    va_end(args);
+}
+
+static fmi3Float64 forwardNextInputEventTime(fmi3Float64 time, void *userData) {
+    const FMI3InputProvider *inputs = &((Simulation *)userData)->settings->inputs;
+    return inputs->nextInputEventTime(time, inputs->userData);
+}
+
+static FMIStatus forwardApplyContinuousInputs(FMIInstance *instance, bool afterEvent, void *userData) {
+    const FMI3InputProvider *inputs = &((Simulation *)userData)->settings->inputs;
+    return inputs->applyContinuousInputs(instance, afterEvent, inputs->userData);
+}
+
+static FMIStatus forwardApplyDiscreteInputs(FMIInstance *instance, void *userData) {
+    const FMI3InputProvider *inputs = &((Simulation *)userData)->settings->inputs;
+    return inputs->applyDiscreteInputs(instance, inputs->userData);
+}
+
+static FMIStatus forwardRecordVariables(FMIInstance *instance, void *userData) {
+    const FMI3ResultSink *results = &((Simulation *)userData)->settings->results;
+    return results->recordVariables(instance, results->userData);
+}
+
+static FMIStatus simulateModelExchange(Simulation *simulation) {
+
+    FMIStatus status = FMIOK;
+
+    const FMI3SimulationSettings *s = simulation->settings;
+
+    FMIInstance *S = simulation->instance;
+
+    CALL(FMI3InstantiateModelExchange(S,
+        s->instantiationToken, // instantiationToken
+        s->resourcePath,       // resourcePath
+        fmi3False,             // visible
+        s->loggingOn           // loggingOn
+    ));
+
+    if (s->inputs.applyStartValues) {
+        CALL(s->inputs.applyStartValues(S, s->inputs.userData));
+    }
+
+    // the driver passes the context of the simulation to the callbacks, so the
+    // input provider and the result sink can have different userData
+    const FMI3MESettings settings = {
+        .startTime             = s->startTime,
+        .stopTime              = s->stopTime,
+        .fixedStep             = s->stepSize,
+        .nx                    = s->nx,
+        .nz                    = s->nz,
+        .eventTolerance        = 0,
+        .maxEventIterations    = 0,
+        .nextInputEventTime    = s->inputs.nextInputEventTime    ? forwardNextInputEventTime    : NULL,
+        .applyContinuousInputs = s->inputs.applyContinuousInputs ? forwardApplyContinuousInputs : NULL,
+        .applyDiscreteInputs   = s->inputs.applyDiscreteInputs   ? forwardApplyDiscreteInputs   : NULL,
+        .recordVariables       = s->results.recordVariables      ? forwardRecordVariables       : NULL,
+        .userData              = simulation
+    };
+
+    FMI3MEStatistics statistics;
+
+    CALL(FMI3MESimulate(S, &settings, &statistics));
+
+    simulation->statistics.nSteps           = statistics.nSteps;
+    simulation->statistics.nTimeEvents      = statistics.nTimeEvents;
+    simulation->statistics.nStateEvents     = statistics.nStateEvents;
+    simulation->statistics.nEventIterations = statistics.nEventIterations;
+    simulation->statistics.nStepEvents      = statistics.nStepEvents;
+
+TERMINATE:
+    return status;
+}
+
+static FMIStatus simulateCoSimulation(Simulation *simulation) {
+
+    FMIStatus status = FMIOK;
+
+    const FMI3SimulationSettings *s = simulation->settings;
+
+    FMIInstance *S = simulation->instance;
+
+    fmi3Boolean eventEncountered    = fmi3False;
+    fmi3Boolean terminateSimulation = fmi3False;
+    fmi3Boolean earlyReturn         = fmi3False;
+    fmi3Float64 lastSuccessfulTime  = s->startTime;
+
+    // tag::CoSimulation[]
+    CALL(FMI3InstantiateCoSimulation(S,
+        s->instantiationToken, // instantiationToken
+        s->resourcePath,       // resourcePath
+        fmi3False,             // visible
+        s->loggingOn,          // loggingOn
+        fmi3False,             // eventModeUsed
+        fmi3False,             // earlyReturnAllowed
+        NULL,                  // requiredIntermediateVariables
+        0,                     // nRequiredIntermediateVariables
+        NULL                   // intermediateUpdate
+    ));
+
+    if (s->inputs.applyStartValues) {
+        CALL(s->inputs.applyStartValues(S, s->inputs.userData));
+    }
+
+    CALL(FMI3EnterInitializationMode(S, fmi3False, 0.0, s->startTime, fmi3True, s->stopTime));
+
+    CALL(FMI3ExitInitializationMode(S));
+
+    for (size_t step = 0;; step++) {
+
+        if (s->results.recordVariables) {
+            CALL(s->results.recordVariables(S, s->results.userData));
+        }
+
+        // calculate the current time
+        const fmi3Float64 time = s->startTime + step * s->stepSize;
+
+        if (s->inputs.applyContinuousInputs) {
+            CALL(s->inputs.applyContinuousInputs(S, false, s->inputs.userData));
+        }
+
+        if (s->inputs.applyDiscreteInputs) {
+            CALL(s->inputs.applyDiscreteInputs(S, s->inputs.userData));
+        }
+
+        if (time >= s->stopTime) {
+            break;
+        }
+
+        CALL(FMI3DoStep(S, time, s->stepSize, fmi3True, &eventEncountered, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+
+        simulation->statistics.nSteps++;
+
+        if (terminateSimulation) {
+            simulation->statistics.terminated = true;
+            break;
+        }
+    }
+    // end::CoSimulation[]
+
+TERMINATE:
+    return status;
+}
+
+FMIStatus FMI3Simulate(const FMI3SimulationSettings *settings, FMI3SimulationStatistics *statistics) {
+
+    FMIStatus status = FMIOK;
+
+    Simulation simulation;
+
+    memset(&simulation, 0, sizeof(Simulation));
+
+    simulation.settings = settings;
+
+    if (settings->interfaceType != FMIModelExchange && settings->interfaceType != FMICoSimulation) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    simulation.instance = FMICreateInstance(settings->instanceName, settings->libraryPath, settings->logMessage, settings->logFile ? logFunctionCall : NULL);
+
+    if (!simulation.instance) {
+        status = FMIError;
+        goto TERMINATE;
+    }
+
+    simulation.instance->userData = &simulation;
+
+    if (settings->interfaceType == FMIModelExchange) {
+        status = simulateModelExchange(&simulation);
+    } else {
+        status = simulateCoSimulation(&simulation);
+    }
+
+    if (status < FMIError) {
+        const FMIStatus terminateStatus = FMI3Terminate(simulation.instance);
+        status = terminateStatus > status ? terminateStatus : status;
+    }
+
+    if (simulation.instance->component && status < FMIFatal) {
+        FMI3FreeInstance(simulation.instance);
+    }
+
+    FMIFreeInstance(simulation.instance);
+
+TERMINATE:
+
+    if (statistics) {
+        *statistics = simulation.statistics;
+    }
+
+    return status;
+}
@@ -0,0 +1,406 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "FMI3Sweep.h"
+
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+// runs of a worker that have not been started yet
+typedef struct {
+    pthread_mutex_t mutex;
+    size_t begin;
+    size_t end;
+} Queue;
+
+typedef struct Sweep_ Sweep;
+
+typedef struct {
+    Sweep *sweep;
+    size_t index;
+    Queue queue;
+    FMIInstance *instance;
+    fmi3FMUState initialState;
+    bool initialized;
+    size_t nFailedRuns;
+    size_t nStolenRuns;
+} Worker;
+
+struct Sweep_ {
+    const FMI3SweepSettings *settings;
+    size_t nRuns;
+    const fmi3Float64 *parameterValues;
+    fmi3Float64 *outputValues;
+    FMIStatus *runStatus;
+    size_t nThreads;
+    Worker *workers;
+};
+
+static double currentTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// take the next run from the front of the own queue
+static bool popRun(Queue *queue, size_t *run) {
+
+    bool found = false;
+
+    pthread_mutex_lock(&queue->mutex);
+
+    if (queue->begin < queue->end) {
+        *run = queue->begin++;
+        found = true;
+    }
+
+    pthread_mutex_unlock(&queue->mutex);
+
+    return found;
+}
+
+// move the second half of the largest queue of the other workers to the own queue
+static bool stealRuns(Worker *worker) {
+
+    Sweep *sweep = worker->sweep;
+
+    Worker *victim = NULL;
+    size_t maxRuns = 1;
+
+    // the sizes are only hints to choose the victim
+    for (size_t i = 1; i < sweep->nThreads; i++) {
+
+        Worker *other = &sweep->workers[(worker->index + i) % sweep->nThreads];
+
+        pthread_mutex_lock(&other->queue.mutex);
+        const size_t nRuns = other->queue.end - other->queue.begin;
+        pthread_mutex_unlock(&other->queue.mutex);
+
+        if (nRuns > maxRuns || (nRuns > 0 && !victim)) {
+            victim = other;
+            maxRuns = nRuns;
+        }
+    }
+
+    if (!victim) {
+        return false;
+    }
+
+    size_t begin, end;
+
+    pthread_mutex_lock(&victim->queue.mutex);
+
+    const size_t nRuns = victim->queue.end - victim->queue.begin;
+    const size_t nStolen = (nRuns + 1) / 2;
+
+    end   = victim->queue.end;
+    begin = end - nStolen;
+
+    victim->queue.end = begin;
+
+    pthread_mutex_unlock(&victim->queue.mutex);
+
+    if (nStolen == 0) {
+        return true; // the queue has been emptied in the meantime, try again
+    }
+
+    pthread_mutex_lock(&worker->queue.mutex);
+    worker->queue.begin = begin;
+    worker->queue.end   = end;
+    pthread_mutex_unlock(&worker->queue.mutex);
+
+    worker->nStolenRuns += nStolen;
+
+    return true;
+}
+
+static bool nextRun(Worker *worker, size_t *run) {
+
+    while (!popRun(&worker->queue, run)) {
+        if (!stealRuns(worker)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static FMIStatus setParameters(Worker *worker, size_t run) {
+
+    const FMI3SweepSettings *s = worker->sweep->settings;
+
+    if (s->nParameters == 0) {
+        return FMIOK;
+    }
+
+    return FMI3SetFloat64(worker->instance, s->parameters, s->nParameters, &worker->sweep->parameterValues[run * s->nParameters], s->nParameters);
+}
+
+static FMIStatus initialize(Worker *worker) {
+
+    const FMI3SweepSettings *s = worker->sweep->settings;
+
+    FMIStatus status = FMIOK;
+
+    CALL(FMI3EnterInitializationMode(worker->instance, fmi3False, 0, s->startTime, fmi3True, s->stopTime));
+    CALL(FMI3ExitInitializationMode(worker->instance));
+
+TERMINATE:
+    return status;
+}
+
+// bring the instance into Step Mode with the parameters of the run
+static FMIStatus prepareRun(Worker *worker, size_t run) {
+
+    const FMI3SweepSettings *s = worker->sweep->settings;
+
+    FMIStatus status = FMIOK;
+
+    if (s->mode == FMI3SweepRestoreFMUState) {
+
+        if (!worker->initialized) {
+            CALL(initialize(worker));
+            CALL(FMI3GetFMUState(worker->instance, &worker->initialState));
+            worker->initialized = true;
+        } else {
+            CALL(FMI3SetFMUState(worker->instance, worker->initialState));
+        }
+
+        CALL(setParameters(worker, run));
+
+    } else {
+
+        if (worker->initialized) {
+            CALL(FMI3Reset(worker->instance));
+        }
+
+        CALL(setParameters(worker, run));
+        CALL(initialize(worker));
+
+        worker->initialized = true;
+    }
+
+TERMINATE:
+    return status;
+}
+
+static FMIStatus simulate(Worker *worker, size_t run) {
+
+    Sweep *sweep = worker->sweep;
+    const FMI3SweepSettings *s = sweep->settings;
+
+    FMIStatus status = FMIOK;
+
+    fmi3Boolean eventEncountered, terminateSimulation = fmi3False, earlyReturn;
+    fmi3Float64 lastSuccessfulTime;
+    fmi3Float64 time = s->startTime;
+    size_t nSteps = 0;
+
+    CALL(prepareRun(worker, run));
+
+    while (time < s->stopTime && !terminateSimulation) {
+
+        CALL(FMI3DoStep(worker->instance, time, s->communicationStepSize, fmi3True, &eventEncountered, &terminateSimulation, &earlyReturn, &lastSuccessfulTime));
+
+        nSteps++;
+        time = s->startTime + nSteps * s->communicationStepSize;
+    }
+
+    for (size_t i = 0; i < s->nOutputs; i++) {
+        CALL(FMI3GetFloat64(worker->instance, &s->outputs[i], 1, &sweep->outputValues[i * sweep->nRuns + run], 1));
+    }
+
+    if (s->mode == FMI3SweepReset) {
+        CALL(FMI3Terminate(worker->instance));
+    }
+
+TERMINATE:
+    return status;
+}
+
+static void *runWorker(void *arg) {
+
+    Worker *worker = arg;
+    Sweep *sweep = worker->sweep;
+    const FMI3SweepSettings *s = sweep->settings;
+
+    FMIStatus status = FMIOK;
+    size_t run;
+
+    while (nextRun(worker, &run)) {
+
+        if (!worker->instance) {
+
+            char instanceName[32];
+
+            snprintf(instanceName, sizeof(instanceName), "worker%zu", worker->index);
+
+            worker->instance = FMICreateInstance(instanceName, s->libraryPath, s->logMessage, NULL);
+
+            if (worker->instance) {
+                status = FMI3InstantiateCoSimulation(worker->instance, s->instantiationToken, NULL, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL);
+            } else {
+                status = FMIFatal;
+            }
+        }
+
+        if (status <= FMIWarning) {
+            status = simulate(worker, run);
+        }
+
+        if (sweep->runStatus) {
+            sweep->runStatus[run] = status;
+        }
+
+        if (status > FMIWarning) {
+            worker->nFailedRuns++;
+        }
+
+        for (size_t i = 0; status > FMIWarning && i < s->nOutputs; i++) {
+            sweep->outputValues[i * sweep->nRuns + run] = 0;
+        }
+
+        if (status > FMIWarning && worker->instance && worker->instance->component) {
+
+            // start over with a new instance
+            if (worker->initialState) {
+                FMI3FreeFMUState(worker->instance, &worker->initialState);
+            }
+
+            FMI3FreeInstance(worker->instance);
+
+            worker->initialized = false;
+
+            status = FMI3InstantiateCoSimulation(worker->instance, s->instantiationToken, NULL, fmi3False, fmi3False, fmi3False, fmi3False, NULL, 0, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+FMIStatus FMI3RunSweep(const FMI3SweepSettings *settings,
+    size_t nRuns,
+    const fmi3Float64 parameterValues[],
+    fmi3Float64 outputValues[],
+    FMIStatus runStatus[],
+    FMI3SweepStatistics *statistics) {
+
+    if (settings->communicationStepSize <= 0 ||
+        (settings->mode != FMI3SweepReset && settings->mode != FMI3SweepRestoreFMUState)) {
+        return FMIError;
+    }
+
+    size_t nThreads = settings->nThreads;
+
+    if (nThreads == 0) {
+        long nProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+        nThreads = nProcessors > 0 ? (size_t)nProcessors : 1;
+    }
+
+    if (nThreads > nRuns) {
+        nThreads = nRuns > 0 ? nRuns : 1;
+    }
+
+    Sweep sweep = {
+        .settings        = settings,
+        .nRuns           = nRuns,
+        .parameterValues = parameterValues,
+        .outputValues    = outputValues,
+        .runStatus       = runStatus,
+        .nThreads        = nThreads,
+        .workers         = calloc(nThreads, sizeof(Worker))
+    };
+
+    pthread_t *threads = calloc(nThreads, sizeof(pthread_t));
+
+    if (!sweep.workers || !threads) {
+        free(sweep.workers);
+        free(threads);
+        return FMIError;
+    }
+
+    // distribute the runs evenly
+    for (size_t i = 0; i < nThreads; i++) {
+        Worker *worker = &sweep.workers[i];
+        worker->sweep       = &sweep;
+        worker->index       = i;
+        worker->queue.begin = i * nRuns / nThreads;
+        worker->queue.end   = (i + 1) * nRuns / nThreads;
+        pthread_mutex_init(&worker->queue.mutex, NULL);
+    }
+
+    const double start = currentTime();
+
+    size_t nStarted = 1;
+
+    // the calling thread is worker 0
+    for (; nStarted < nThreads; nStarted++) {
+        if (pthread_create(&threads[nStarted], NULL, runWorker, &sweep.workers[nStarted]) != 0) {
+            break;
+        }
+    }
+
+    runWorker(&sweep.workers[0]);
+
+    for (size_t i = 1; i < nStarted; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // runs of workers that could not be started have been stolen by the others
+    const double elapsedTime = currentTime() - start;
+
+    FMIStatus status = FMIOK;
+    size_t nFailedRuns = 0;
+    size_t nStolenRuns = 0;
+
+    for (size_t i = 0; i < nThreads; i++) {
+
+        Worker *worker = &sweep.workers[i];
+
+        if (worker->instance) {
+
+            if (worker->instance->component) {
+
+                if (worker->initialState) {
+                    FMI3FreeFMUState(worker->instance, &worker->initialState);
+                }
+
+                FMI3FreeInstance(worker->instance);
+            }
+
+            FMIFreeInstance(worker->instance);
+        }
+
+        nFailedRuns += worker->nFailedRuns;
+        nStolenRuns += worker->nStolenRuns;
+
+        pthread_mutex_destroy(&worker->queue.mutex);
+    }
+
+    if (nFailedRuns > 0) {
+        status = FMIError;
+    }
+
+    if (statistics) {
+        statistics->nRuns       = nRuns;
+        statistics->nFailedRuns = nFailedRuns;
+        statistics->nThreads    = nStarted;
+        statistics->nStolenRuns = nStolenRuns;
+        statistics->elapsedTime = elapsedTime;
+    }
+
+    free(sweep.workers);
+    free(threads);
+
+    return status;
+}
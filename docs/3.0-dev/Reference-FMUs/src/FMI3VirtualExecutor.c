@@ -0,0 +1,369 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "FMI3ClockScheduler.h"
+#include "FMI3VirtualExecutor.h"
+
+
+#define CALL(f) status = f; if (status > FMIWarning) goto TERMINATE;
+
+// maximum number of released activations per task that have not finished yet
+#define MAX_PENDING 16
+
+typedef struct {
+    FMI3VirtualJob job;
+    fmi3Float64 remainingTime;
+    bool started;
+} Job;
+
+typedef struct {
+    FMI3ExecutorTask task;
+    Job pending[MAX_PENDING];
+    size_t head;
+    size_t nPending;
+    FMI3VirtualTaskStatistics statistics;
+} Task;
+
+struct FMI3VirtualExecutor_ {
+
+    FMIInstance *instance;
+
+    Task *tasks; // by descending priority
+    size_t nTasks;
+
+    FMI3VirtualJobCallback *jobFinished;
+    void *userData;
+
+    FMI3ClockScheduler *scheduler;
+
+    bool running;
+    fmi3Float64 time;
+    fmi3Float64 stopTime;
+};
+
+static Task *findTask(FMI3VirtualExecutor *executor, fmi3ValueReference clockReference) {
+
+    for (size_t i = 0; i < executor->nTasks; i++) {
+        if (executor->tasks[i].task.clockReference == clockReference) {
+            return &executor->tasks[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void release(FMI3VirtualExecutor *executor, Task *task, fmi3Float64 activationTime) {
+
+    FMI3VirtualTaskStatistics *s = &task->statistics;
+
+    if (task->nPending > 0) {
+        s->nOverruns++;
+    }
+
+    if (task->nPending == MAX_PENDING) {
+        s->nDropped++;
+        return;
+    }
+
+    Job *job = &task->pending[(task->head + task->nPending) % MAX_PENDING];
+
+    job->job.clockReference = task->task.clockReference;
+    job->job.activationTime = activationTime;
+    job->job.releaseTime    = executor->time;
+    job->job.startTime      = NAN;
+    job->job.finishTime     = NAN;
+    job->job.nPreemptions   = 0;
+    job->remainingTime      = task->task.executionTime;
+    job->started            = false;
+
+    task->nPending++;
+}
+
+// the oldest activation of the task with the highest priority
+static Task *selectTask(FMI3VirtualExecutor *executor) {
+
+    for (size_t i = 0; i < executor->nTasks; i++) {
+        if (executor->tasks[i].nPending > 0) {
+            return &executor->tasks[i];
+        }
+    }
+
+    return NULL;
+}
+
+static FMIStatus start(FMI3VirtualExecutor *executor, Task *task, Job *job) {
+
+    const FMI3ExecutorTask *t = &task->task;
+
+    FMIStatus status = FMIOK;
+
+    job->started = true;
+    job->job.startTime = executor->time;
+
+    task->statistics.maxLatency = fmax(task->statistics.maxLatency, job->job.startTime - job->job.releaseTime);
+
+    if (t->beforeActivation) {
+        CALL(t->beforeActivation(executor->instance, t->clockReference, job->job.activationTime, t->userData));
+    }
+
+    CALL(FMI3ActivateModelPartition(executor->instance, t->clockReference, 0, job->job.activationTime));
+
+TERMINATE:
+    return status;
+}
+
+static FMIStatus finish(FMI3VirtualExecutor *executor, Task *task, Job *job) {
+
+    const FMI3ExecutorTask *t = &task->task;
+    FMI3VirtualTaskStatistics *s = &task->statistics;
+
+    FMIStatus status = FMIOK;
+
+    job->job.finishTime = executor->time;
+
+    const fmi3Float64 responseTime = job->job.finishTime - job->job.releaseTime;
+
+    s->nActivations++;
+    s->nPreemptions     += job->job.nPreemptions;
+    s->maxResponseTime   = fmax(s->maxResponseTime, responseTime);
+    s->totalResponseTime += responseTime;
+
+    if (t->interval > 0 && responseTime > t->interval) {
+        s->nDeadlineMisses++;
+    }
+
+    if (t->afterActivation) {
+        CALL(t->afterActivation(executor->instance, t->clockReference, job->job.activationTime, t->userData));
+    }
+
+    if (executor->jobFinished) {
+        executor->jobFinished(&job->job, executor->userData);
+    }
+
+TERMINATE:
+    task->head = (task->head + 1) % MAX_PENDING;
+    task->nPending--;
+
+    return status;
+}
+
+FMI3VirtualExecutor *FMI3CreateVirtualExecutor(FMIInstance *instance,
+    const FMI3ExecutorTask tasks[],
+    size_t nTasks,
+    FMI3VirtualJobCallback *jobFinished,
+    void *userData) {
+
+    if (!instance || nTasks == 0) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < nTasks; i++) {
+
+        if (tasks[i].interval < 0 || tasks[i].shift < 0 || !(tasks[i].executionTime >= 0)) {
+            return NULL;
+        }
+
+        for (size_t j = 0; j < i; j++) {
+            if (tasks[i].clockReference == tasks[j].clockReference) {
+                return NULL;
+            }
+        }
+    }
+
+    FMI3VirtualExecutor *executor = calloc(1, sizeof(FMI3VirtualExecutor));
+    Task *sorted = calloc(nTasks, sizeof(Task));
+    FMI3ClockScheduler *scheduler = FMI3CreateClockScheduler();
+
+    if (!executor || !sorted || !scheduler) {
+        free(executor);
+        free(sorted);
+        FMI3FreeClockScheduler(scheduler);
+        return NULL;
+    }
+
+    executor->instance    = instance;
+    executor->tasks       = sorted;
+    executor->nTasks      = nTasks;
+    executor->jobFinished = jobFinished;
+    executor->userData    = userData;
+    executor->scheduler   = scheduler;
+
+    // insertion sort by clock priority (lower value = higher priority)
+    for (size_t i = 0; i < nTasks; i++) {
+
+        size_t j = i;
+
+        while (j > 0 && sorted[j - 1].task.priority > tasks[i].priority) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+
+        sorted[j].task = tasks[i];
+    }
+
+    return executor;
+}
+
+void FMI3FreeVirtualExecutor(FMI3VirtualExecutor *executor) {
+
+    if (!executor) {
+        return;
+    }
+
+    FMI3FreeClockScheduler(executor->scheduler);
+
+    free(executor->tasks);
+    free(executor);
+}
+
+FMIStatus FMI3VirtualExecutorRun(FMI3VirtualExecutor *executor, fmi3Float64 startTime, fmi3Float64 stopTime) {
+
+    if (!executor || executor->running || !(stopTime >= startTime)) {
+        return FMIError;
+    }
+
+    FMIStatus status = FMIOK;
+
+    executor->running  = true;
+    executor->time     = startTime;
+    executor->stopTime = stopTime;
+
+    for (size_t i = 0; i < executor->nTasks; i++) {
+
+        Task *task = &executor->tasks[i];
+
+        if (task->task.interval > 0) {
+            CALL(FMI3ClockSchedulerAddPeriodicClock(executor->scheduler, executor->instance,
+                task->task.clockReference, task->task.priority, task->task.interval, startTime + task->task.shift, task));
+        }
+    }
+
+    Task *running = NULL;
+
+    for (;;) {
+
+        FMI3ClockEvent event;
+
+        // release the due activations
+        while (FMI3ClockSchedulerPop(executor->scheduler, executor->time, &event)) {
+            if (event.time < stopTime) {
+                release(executor, event.userData, event.time);
+            }
+        }
+
+        Task *task = selectTask(executor);
+
+        // the running activation is preempted by one with a higher priority
+        if (running && running != task && running->nPending > 0 && running->pending[running->head].started) {
+            running->pending[running->head].job.nPreemptions++;
+        }
+
+        running = task;
+
+        fmi3Float64 nextTime = FMI3ClockSchedulerNextTime(executor->scheduler);
+
+        if (!(nextTime < stopTime)) {
+            nextTime = INFINITY;
+        }
+
+        if (!task) {
+
+            if (isinf(nextTime)) {
+                break;
+            }
+
+            executor->time = nextTime;
+            continue;
+        }
+
+        Job *job = &task->pending[task->head];
+
+        if (!job->started) {
+            // the activation may trigger other clocks
+            CALL(start(executor, task, job));
+            continue;
+        }
+
+        const fmi3Float64 finishTime = executor->time + job->remainingTime;
+
+        if (nextTime < finishTime) {
+            job->remainingTime -= nextTime - executor->time;
+            executor->time = nextTime;
+            continue;
+        }
+
+        executor->time = finishTime;
+        job->remainingTime = 0;
+
+        CALL(finish(executor, task, job));
+
+        running = NULL;
+    }
+
+TERMINATE:
+
+    // discard the activations after stopTime or after an error
+    FMI3ClockSchedulerClear(executor->scheduler);
+
+    for (size_t i = 0; i < executor->nTasks; i++) {
+        executor->tasks[i].nPending = 0;
+    }
+
+    executor->running = false;
+
+    return status;
+}
+
+FMIStatus FMI3VirtualExecutorTrigger(FMI3VirtualExecutor *executor, fmi3ValueReference clockReference, fmi3Float64 activationTime) {
+
+    if (!executor) {
+        return FMIError;
+    }
+
+    Task *task = findTask(executor, clockReference);
+
+    if (!task || isnan(activationTime)) {
+        return FMIError;
+    }
+
+    // activations in the past are released immediately
+    if (executor->running && activationTime <= executor->time) {
+
+        if (activationTime < executor->stopTime) {
+            release(executor, task, activationTime);
+        }
+
+        return FMIOK;
+    }
+
+    return FMI3ClockSchedulerAddEvent(executor->scheduler, executor->instance,
+        clockReference, task->task.priority, activationTime, task);
+}
+
+fmi3Float64 FMI3VirtualExecutorGetTime(const FMI3VirtualExecutor *executor) {
+    return executor->time;
+}
+
+FMIStatus FMI3VirtualExecutorGetStatistics(FMI3VirtualExecutor *executor, fmi3ValueReference clockReference, FMI3VirtualTaskStatistics *statistics) {
+
+    if (!executor || !statistics) {
+        return FMIError;
+    }
+
+    Task *task = findTask(executor, clockReference);
+
+    if (!task) {
+        return FMIError;
+    }
+
+    *statistics = task->statistics;
+
+    return FMIOK;
+}
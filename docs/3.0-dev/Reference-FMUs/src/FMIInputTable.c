@@ -0,0 +1,644 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FMIInputTable.h"
+
+
+// maximum length of a number in a CSV file
+#define MAX_FIELD_LENGTH 64
+
+typedef struct {
+    int32_t type;
+    int32_t mrows;
+    int32_t ncols;
+    int32_t imagf;
+    int32_t namlen;
+} MatrixHeader;
+
+struct FMIInputTable_ {
+
+    // mapped file
+    const char *data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    char **names;
+    bool *discrete;
+    size_t nColumns;
+    size_t nRows;
+
+    // CSV: time and offset of every row
+    double *times;
+    size_t *offsets;
+
+    // MAT: samples of nColumns doubles
+    const char *samples;
+
+    double *eventTimes;
+    size_t nEventTimes;
+
+    // last row returned by findRow() and last index into eventTimes
+    size_t cursor;
+    size_t eventCursor;
+};
+
+static bool mapFile(FMIInputTable *table, const char *filename) {
+
+#ifdef _WIN32
+    table->file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    if (table->file == INVALID_HANDLE_VALUE) {
+        table->file = NULL;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(table->file, &size) || size.QuadPart == 0) {
+        return false;
+    }
+
+    table->size = (size_t)size.QuadPart;
+
+    table->mapping = CreateFileMappingA(table->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (!table->mapping) {
+        return false;
+    }
+
+    table->data = MapViewOfFile(table->mapping, FILE_MAP_READ, 0, 0, 0);
+
+    return table->data != NULL;
+#else
+    const int fd = open(filename, O_RDONLY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    table->size = (size_t)st.st_size;
+
+    void *data = mmap(NULL, table->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping stays valid after the file has been closed
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    // the index is built in one pass
+    madvise(data, table->size, MADV_SEQUENTIAL);
+
+    table->data = data;
+
+    return true;
+#endif
+}
+
+static void unmapFile(FMIInputTable *table) {
+
+#ifdef _WIN32
+    if (table->data) {
+        UnmapViewOfFile(table->data);
+    }
+
+    if (table->mapping) {
+        CloseHandle(table->mapping);
+    }
+
+    if (table->file) {
+        CloseHandle(table->file);
+    }
+#else
+    if (table->data) {
+        munmap((void *)table->data, table->size);
+    }
+#endif
+}
+
+static const char *endOfLine(const char *p, const char *end) {
+    const char *eol = memchr(p, '\n', end - p);
+    return eol ? eol : end;
+}
+
+// parse the number in [p, end) up to the next separator
+static double parseField(const char *p, const char *end) {
+
+    char buffer[MAX_FIELD_LENGTH];
+    size_t length = 0;
+
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+
+    while (p < end && *p != ',' && *p != '\n' && *p != '\r' && length < MAX_FIELD_LENGTH - 1) {
+        buffer[length++] = *p++;
+    }
+
+    buffer[length] = '\0';
+
+    if (length == 0) {
+        return NAN;
+    }
+
+    if (!strcmp(buffer, "true")) {
+        return 1;
+    }
+
+    if (!strcmp(buffer, "false")) {
+        return 0;
+    }
+
+    return strtod(buffer, NULL);
+}
+
+// the mapped samples of a MAT file are not aligned
+static double sampleValue(const FMIInputTable *table, size_t row, size_t column) {
+    double value;
+    memcpy(&value, table->samples + (row * table->nColumns + column) * sizeof(double), sizeof(double));
+    return value;
+}
+
+static double rowTime(const FMIInputTable *table, size_t row) {
+    return table->times ? table->times[row] : sampleValue(table, row, 0);
+}
+
+static double rowValue(const FMIInputTable *table, size_t row, size_t column) {
+
+    if (table->samples) {
+        return sampleValue(table, row, column);
+    }
+
+    const char *end = table->data + table->size;
+    const char *p = table->data + table->offsets[row];
+
+    for (size_t i = 0; i < column; i++) {
+
+        while (p < end && *p != ',' && *p != '\n') {
+            p++;
+        }
+
+        if (p == end || *p == '\n') {
+            return NAN;
+        }
+
+        p++;
+    }
+
+    return parseField(p, end);
+}
+
+static bool addColumnName(FMIInputTable *table, const char *name, size_t length) {
+
+    while (length > 0 && (name[length - 1] == ' ' || name[length - 1] == '\r')) {
+        length--;
+    }
+
+    while (length > 0 && *name == ' ') {
+        name++;
+        length--;
+    }
+
+    char **names = realloc(table->names, (table->nColumns + 1) * sizeof(char *));
+
+    if (!names) {
+        return false;
+    }
+
+    table->names = names;
+
+    char *copy = malloc(length + 1);
+
+    if (!copy) {
+        return false;
+    }
+
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+
+    table->names[table->nColumns++] = copy;
+
+    return true;
+}
+
+static bool indexCSV(FMIInputTable *table) {
+
+    const char *p = table->data;
+    const char *end = table->data + table->size;
+
+    // header
+    const char *eol = endOfLine(p, end);
+
+    while (p <= eol) {
+
+        const char *separator = memchr(p, ',', eol - p);
+
+        if (!separator) {
+            separator = eol;
+        }
+
+        if (!addColumnName(table, p, separator - p)) {
+            return false;
+        }
+
+        p = separator + 1;
+    }
+
+    // rows
+    size_t capacity = 0;
+
+    for (p = eol + 1; p < end; p = eol + 1) {
+
+        eol = endOfLine(p, end);
+
+        if (eol == p || (eol - p == 1 && *p == '\r')) {
+            continue; // empty line
+        }
+
+        if (table->nRows == capacity) {
+
+            capacity = capacity > 0 ? 2 * capacity : 1024;
+
+            double *times = realloc(table->times, capacity * sizeof(double));
+
+            if (!times) {
+                return false;
+            }
+
+            table->times = times;
+
+            size_t *offsets = realloc(table->offsets, capacity * sizeof(size_t));
+
+            if (!offsets) {
+                return false;
+            }
+
+            table->offsets = offsets;
+        }
+
+        table->times[table->nRows] = parseField(p, end);
+        table->offsets[table->nRows] = p - table->data;
+        table->nRows++;
+    }
+
+    return true;
+}
+
+static bool indexMAT(FMIInputTable *table) {
+
+    const char *p = table->data;
+    const char *end = table->data + table->size;
+
+    MatrixHeader header;
+
+    // text matrix with the names as rows, stored column by column and padded with blanks
+    if (end - p < (ptrdiff_t)(sizeof(header) + 5)) {
+        return false;
+    }
+
+    memcpy(&header, p, sizeof(header));
+    p += sizeof(header) + header.namlen;
+
+    const size_t nNames = header.mrows;
+    const size_t maxLength = header.ncols;
+
+    if (header.mrows < 1 || header.ncols < 0 || end - p < (ptrdiff_t)(nNames * maxLength)) {
+        return false;
+    }
+
+    char buffer[256];
+
+    for (size_t i = 0; i < nNames; i++) {
+
+        size_t length = 0;
+
+        for (size_t j = 0; j < maxLength && length < sizeof(buffer); j++) {
+            buffer[length++] = p[j * nNames + i];
+        }
+
+        if (!addColumnName(table, buffer, length)) {
+            return false;
+        }
+    }
+
+    p += nNames * maxLength;
+
+    // data matrix with one sample per column
+    if (end - p < (ptrdiff_t)sizeof(header)) {
+        return false;
+    }
+
+    memcpy(&header, p, sizeof(header));
+    p += sizeof(header) + header.namlen;
+
+    if (header.type != 0 || (size_t)header.mrows != nNames || header.ncols < 0 ||
+        (size_t)(end - p) < (size_t)header.ncols * nNames * sizeof(double)) {
+        return false;
+    }
+
+    table->samples = p;
+    table->nRows = header.ncols;
+
+    return true;
+}
+
+static bool isMAT(const FMIInputTable *table) {
+
+    MatrixHeader header;
+
+    if (table->size < sizeof(header) + 5) {
+        return false;
+    }
+
+    memcpy(&header, table->data, sizeof(header));
+
+    // little endian text matrix with uint8 characters named "name"
+    return header.type == 51 && header.namlen == 5 && !memcmp(table->data + sizeof(header), "name", 5);
+}
+
+static bool findEvents(FMIInputTable *table) {
+
+    size_t capacity = 0;
+    double previousEventTime = NAN;
+
+    for (size_t i = 1; i < table->nRows; i++) {
+
+        const double time = rowTime(table, i);
+        const double previousTime = rowTime(table, i - 1);
+
+        if (time < previousTime) {
+            return false;
+        }
+
+        bool event = time == previousTime;
+
+        for (size_t j = 1; j < table->nColumns && !event; j++) {
+            if (table->discrete[j]) {
+                event = rowValue(table, i, j) != rowValue(table, i - 1, j);
+            }
+        }
+
+        if (!event || time == previousEventTime) {
+            continue;
+        }
+
+        if (table->nEventTimes == capacity) {
+
+            capacity = capacity > 0 ? 2 * capacity : 64;
+
+            double *eventTimes = realloc(table->eventTimes, capacity * sizeof(double));
+
+            if (!eventTimes) {
+                return false;
+            }
+
+            table->eventTimes = eventTimes;
+        }
+
+        table->eventTimes[table->nEventTimes++] = time;
+        previousEventTime = time;
+    }
+
+    return true;
+}
+
+FMIInputTable *FMIOpenInputTable(const char *filename, const char *discreteColumns[], size_t nDiscreteColumns) {
+
+    FMIInputTable *table = calloc(1, sizeof(FMIInputTable));
+
+    if (!table) {
+        return NULL;
+    }
+
+    if (!mapFile(table, filename)) {
+        goto FAIL;
+    }
+
+    if (!(isMAT(table) ? indexMAT(table) : indexCSV(table))) {
+        goto FAIL;
+    }
+
+    if (table->nColumns < 1 || table->nRows < 1) {
+        goto FAIL;
+    }
+
+    table->discrete = calloc(table->nColumns, sizeof(bool));
+
+    if (!table->discrete) {
+        goto FAIL;
+    }
+
+    for (size_t i = 0; i < nDiscreteColumns; i++) {
+
+        size_t column;
+
+        if (!FMIInputTableFindColumn(table, discreteColumns[i], &column)) {
+            goto FAIL;
+        }
+
+        table->discrete[column] = true;
+    }
+
+    if (!findEvents(table)) {
+        goto FAIL;
+    }
+
+    return table;
+
+FAIL:
+    FMICloseInputTable(table);
+    return NULL;
+}
+
+void FMICloseInputTable(FMIInputTable *table) {
+
+    if (!table) {
+        return;
+    }
+
+    unmapFile(table);
+
+    for (size_t i = 0; i < table->nColumns; i++) {
+        free(table->names[i]);
+    }
+
+    free(table->names);
+    free(table->discrete);
+    free(table->times);
+    free(table->offsets);
+    free(table->eventTimes);
+    free(table);
+}
+
+size_t FMIInputTableRowCount(const FMIInputTable *table) {
+    return table->nRows;
+}
+
+bool FMIInputTableFindColumn(const FMIInputTable *table, const char *name, size_t *column) {
+
+    for (size_t i = 0; i < table->nColumns; i++) {
+        if (!strcmp(table->names[i], name)) {
+            *column = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// last row with a time <= time (0 if time is before the first row)
+static size_t findRow(FMIInputTable *table, double time) {
+
+    const size_t n = table->nRows;
+    size_t i = table->cursor;
+
+    // the time has not moved beyond the next row
+    if (rowTime(table, i) <= time) {
+
+        if (i + 1 == n || rowTime(table, i + 1) > time) {
+            return i;
+        }
+
+        if (i + 2 == n || rowTime(table, i + 2) > time) {
+            table->cursor = i + 1;
+            return i + 1;
+        }
+    }
+
+    // binary search for the first row with a time > time
+    size_t low = 0, high = n;
+
+    while (low < high) {
+
+        const size_t middle = low + (high - low) / 2;
+
+        if (rowTime(table, middle) <= time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    table->cursor = low > 0 ? low - 1 : 0;
+
+    return table->cursor;
+}
+
+double FMIInputTableNextEventTime(FMIInputTable *table, double time) {
+
+    size_t i = table->eventCursor;
+
+    if (i > 0 && i <= table->nEventTimes && table->eventTimes[i - 1] >= time) {
+        i = 0; // the time has moved backwards
+    }
+
+    while (i < table->nEventTimes && table->eventTimes[i] < time) {
+
+        // binary search if the cursor is far behind
+        if (i + 8 < table->nEventTimes && table->eventTimes[i + 8] < time) {
+
+            size_t low = i + 8, high = table->nEventTimes;
+
+            while (low < high) {
+
+                const size_t middle = low + (high - low) / 2;
+
+                if (table->eventTimes[middle] < time) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+
+            i = low;
+            break;
+        }
+
+        i++;
+    }
+
+    table->eventCursor = i;
+
+    return i < table->nEventTimes ? table->eventTimes[i] : INFINITY;
+}
+
+FMIStatus FMIInputTableGetValues(FMIInputTable *table,
+    double time,
+    bool afterEvent,
+    const size_t columns[],
+    size_t nColumns,
+    double values[]) {
+
+    if (!table || isnan(time)) {
+        return FMIError;
+    }
+
+    for (size_t i = 0; i < nColumns; i++) {
+        if (columns[i] >= table->nColumns) {
+            return FMIError;
+        }
+    }
+
+    // last row at or before time
+    const size_t right = findRow(table, time);
+    const double rightTime = rowTime(table, right);
+
+    // first row at time (before the discontinuity)
+    size_t left = right;
+
+    if (!afterEvent) {
+        while (left > 0 && rowTime(table, left - 1) == time) {
+            left--;
+        }
+    }
+
+    for (size_t i = 0; i < nColumns; i++) {
+
+        const size_t column = columns[i];
+
+        if (table->discrete[column] || time <= rightTime || right + 1 == table->nRows) {
+            values[i] = rowValue(table, table->discrete[column] ? right : left, column);
+            continue;
+        }
+
+        // time is between the rows right and right + 1
+        const double t0 = rightTime;
+        const double t1 = rowTime(table, right + 1);
+        const double v0 = rowValue(table, right, column);
+        const double v1 = rowValue(table, right + 1, column);
+
+        values[i] = v0 + (v1 - v0) * (time - t0) / (t1 - t0);
+    }
+
+    return FMIOK;
+}
@@ -0,0 +1,472 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "FMIRecorder.h"
+
+
+#define DEFAULT_BUFFER_SIZE (1 << 20)
+#define DEFAULT_N_BUFFERS   4
+
+// number of samples that are converted at once by FMIRecorderExportCSV()
+#define EXPORT_CHUNK_SIZE 4096
+
+typedef struct {
+    int32_t type;
+    int32_t mrows;
+    int32_t ncols;
+    int32_t imagf;
+    int32_t namlen;
+} MatrixHeader;
+
+typedef struct {
+    double *data;
+    size_t nSamples;
+    bool full;
+} Buffer;
+
+struct FMIRecorder_ {
+
+    FILE *file;
+    long ncolsOffset; // position of "ncols" of the data matrix
+
+    size_t nRows;  // time + variables
+    size_t decimation;
+    bool eventsOnly;
+    size_t samplesSinceEvent;
+
+    Buffer *buffers;
+    size_t nBuffers;
+    size_t bufferCapacity; // samples per buffer
+    size_t current;        // buffer that is filled by FMIRecorderSample()
+
+    FMIRecorderStatistics statistics;
+
+    // protects the fields below
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t thread;
+    bool started;
+    size_t next; // next buffer to write
+    bool stop;
+    FMIStatus status;
+};
+
+// MAT v4 type of a matrix in the byte order of the host (M = 0: little endian, 1: big endian)
+static int32_t matrixType(int32_t precision, int32_t text) {
+    const uint16_t one = 1;
+    const int32_t M = *(const uint8_t *)&one == 1 ? 0 : 1;
+    return M * 1000 + precision * 10 + text;
+}
+
+static bool writeMatrixHeader(FILE *file, const char *name, int32_t type, size_t mrows, size_t ncols) {
+
+    const MatrixHeader header = {
+        .type   = type,
+        .mrows  = (int32_t)mrows,
+        .ncols  = (int32_t)ncols,
+        .imagf  = 0,
+        .namlen = (int32_t)strlen(name) + 1
+    };
+
+    return fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(name, header.namlen, 1, file) == 1;
+}
+
+static bool readMatrixHeader(FILE *file, const char *name, MatrixHeader *header) {
+
+    char buffer[64];
+
+    if (fread(header, sizeof(MatrixHeader), 1, file) != 1 || header->namlen < 1 || header->namlen > (int32_t)sizeof(buffer) ||
+        header->mrows < 0 || header->ncols < 0 || header->imagf != 0) {
+        return false;
+    }
+
+    if (fread(buffer, header->namlen, 1, file) != 1) {
+        return false;
+    }
+
+    buffer[header->namlen - 1] = '\0';
+
+    return strcmp(buffer, name) == 0;
+}
+
+static void *writeBuffers(void *arg) {
+
+    FMIRecorder *recorder = arg;
+
+    pthread_mutex_lock(&recorder->mutex);
+
+    for (;;) {
+
+        Buffer *buffer = &recorder->buffers[recorder->next];
+
+        if (!buffer->full) {
+
+            if (recorder->stop) {
+                break;
+            }
+
+            pthread_cond_wait(&recorder->cond, &recorder->mutex);
+            continue;
+        }
+
+        pthread_mutex_unlock(&recorder->mutex);
+
+        // the buffer is owned by the writer until it is marked as empty
+        const size_t count = buffer->nSamples * recorder->nRows;
+        const bool success = fwrite(buffer->data, sizeof(double), count, recorder->file) == count;
+
+        pthread_mutex_lock(&recorder->mutex);
+
+        if (!success) {
+            recorder->status = FMIError;
+        }
+
+        buffer->nSamples = 0;
+        buffer->full = false;
+        recorder->next = (recorder->next + 1) % recorder->nBuffers;
+        recorder->statistics.nBuffersWritten++;
+
+        pthread_cond_broadcast(&recorder->cond);
+    }
+
+    pthread_mutex_unlock(&recorder->mutex);
+
+    return NULL;
+}
+
+// hand the current buffer over to the writer thread and wait for the next one to become empty
+static FMIStatus submitBuffer(FMIRecorder *recorder) {
+
+    FMIStatus status;
+
+    pthread_mutex_lock(&recorder->mutex);
+
+    recorder->buffers[recorder->current].full = true;
+    recorder->current = (recorder->current + 1) % recorder->nBuffers;
+
+    pthread_cond_broadcast(&recorder->cond);
+
+    if (recorder->buffers[recorder->current].full) {
+
+        recorder->statistics.nWaits++;
+
+        while (recorder->buffers[recorder->current].full) {
+            pthread_cond_wait(&recorder->cond, &recorder->mutex);
+        }
+    }
+
+    status = recorder->status;
+
+    pthread_mutex_unlock(&recorder->mutex);
+
+    return status;
+}
+
+static void freeRecorder(FMIRecorder *recorder) {
+
+    if (recorder->started) {
+        pthread_mutex_destroy(&recorder->mutex);
+        pthread_cond_destroy(&recorder->cond);
+    }
+
+    if (recorder->buffers) {
+        for (size_t i = 0; i < recorder->nBuffers; i++) {
+            free(recorder->buffers[i].data);
+        }
+    }
+
+    free(recorder->buffers);
+
+    if (recorder->file) {
+        fclose(recorder->file);
+    }
+
+    free(recorder);
+}
+
+FMIRecorder *FMICreateRecorder(const char *filename,
+    const char *names[],
+    size_t nVariables,
+    const FMIRecorderSettings *settings) {
+
+    if (!filename || (nVariables > 0 && !names)) {
+        return NULL;
+    }
+
+    const FMIRecorderSettings defaultSettings = { 0 };
+
+    if (!settings) {
+        settings = &defaultSettings;
+    }
+
+    FMIRecorder *recorder = calloc(1, sizeof(FMIRecorder));
+
+    if (!recorder) {
+        return NULL;
+    }
+
+    recorder->nRows      = nVariables + 1;
+    recorder->decimation = settings->decimation > 0 ? settings->decimation : 1;
+    recorder->eventsOnly = settings->eventsOnly;
+    recorder->nBuffers   = settings->nBuffers > 0 ? settings->nBuffers : DEFAULT_N_BUFFERS;
+
+    const size_t bufferSize = settings->bufferSize > 0 ? settings->bufferSize : DEFAULT_BUFFER_SIZE;
+    const size_t sampleSize = recorder->nRows * sizeof(double);
+
+    recorder->bufferCapacity = bufferSize > sampleSize ? bufferSize / sampleSize : 1;
+
+    recorder->buffers = calloc(recorder->nBuffers, sizeof(Buffer));
+
+    if (!recorder->buffers) {
+        goto FAIL;
+    }
+
+    for (size_t i = 0; i < recorder->nBuffers; i++) {
+
+        recorder->buffers[i].data = malloc(recorder->bufferCapacity * sampleSize);
+
+        if (!recorder->buffers[i].data) {
+            goto FAIL;
+        }
+    }
+
+    recorder->file = fopen(filename, "wb");
+
+    if (!recorder->file) {
+        goto FAIL;
+    }
+
+    // text matrix with the names as rows, stored column by column and padded with blanks
+    size_t maxLength = strlen("time");
+
+    for (size_t i = 0; i < nVariables; i++) {
+        const size_t length = strlen(names[i]);
+        if (length > maxLength) {
+            maxLength = length;
+        }
+    }
+
+    if (!writeMatrixHeader(recorder->file, "name", matrixType(5, 1), recorder->nRows, maxLength)) {
+        goto FAIL;
+    }
+
+    for (size_t j = 0; j < maxLength; j++) {
+        for (size_t i = 0; i < recorder->nRows; i++) {
+
+            const char *name = i == 0 ? "time" : names[i - 1];
+            const char c = j < strlen(name) ? name[j] : ' ';
+
+            if (fputc(c, recorder->file) == EOF) {
+                goto FAIL;
+            }
+        }
+    }
+
+    // the number of columns is written by FMIRecorderClose()
+    recorder->ncolsOffset = ftell(recorder->file) + (long)offsetof(MatrixHeader, ncols);
+
+    if (!writeMatrixHeader(recorder->file, "data", matrixType(0, 0), recorder->nRows, 0)) {
+        goto FAIL;
+    }
+
+    pthread_mutex_init(&recorder->mutex, NULL);
+    pthread_cond_init(&recorder->cond, NULL);
+
+    recorder->started = true;
+
+    if (pthread_create(&recorder->thread, NULL, writeBuffers, recorder) != 0) {
+        goto FAIL;
+    }
+
+    return recorder;
+
+FAIL:
+    freeRecorder(recorder);
+    return NULL;
+}
+
+FMIStatus FMIRecorderSample(FMIRecorder *recorder, double time, const double values[], bool event) {
+
+    if (!recorder) {
+        return FMIError;
+    }
+
+    recorder->statistics.nSamples++;
+
+    if (event) {
+        recorder->samplesSinceEvent = 0;
+    } else if (recorder->eventsOnly || recorder->samplesSinceEvent++ % recorder->decimation != 0) {
+        return FMIOK;
+    }
+
+    Buffer *buffer = &recorder->buffers[recorder->current];
+
+    double *sample = &buffer->data[buffer->nSamples * recorder->nRows];
+
+    sample[0] = time;
+
+    if (recorder->nRows > 1) {
+        memcpy(&sample[1], values, (recorder->nRows - 1) * sizeof(double));
+    }
+
+    buffer->nSamples++;
+    recorder->statistics.nRecorded++;
+
+    if (buffer->nSamples == recorder->bufferCapacity) {
+        return submitBuffer(recorder);
+    }
+
+    return FMIOK;
+}
+
+FMIStatus FMIRecorderClose(FMIRecorder *recorder, FMIRecorderStatistics *statistics) {
+
+    if (!recorder) {
+        return FMIError;
+    }
+
+    pthread_mutex_lock(&recorder->mutex);
+
+    if (recorder->buffers[recorder->current].nSamples > 0) {
+        recorder->buffers[recorder->current].full = true;
+    }
+
+    recorder->stop = true;
+
+    pthread_cond_broadcast(&recorder->cond);
+    pthread_mutex_unlock(&recorder->mutex);
+
+    pthread_join(recorder->thread, NULL);
+
+    FMIStatus status = recorder->status;
+
+    const int32_t ncols = (int32_t)recorder->statistics.nRecorded;
+
+    if (fseek(recorder->file, recorder->ncolsOffset, SEEK_SET) != 0 || fwrite(&ncols, sizeof(ncols), 1, recorder->file) != 1) {
+        status = FMIError;
+    }
+
+    if (fclose(recorder->file) != 0) {
+        status = FMIError;
+    }
+
+    recorder->file = NULL;
+
+    if (statistics) {
+        *statistics = recorder->statistics;
+    }
+
+    freeRecorder(recorder);
+
+    return status;
+}
+
+FMIStatus FMIRecorderExportCSV(const char *filename, const char *csvFilename) {
+
+    FMIStatus status = FMIError;
+
+    FILE *file = fopen(filename, "rb");
+    FILE *csvFile = NULL;
+    char *names = NULL;
+    double *data = NULL;
+
+    if (!file) {
+        goto TERMINATE;
+    }
+
+    MatrixHeader header;
+
+    if (!readMatrixHeader(file, "name", &header) || header.type != matrixType(5, 1)) {
+        goto TERMINATE;
+    }
+
+    const size_t nRows = header.mrows;
+    const size_t maxLength = header.ncols;
+
+    names = malloc(nRows * maxLength + 1);
+
+    if (!names || fread(names, 1, nRows * maxLength, file) != nRows * maxLength) {
+        goto TERMINATE;
+    }
+
+    if (!readMatrixHeader(file, "data", &header) || header.type != matrixType(0, 0) || (size_t)header.mrows != nRows) {
+        goto TERMINATE;
+    }
+
+    const size_t nSamples = header.ncols;
+
+    data = malloc(EXPORT_CHUNK_SIZE * nRows * sizeof(double));
+    csvFile = fopen(csvFilename, "w");
+
+    if (!data || !csvFile) {
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < nRows; i++) {
+
+        size_t length = maxLength;
+
+        // remove the padding
+        while (length > 0 && names[(length - 1) * nRows + i] == ' ') {
+            length--;
+        }
+
+        if (i > 0) {
+            fputc(',', csvFile);
+        }
+
+        for (size_t j = 0; j < length; j++) {
+            fputc(names[j * nRows + i], csvFile);
+        }
+    }
+
+    fputc('\n', csvFile);
+
+    for (size_t offset = 0; offset < nSamples; offset += EXPORT_CHUNK_SIZE) {
+
+        const size_t n = nSamples - offset < EXPORT_CHUNK_SIZE ? nSamples - offset : EXPORT_CHUNK_SIZE;
+
+        if (fread(data, sizeof(double) * nRows, n, file) != n) {
+            goto TERMINATE;
+        }
+
+        for (size_t k = 0; k < n; k++) {
+
+            const double *sample = &data[k * nRows];
+
+            for (size_t i = 0; i < nRows; i++) {
+                fprintf(csvFile, i > 0 ? ",%.16g" : "%.16g", sample[i]);
+            }
+
+            fputc('\n', csvFile);
+        }
+    }
+
+    status = FMIOK;
+
+TERMINATE:
+
+    if (csvFile && fclose(csvFile) != 0) {
+        status = FMIError;
+    }
+
+    if (file) {
+        fclose(file);
+    }
+
+    free(names);
+    free(data);
+
+    return status;
+}
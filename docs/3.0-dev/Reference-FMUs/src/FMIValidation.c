@@ -0,0 +1,505 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FMIValidation.h"
+
+
+struct FMIReference_ {
+
+    char **names; // column names without time
+    size_t nColumns;
+    size_t nRows;
+
+    double *time;
+
+    // column by column (nColumns x nRows)
+    double *values;
+    double *lower;
+    double *upper;
+
+    // the result resampled at the reference times
+    double *resampled;
+
+    // line buffer
+    char *line;
+    size_t lineSize;
+};
+
+// read a line of arbitrary length into reference->line
+static bool readLine(FMIReference *reference, FILE *file) {
+
+    size_t length = 0;
+
+    for (;;) {
+
+        if (reference->lineSize - length < 2) {
+
+            const size_t size = reference->lineSize > 0 ? 2 * reference->lineSize : 4096;
+
+            char *line = realloc(reference->line, size);
+
+            if (!line) {
+                return false;
+            }
+
+            reference->line = line;
+            reference->lineSize = size;
+        }
+
+        if (!fgets(reference->line + length, (int)(reference->lineSize - length), file)) {
+            return length > 0;
+        }
+
+        length += strlen(reference->line + length);
+
+        if (reference->line[length - 1] == '\n') {
+            return true;
+        }
+    }
+}
+
+// split the header into column names
+static char **parseHeader(char *line, size_t *nFields) {
+
+    char **names = NULL;
+    size_t n = 0;
+
+    for (char *p = line; p; ) {
+
+        char *separator = strchr(p, ',');
+
+        if (separator) {
+            *separator = '\0';
+        }
+
+        // trim blanks, quotes and the line break
+        while (*p == ' ' || *p == '"') {
+            p++;
+        }
+
+        size_t length = strlen(p);
+
+        while (length > 0 && strchr(" \"\r\n", p[length - 1])) {
+            length--;
+        }
+
+        char **newNames = realloc(names, (n + 1) * sizeof(char *));
+
+        if (!newNames) {
+            break;
+        }
+
+        names = newNames;
+        names[n] = malloc(length + 1);
+
+        if (!names[n]) {
+            break;
+        }
+
+        memcpy(names[n], p, length);
+        names[n][length] = '\0';
+        n++;
+
+        p = separator ? separator + 1 : NULL;
+    }
+
+    *nFields = n;
+
+    return names;
+}
+
+static void freeNames(char **names, size_t n) {
+
+    for (size_t i = 0; i < n; i++) {
+        free(names[i]);
+    }
+
+    free(names);
+}
+
+static bool parseRow(const char *line, double row[], size_t nFields) {
+
+    const char *p = line;
+
+    for (size_t i = 0; i < nFields; i++) {
+
+        char *end;
+
+        row[i] = strtod(p, &end);
+
+        if (end == p) {
+            return false;
+        }
+
+        p = end;
+
+        while (*p == ' ') {
+            p++;
+        }
+
+        if (i + 1 < nFields) {
+
+            if (*p != ',') {
+                return false;
+            }
+
+            p++;
+        }
+    }
+
+    return true;
+}
+
+FMIReference *FMILoadReference(const char *filename, const FMIValidationSettings *settings) {
+
+    FMIReference *reference = calloc(1, sizeof(FMIReference));
+    FILE *file = fopen(filename, "r");
+    double *rows = NULL;
+    double *row = NULL;
+
+    if (!reference || !file || !readLine(reference, file)) {
+        goto FAIL;
+    }
+
+    size_t nFields;
+    char **names = parseHeader(reference->line, &nFields);
+
+    if (!names || nFields < 1) {
+        freeNames(names, nFields);
+        goto FAIL;
+    }
+
+    // the first column is the time
+    free(names[0]);
+    memmove(names, names + 1, (nFields - 1) * sizeof(char *));
+
+    reference->names = names;
+    reference->nColumns = nFields - 1;
+
+    size_t capacity = 0;
+
+    row = malloc(nFields * sizeof(double));
+
+    if (!row) {
+        goto FAIL;
+    }
+
+    while (readLine(reference, file)) {
+
+        if (reference->line[0] == '\n' || reference->line[0] == '\r') {
+            continue;
+        }
+
+        if (!parseRow(reference->line, row, nFields)) {
+            goto FAIL;
+        }
+
+        if (reference->nRows == capacity) {
+
+            capacity = capacity > 0 ? 2 * capacity : 1024;
+
+            double *newRows = realloc(rows, capacity * nFields * sizeof(double));
+
+            if (!newRows) {
+                goto FAIL;
+            }
+
+            rows = newRows;
+        }
+
+        memcpy(&rows[reference->nRows * nFields], row, nFields * sizeof(double));
+        reference->nRows++;
+    }
+
+    const size_t n = reference->nRows;
+    const size_t m = reference->nColumns;
+
+    if (n == 0) {
+        goto FAIL;
+    }
+
+    reference->time      = malloc(n * sizeof(double));
+    reference->values    = malloc(n * m * sizeof(double) + 1);
+    reference->lower     = malloc(n * m * sizeof(double) + 1);
+    reference->upper     = malloc(n * m * sizeof(double) + 1);
+    reference->resampled = malloc(n * m * sizeof(double) + 1);
+
+    if (!reference->time || !reference->values || !reference->lower || !reference->upper || !reference->resampled) {
+        goto FAIL;
+    }
+
+    // transpose the rows to columns
+    for (size_t i = 0; i < n; i++) {
+
+        reference->time[i] = rows[i * nFields];
+
+        for (size_t j = 0; j < m; j++) {
+            reference->values[j * n + i] = rows[i * nFields + j + 1];
+        }
+    }
+
+    const double relTol = settings ? settings->relTol : 0;
+    const double absTol = settings ? settings->absTol : 0;
+    const double timeTolerance = settings ? settings->timeTolerance : 0;
+
+    for (size_t j = 0; j < m; j++) {
+
+        const double *v = &reference->values[j * n];
+
+        double maxAbs = 0;
+
+        for (size_t i = 0; i < n; i++) {
+            const double a = fabs(v[i]);
+            maxAbs = a > maxAbs ? a : maxAbs;
+        }
+
+        const double tolerance = absTol + relTol * maxAbs;
+
+        // the tube spans the samples within the time tolerance
+        for (size_t i = 0; i < n; i++) {
+
+            double lower = v[i], upper = v[i];
+
+            for (size_t k = i; k > 0 && reference->time[i] - reference->time[k - 1] <= timeTolerance; k--) {
+                lower = fmin(lower, v[k - 1]);
+                upper = fmax(upper, v[k - 1]);
+            }
+
+            for (size_t k = i + 1; k < n && reference->time[k] - reference->time[i] <= timeTolerance; k++) {
+                lower = fmin(lower, v[k]);
+                upper = fmax(upper, v[k]);
+            }
+
+            reference->lower[j * n + i] = lower - tolerance;
+            reference->upper[j * n + i] = upper + tolerance;
+        }
+    }
+
+    free(rows);
+    free(row);
+    fclose(file);
+
+    return reference;
+
+FAIL:
+    free(rows);
+    free(row);
+
+    if (file) {
+        fclose(file);
+    }
+
+    FMIFreeReference(reference);
+
+    return NULL;
+}
+
+void FMIFreeReference(FMIReference *reference) {
+
+    if (!reference) {
+        return;
+    }
+
+    freeNames(reference->names, reference->nColumns);
+
+    free(reference->time);
+    free(reference->values);
+    free(reference->lower);
+    free(reference->upper);
+    free(reference->resampled);
+    free(reference->line);
+    free(reference);
+}
+
+size_t FMIReferenceColumnCount(const FMIReference *reference) {
+    return reference->nColumns;
+}
+
+// check the resampled values of a column against the tube
+static void checkColumn(const FMIReference *reference, size_t column, FMIColumnValidation *validation) {
+
+    const size_t n = reference->nRows;
+
+    const double *r  = &reference->resampled[column * n];
+    const double *v  = &reference->values[column * n];
+    const double *lo = &reference->lower[column * n];
+    const double *hi = &reference->upper[column * n];
+
+    double maxError = 0;
+    size_t nViolations = 0;
+
+    // branch-free, so the compiler can vectorize it (NaNs count as violations)
+    for (size_t i = 0; i < n; i++) {
+        const double error = fabs(r[i] - v[i]);
+        maxError = error > maxError ? error : maxError;
+        nViolations += !(r[i] >= lo[i] && r[i] <= hi[i]);
+    }
+
+    validation->name               = reference->names[column];
+    validation->maxError           = maxError;
+    validation->maxErrorTime       = NAN;
+    validation->nViolations        = nViolations;
+    validation->firstViolationTime  = NAN;
+    validation->firstViolationValue = NAN;
+    validation->firstViolationLower = NAN;
+    validation->firstViolationUpper = NAN;
+
+    for (size_t i = 0; i < n; i++) {
+        if (fabs(r[i] - v[i]) == maxError) {
+            validation->maxErrorTime = reference->time[i];
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < n && nViolations > 0; i++) {
+        if (!(r[i] >= lo[i] && r[i] <= hi[i])) {
+            validation->firstViolationTime  = reference->time[i];
+            validation->firstViolationValue = r[i];
+            validation->firstViolationLower = lo[i];
+            validation->firstViolationUpper = hi[i];
+            break;
+        }
+    }
+}
+
+FMIStatus FMIValidateResult(FMIReference *reference, const char *filename, FMIColumnValidation columns[], bool *passed) {
+
+    FMIStatus status = FMIError;
+
+    FILE *file = fopen(filename, "r");
+    char **names = NULL;
+    size_t nFields = 0;
+    size_t *fields = NULL;
+    double *prev = NULL;
+    double *next = NULL;
+
+    if (!reference || !columns || !file || !readLine(reference, file)) {
+        goto TERMINATE;
+    }
+
+    names = parseHeader(reference->line, &nFields);
+    fields = calloc(reference->nColumns + 1, sizeof(size_t));
+    prev = calloc(nFields + 1, sizeof(double));
+    next = calloc(nFields + 1, sizeof(double));
+
+    if (!names || !fields || !prev || !next || nFields < 1) {
+        goto TERMINATE;
+    }
+
+    // match the columns by name
+    for (size_t j = 0; j < reference->nColumns; j++) {
+
+        size_t k = 1;
+
+        while (k < nFields && strcmp(names[k], reference->names[j])) {
+            k++;
+        }
+
+        if (k == nFields) {
+            goto TERMINATE;
+        }
+
+        fields[j] = k;
+    }
+
+    const size_t n = reference->nRows;
+
+    bool havePrev = false;
+    bool haveNext = readLine(reference, file) && parseRow(reference->line, next, nFields);
+
+    if (!haveNext) {
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+
+        const double t = reference->time[i];
+
+        while (haveNext && next[0] < t) {
+            double *row = prev; prev = next; next = row;
+            havePrev = true;
+            haveNext = readLine(reference, file) && parseRow(reference->line, next, nFields);
+        }
+
+        const double *row0 = NULL, *row1 = NULL;
+
+        if (haveNext && next[0] == t) {
+
+            if (i > 0 && reference->time[i - 1] == t) {
+
+                // right limit at an event: the last row at t
+                while (haveNext && next[0] == t) {
+                    double *row = prev; prev = next; next = row;
+                    havePrev = true;
+                    haveNext = readLine(reference, file) && parseRow(reference->line, next, nFields);
+                }
+
+                row0 = prev;
+            } else {
+                row0 = next;
+            }
+
+        } else if (!haveNext) {
+            row0 = NULL; // the result ends before t
+        } else if (!havePrev) {
+            row0 = next; // extrapolate before the start of the result
+        } else {
+            row0 = prev;
+            row1 = next;
+        }
+
+        for (size_t j = 0; j < reference->nColumns; j++) {
+
+            if (!row0) {
+                // missing samples are violations
+                reference->resampled[j * n + i] = NAN;
+                continue;
+            }
+
+            const size_t k = fields[j];
+
+            double value = row0[k];
+
+            if (row1) {
+                value += (row1[k] - row0[k]) * (t - row0[0]) / (row1[0] - row0[0]);
+            }
+
+            reference->resampled[j * n + i] = value;
+        }
+    }
+
+    bool inside = true;
+
+    for (size_t j = 0; j < reference->nColumns; j++) {
+        checkColumn(reference, j, &columns[j]);
+        inside &= columns[j].nViolations == 0;
+    }
+
+    if (passed) {
+        *passed = inside;
+    }
+
+    status = FMIOK;
+
+TERMINATE:
+
+    if (file) {
+        fclose(file);
+    }
+
+    freeNames(names, nFields);
+    free(fields);
+    free(prev);
+    free(next);
+
+    return status;
+}
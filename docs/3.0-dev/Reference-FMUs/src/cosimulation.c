@@ -19,9 +19,244 @@
 #endif
 
 #ifdef _WIN32
+#include <Windows.h>
+#if FMI_VERSION < 3
+#include "shlwapi.h"
+#pragma comment(lib, "shlwapi.lib")
+#endif
 #define strdup _strdup
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define MAX_PATH_LENGTH 4096
+
+struct ResourceFile_ {
+
+    char *path;
+    const char *data;
+    size_t size;
+    size_t refCount;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    struct ResourceFile_ *next;
+};
+
+// resource files mapped by the instances of this FMU
+static ResourceFile *resourceFiles = NULL;
+
+#ifdef _WIN32
+static SRWLOCK resourceLock = SRWLOCK_INIT;
+#define LOCK_RESOURCES   AcquireSRWLockExclusive(&resourceLock)
+#define UNLOCK_RESOURCES ReleaseSRWLockExclusive(&resourceLock)
+#else
+static pthread_mutex_t resourceLock = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_RESOURCES   pthread_mutex_lock(&resourceLock)
+#define UNLOCK_RESOURCES pthread_mutex_unlock(&resourceLock)
+#endif
+
+// convert the resource location to the file system path of the resources directory
+static char *resourceDirectory(const char *resourceLocation) {
+
+    if (!resourceLocation) {
+        return NULL;
+    }
+
+#if FMI_VERSION < 3
+
+#ifdef _WIN32
+    char buffer[MAX_PATH_LENGTH] = "";
+    DWORD pathLength = MAX_PATH_LENGTH;
+
+    if (PathCreateFromUrlA(resourceLocation, buffer, &pathLength, 0) != S_OK) {
+        return NULL;
+    }
+
+    const char *path = buffer;
+#else
+    const char *scheme1 = "file:///";
+    const char *scheme2 = "file:/";
+    const char *path;
+
+    if (strncmp(resourceLocation, scheme1, strlen(scheme1)) == 0) {
+        path = &resourceLocation[strlen(scheme1) - 1];
+    } else if (strncmp(resourceLocation, scheme2, strlen(scheme2)) == 0) {
+        path = &resourceLocation[strlen(scheme2) - 1];
+    } else {
+        return NULL;
+    }
+#endif
+
+#if FMI_VERSION == 1
+    const char *suffix = "/resources/"; // the resource location is the FMU location
+#else
+    const char *suffix = "/";
+#endif
+
+#else
+    const char *path = resourceLocation;
+    const char *suffix = "/";
 #endif
 
+    size_t length = strlen(path);
+
+    // skip the separator if the path already ends with one
+    if (length > 0 && (path[length - 1] == '/' || path[length - 1] == '\\')) {
+        suffix++;
+    }
+
+    char *directory = malloc(length + strlen(suffix) + 1);
+
+    if (directory) {
+        memcpy(directory, path, length);
+        strcpy(&directory[length], suffix);
+    }
+
+    return directory;
+}
+
+static bool mapResourceFile(ResourceFile *resource) {
+
+#ifdef _WIN32
+    resource->file = CreateFileA(resource->path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (resource->file == INVALID_HANDLE_VALUE) {
+        resource->file = NULL;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(resource->file, &size)) {
+        return false;
+    }
+
+    resource->size = (size_t)size.QuadPart;
+
+    // empty files cannot be mapped
+    if (resource->size == 0) {
+        resource->data = "";
+        return true;
+    }
+
+    resource->mapping = CreateFileMappingA(resource->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (!resource->mapping) {
+        return false;
+    }
+
+    resource->data = MapViewOfFile(resource->mapping, FILE_MAP_READ, 0, 0, 0);
+
+    return resource->data != NULL;
+#else
+    const int fd = open(resource->path, O_RDONLY);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    resource->size = (size_t)st.st_size;
+
+    // empty files cannot be mapped
+    if (resource->size == 0) {
+        close(fd);
+        resource->data = "";
+        return true;
+    }
+
+    void *data = mmap(NULL, resource->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping stays valid after the file has been closed
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    resource->data = data;
+
+    return true;
+#endif
+}
+
+static void freeResourceFile(ResourceFile *resource) {
+
+#ifdef _WIN32
+    if (resource->data && resource->size > 0) {
+        UnmapViewOfFile(resource->data);
+    }
+
+    if (resource->mapping) {
+        CloseHandle(resource->mapping);
+    }
+
+    if (resource->file) {
+        CloseHandle(resource->file);
+    }
+#else
+    if (resource->data && resource->size > 0) {
+        munmap((void *)resource->data, resource->size);
+    }
+#endif
+
+    free(resource->path);
+    free(resource);
+}
+
+// release the resource files of an instance and unmap the ones that are no longer used
+static void releaseResources(ModelInstance *comp) {
+
+    const size_t prefixLength = comp->resourcePath ? strlen(comp->resourcePath) : 0;
+
+    for (size_t i = 0; i < comp->nResources; i++) {
+
+        ResourceFile *resource = comp->resources[i];
+
+        LOCK_RESOURCES;
+
+        const size_t refCount = --resource->refCount;
+
+        if (refCount == 0) {
+
+            ResourceFile **p = &resourceFiles;
+
+            while (*p != resource) {
+                p = &(*p)->next;
+            }
+
+            *p = resource->next;
+        }
+
+        UNLOCK_RESOURCES;
+
+        logEvent(comp, "Released resource file %s (reference count %zu).", &resource->path[prefixLength], refCount);
+
+        // no other instance can find the file once it has been removed from the list
+        if (refCount == 0) {
+            freeResourceFile(resource);
+        }
+    }
+
+    free(comp->resources);
+
+    comp->resources  = NULL;
+    comp->nResources = 0;
+}
+
 
 ModelInstance *createModelInstance(
     loggerType cbLogger,
@@ -66,16 +301,31 @@ ModelInstance *createModelInstance(
         comp->unlockPreemtion      = NULL;
         comp->instanceName         = strdup(instanceName);
         comp->resourceLocation     = resourceLocation ? strdup(resourceLocation) : NULL;
+        comp->resourcePath         = resourceDirectory(resourceLocation);
+        comp->resources            = NULL;
+        comp->nResources           = 0;
         comp->status               = OK;
         comp->modelData            = (ModelData *)calloc(1, sizeof(ModelData));
-        comp->logEvents            = loggingOn;
-        comp->logErrors            = true; // always log errors
+        comp->logCategories        = LogStatusError | (loggingOn ? LogEvents : 0); // always log errors
+        comp->logBuffer            = (char *)malloc(LOG_BUFFER_SIZE);
+        comp->logBufferSize        = comp->logBuffer ? LOG_BUFFER_SIZE : 0;
+#ifdef DEFERRED_LOGGING
+        comp->logRecords           = (LogRecord *)calloc(LOG_RING_SIZE, sizeof(LogRecord));
+#endif
         comp->nSteps               = 0;
         comp->earlyReturnAllowed   = false;
         comp->eventModeUsed        = false;
+        comp->requiredIntermediateVariables  = NULL;
+        comp->nRequiredIntermediateVariables = 0;
+        comp->intermediateUpdateInterval     = INTERMEDIATE_UPDATE_INTERVAL;
+        comp->lastIntermediateUpdateTime     = -INFINITY;
     }
 
-    if (!comp || !comp->modelData || !comp->instanceName) {
+#ifdef DEFERRED_LOGGING
+    if (!comp || !comp->modelData || !comp->instanceName || !comp->logBuffer || !comp->logRecords) {
+#else
+    if (!comp || !comp->modelData || !comp->instanceName || !comp->logBuffer) {
+#endif
         logError(comp, "Out of memory.");
         return NULL;
     }
@@ -93,7 +343,9 @@ ModelInstance *createModelInstance(
     comp->nextEventTimeDefined              = false;
     comp->nextEventTime                     = 0;
 
+    clearTimeEvents(comp);
     setStartValues(comp); // to be implemented by the includer of this file
+    updateNextEventTime(comp);
     comp->isDirtyValues = true; // because we just called setStartValues
 
 #if NZ > 0
@@ -104,13 +356,37 @@ ModelInstance *createModelInstance(
     comp->prez = NULL;
 #endif
 
+    // on the heap, so models with many states don't overflow the stack
+#if NX > 0
+    comp->x  = calloc(sizeof(double), NX);
+    comp->dx = calloc(sizeof(double), NX);
+#else
+    comp->x  = NULL;
+    comp->dx = NULL;
+#endif
+
     return comp;
 }
 
 void freeModelInstance(ModelInstance *comp) {
+    releaseResources(comp);
+    flushLog(comp);
     free((void *)comp->instanceName);
+    free((void *)comp->resourceLocation);
+    free((void *)comp->resourcePath);
     free(comp->z);
     free(comp->prez);
+    free(comp->x);
+    free(comp->dx);
+    free(comp->logBuffer);
+    free(comp->requiredIntermediateVariables);
+#ifdef DEFERRED_LOGGING
+    free(comp->logRecords);
+#endif
+    if (comp->modelData) {
+        freeModelData(comp->modelData);
+        free(comp->modelData);
+    }
     free(comp);
 }
 
@@ -169,9 +445,9 @@ Status setDebugLogging(ModelInstance *comp, bool loggingOn, size_t nCategories,
                 logError(comp, "Log category[%d] must not be NULL", i);
                 return Error;
             } else if (strcmp(categories[i], "logEvents") == 0) {
-                comp->logEvents = true;
+                comp->logCategories |= LogEvents;
             } else if (strcmp(categories[i], "logStatusError") == 0) {
-                comp->logErrors = true;
+                comp->logCategories |= LogStatusError;
             } else {
                 logError(comp, "Log category[%d] must be one of logEvents or logStatusError but was %s", i, categories[i]);
                 return Error;
@@ -179,8 +455,8 @@ Status setDebugLogging(ModelInstance *comp, bool loggingOn, size_t nCategories,
         }
     } else {
         // disable logging
-        comp->logEvents = false;
-        comp->logErrors = false;
+        flushLog(comp);
+        comp->logCategories = 0;
     }
 
     return OK;
@@ -192,38 +468,363 @@ static void logMessage(ModelInstance *comp, int status, const char *category, co
         return;
     }
 
+    // not enough memory for the scratch buffer
+    if (!comp->logBuffer) {
+        comp->logger(comp->componentEnvironment, comp->instanceName, status, category, message);
+        return;
+    }
+
     va_list args1;
-    size_t len = 0;
-    char *buf = "";
 
     va_copy(args1, args);
-    len = vsnprintf(buf, len, message, args1);
+    const int length = vsnprintf(comp->logBuffer, comp->logBufferSize, message, args1);
     va_end(args1);
 
+    // grow the scratch buffer for long messages (truncate them if that fails)
+    if (length >= 0 && (size_t)length >= comp->logBufferSize) {
+
+        char *buffer = (char *)realloc(comp->logBuffer, (size_t)length + 1);
+
+        if (buffer) {
+            comp->logBuffer = buffer;
+            comp->logBufferSize = (size_t)length + 1;
+            vsnprintf(comp->logBuffer, comp->logBufferSize, message, args);
+        }
+    }
+
+    // no need to distinguish between FMI versions since we're not using variadic arguments
+    comp->logger(comp->componentEnvironment, comp->instanceName, status, category, comp->logBuffer);
+}
+
+#ifdef DEFERRED_LOGGING
+
+typedef enum {
+    ArgNone,
+    ArgInt,
+    ArgUnsigned,
+    ArgLong,
+    ArgUnsignedLong,
+    ArgLongLong,
+    ArgUnsignedLongLong,
+    ArgSize,
+    ArgIntMax,
+    ArgPtrDiff,
+    ArgDouble,
+    ArgLongDouble,
+    ArgString,
+    ArgPointer
+} ArgType;
+
+// parse the conversion specification that starts at spec[0] == '%' and return its
+// length (0 if it is not supported), the type of its argument and the number of '*'
+static size_t parseConversion(const char *spec, ArgType *type, size_t *nStars) {
+
+    const char *p = spec + 1;
+
+    *nStars = 0;
+
+    if (*p == '%') {
+        *type = ArgNone;
+        return 2;
+    }
+
+    // flags
+    while (*p && strchr("-+ #0", *p)) {
+        p++;
+    }
+
+    // width and precision
+    for (int i = 0; i < 2; i++) {
+
+        if (i == 1) {
+            if (*p != '.') break;
+            p++;
+        }
+
+        if (*p == '*') {
+            (*nStars)++;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+        }
+    }
+
+    // length modifier
+    char length = '\0';
+
+    if (*p == 'l' && p[1] == 'l') {
+        length = 'q';
+        p += 2;
+    } else if (*p == 'h' && p[1] == 'h') {
+        length = 'h';
+        p += 2;
+    } else if (*p && strchr("hlzjtL", *p)) {
+        length = *p++;
+    }
+
+    switch (*p) {
+        case 'd':
+        case 'i':
+        case 'c':
+            switch (length) {
+                case 'l': *type = ArgLong;     break;
+                case 'q': *type = ArgLongLong; break;
+                case 'z': *type = ArgSize;     break;
+                case 'j': *type = ArgIntMax;   break;
+                case 't': *type = ArgPtrDiff;  break;
+                default:  *type = ArgInt;      break;
+            }
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            switch (length) {
+                case 'l': *type = ArgUnsignedLong;     break;
+                case 'q': *type = ArgUnsignedLongLong; break;
+                case 'z': *type = ArgSize;             break;
+                case 'j': *type = ArgIntMax;           break;
+                case 't': *type = ArgPtrDiff;          break;
+                default:  *type = ArgUnsigned;         break;
+            }
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            *type = length == 'L' ? ArgLongDouble : ArgDouble;
+            break;
+        case 's':
+            *type = ArgString;
+            break;
+        case 'p':
+            *type = ArgPointer;
+            break;
+        default:
+            return 0; // e.g. %n
+    }
+
+    return (size_t)(p - spec) + 1;
+}
+
+// capture the arguments of message into a record (returns false if they can't be captured)
+static bool captureArguments(LogRecord *record, const char *message, va_list args) {
+
+    size_t nText = 0;
+
+    record->nArgs = 0;
+
+    for (const char *p = strchr(message, '%'); p; p = strchr(p, '%')) {
+
+        ArgType type;
+        size_t nStars;
+
+        const size_t length = parseConversion(p, &type, &nStars);
+
+        if (length == 0 || record->nArgs + nStars + (type == ArgNone ? 0 : 1) > LOG_RECORD_MAX_ARGS) {
+            return false;
+        }
+
+        for (size_t i = 0; i < nStars; i++) {
+            record->args[record->nArgs++].i = va_arg(args, int);
+        }
+
+        LogArgument *arg = &record->args[record->nArgs];
+
+        switch (type) {
+            case ArgNone:                                                                  break;
+            case ArgInt:              arg->i   = va_arg(args, int);                        break;
+            case ArgUnsigned:         arg->u   = va_arg(args, unsigned int);               break;
+            case ArgLong:             arg->l   = va_arg(args, long);                       break;
+            case ArgUnsignedLong:     arg->ul  = va_arg(args, unsigned long);              break;
+            case ArgLongLong:         arg->ll  = va_arg(args, long long);                  break;
+            case ArgUnsignedLongLong: arg->ull = va_arg(args, unsigned long long);         break;
+            case ArgSize:             arg->z   = va_arg(args, size_t);                     break;
+            case ArgIntMax:           arg->j   = va_arg(args, intmax_t);                   break;
+            case ArgPtrDiff:          arg->t   = va_arg(args, ptrdiff_t);                  break;
+            case ArgDouble:           arg->d   = va_arg(args, double);                     break;
+            case ArgLongDouble:       arg->ld  = va_arg(args, long double);                break;
+            case ArgPointer:          arg->p   = va_arg(args, void *);                     break;
+            case ArgString: {
+                // copy the string, because it may not be valid when the record is formatted
+                const char *s = va_arg(args, const char *);
+                if (!s) s = "(null)";
+                const size_t n = strlen(s);
+                // don't truncate the strings
+                if (nText + n + 1 > LOG_RECORD_TEXT_SIZE) {
+                    return false;
+                }
+                memcpy(&record->text[nText], s, n + 1);
+                arg->offset = nText;
+                nText += n + 1;
+                break;
+            }
+        }
+
+        if (type != ArgNone) {
+            record->nArgs++;
+        }
+
+        p += length;
+    }
+
+    return true;
+}
+
+// format a record into the scratch buffer
+static void formatRecord(ModelInstance *comp, const LogRecord *record) {
+
+    char *out = comp->logBuffer;
+    const char *end = comp->logBuffer + comp->logBufferSize - 1;
+    size_t iArg = 0;
+
+    for (const char *p = record->message; *p && out < end; ) {
+
+        if (*p != '%') {
+            *out++ = *p++;
+            continue;
+        }
+
+        ArgType type;
+        size_t nStars;
+
+        const size_t length = parseConversion(p, &type, &nStars);
+
+        // replace '*' by the recorded width and precision
+        char spec[64];
+        size_t n = 0;
+
+        for (size_t i = 0; i < length && n < sizeof(spec) - 16; i++) {
+            if (p[i] == '*') {
+                n += (size_t)snprintf(&spec[n], sizeof(spec) - n, "%d", record->args[iArg++].i);
+            } else {
+                spec[n++] = p[i];
+            }
+        }
+
+        spec[n] = '\0';
+
+        const LogArgument *arg = &record->args[iArg];
+        const size_t size = (size_t)(end - out) + 1;
+        int written = 0;
+
+        switch (type) {
+            case ArgNone:             written = snprintf(out, size, "%%");                                 break;
+            case ArgInt:              written = snprintf(out, size, spec, arg->i);                         break;
+            case ArgUnsigned:         written = snprintf(out, size, spec, arg->u);                         break;
+            case ArgLong:             written = snprintf(out, size, spec, arg->l);                         break;
+            case ArgUnsignedLong:     written = snprintf(out, size, spec, arg->ul);                        break;
+            case ArgLongLong:         written = snprintf(out, size, spec, arg->ll);                        break;
+            case ArgUnsignedLongLong: written = snprintf(out, size, spec, arg->ull);                       break;
+            case ArgSize:             written = snprintf(out, size, spec, arg->z);                         break;
+            case ArgIntMax:           written = snprintf(out, size, spec, arg->j);                         break;
+            case ArgPtrDiff:          written = snprintf(out, size, spec, arg->t);                         break;
+            case ArgDouble:           written = snprintf(out, size, spec, arg->d);                         break;
+            case ArgLongDouble:       written = snprintf(out, size, spec, arg->ld);                        break;
+            case ArgString:           written = snprintf(out, size, spec, &record->text[arg->offset]);     break;
+            case ArgPointer:          written = snprintf(out, size, spec, arg->p);                         break;
+        }
+
+        if (type != ArgNone) {
+            iArg++;
+        }
+
+        out += written < 0 ? 0 : ((size_t)written < size ? (size_t)written : size - 1);
+        p += length;
+    }
+
+    *out = '\0';
+}
+
+// record a message to be formatted by flushLog()
+static void deferMessage(ModelInstance *comp, int status, const char *category, const char *message, va_list args) {
+
+    // capture the arguments before a record is dropped for the message
+    LogRecord record;
+
+    va_list args1;
+
     va_copy(args1, args);
-    buf = (char *)calloc(len + 1, sizeof(char));
-    vsnprintf(buf, len + 1, message, args);
+    const bool captured = captureArguments(&record, message, args1);
     va_end(args1);
 
-    // no need to distinguish between FMI versions since we're not using variadic arguments
-    comp->logger(comp->componentEnvironment, comp->instanceName, status, category, buf);
+    if (!captured) {
+        // format the message now
+        flushLog(comp);
+        logMessage(comp, status, category, message, args);
+        return;
+    }
+
+    record.status   = status;
+    record.category = category;
+    record.message  = message;
+
+    // overwrite the oldest record if the ring is full
+    if (comp->nLogRecords == LOG_RING_SIZE) {
+        comp->logRecordsStart = (comp->logRecordsStart + 1) % LOG_RING_SIZE;
+        comp->nLogRecords--;
+        comp->nDroppedLogRecords++;
+    }
+
+    comp->logRecords[(comp->logRecordsStart + comp->nLogRecords) % LOG_RING_SIZE] = record;
 
-    free(buf);
+    comp->nLogRecords++;
+}
+
+#endif
+
+void flushLog(ModelInstance *comp) {
+
+#ifdef DEFERRED_LOGGING
+    if (!comp || !comp->logger || !comp->logBuffer || !comp->logRecords) {
+        return;
+    }
+
+    if (comp->nDroppedLogRecords > 0) {
+        snprintf(comp->logBuffer, comp->logBufferSize, "%zu earlier log messages have been dropped.", comp->nDroppedLogRecords);
+        comp->logger(comp->componentEnvironment, comp->instanceName, Warning, "logEvents", comp->logBuffer);
+        comp->nDroppedLogRecords = 0;
+    }
+
+    for (size_t i = 0; i < comp->nLogRecords; i++) {
+        const LogRecord *record = &comp->logRecords[(comp->logRecordsStart + i) % LOG_RING_SIZE];
+        formatRecord(comp, record);
+        comp->logger(comp->componentEnvironment, comp->instanceName, record->status, record->category, comp->logBuffer);
+    }
+
+    comp->logRecordsStart = 0;
+    comp->nLogRecords = 0;
+#else
+    UNUSED(comp)
+#endif
 }
 
 void logEvent(ModelInstance *comp, const char *message, ...) {
 
-    if (!comp || !comp->logEvents) return;
+    if (!comp || !(comp->logCategories & LogEvents)) return;
 
     va_list args;
     va_start(args, message);
+#ifdef DEFERRED_LOGGING
+    deferMessage(comp, OK, "logEvents", message, args);
+#else
     logMessage(comp, OK, "logEvents", message, args);
+#endif
     va_end(args);
 }
 
 void logError(ModelInstance *comp, const char *message, ...) {
 
-    if (!comp || !comp->logErrors) return;
+    if (!comp || !(comp->logCategories & LogStatusError)) return;
+
+    // the events that led to the error
+    flushLog(comp);
 
     va_list args;
     va_start(args, message);
@@ -231,6 +832,281 @@ void logError(ModelInstance *comp, const char *message, ...) {
     va_end(args);
 }
 
+Status setRequiredIntermediateVariables(ModelInstance *comp, const uint32_t valueReferences[], size_t nValueReferences) {
+
+    free(comp->requiredIntermediateVariables);
+
+    comp->requiredIntermediateVariables  = NULL;
+    comp->nRequiredIntermediateVariables = 0;
+
+    if (nValueReferences == 0) {
+        return OK;
+    }
+
+    if (nullPointer(comp, "setRequiredIntermediateVariables", "valueReferences", valueReferences)) {
+        return Error;
+    }
+
+    comp->requiredIntermediateVariables = malloc(nValueReferences * sizeof(uint32_t));
+
+    if (!comp->requiredIntermediateVariables) {
+        logError(comp, "Failed to allocate memory for the required intermediate variables.");
+        return Error;
+    }
+
+    memcpy(comp->requiredIntermediateVariables, valueReferences, nValueReferences * sizeof(uint32_t));
+
+    comp->nRequiredIntermediateVariables = nValueReferences;
+
+    return OK;
+}
+
+Status getResource(ModelInstance *comp, const char *name, const char **data, size_t *size) {
+
+    if (!comp->resourcePath) {
+        logError(comp, "Failed to convert the resource location %s to a file system path.", comp->resourceLocation ? comp->resourceLocation : "(NULL)");
+        return Error;
+    }
+
+    const size_t prefixLength = strlen(comp->resourcePath);
+
+    // files that have already been loaded by this instance
+    for (size_t i = 0; i < comp->nResources; i++) {
+
+        const ResourceFile *resource = comp->resources[i];
+
+        if (!strcmp(&resource->path[prefixLength], name)) {
+            *data = resource->data;
+            *size = resource->size;
+            return OK;
+        }
+    }
+
+    ResourceFile **resources = realloc(comp->resources, (comp->nResources + 1) * sizeof(ResourceFile *));
+
+    if (!resources) {
+        logError(comp, "Failed to allocate memory for the resource %s.", name);
+        return Error;
+    }
+
+    comp->resources = resources;
+
+    char *path = malloc(prefixLength + strlen(name) + 1);
+
+    if (!path) {
+        logError(comp, "Failed to allocate memory for the resource %s.", name);
+        return Error;
+    }
+
+    strcpy(path, comp->resourcePath);
+    strcpy(&path[prefixLength], name);
+
+    LOCK_RESOURCES;
+
+    // files that have been loaded by other instances
+    ResourceFile *resource = resourceFiles;
+
+    while (resource && strcmp(resource->path, path)) {
+        resource = resource->next;
+    }
+
+    if (resource) {
+        free(path);
+    } else {
+
+        resource = calloc(1, sizeof(ResourceFile));
+
+        if (!resource) {
+            UNLOCK_RESOURCES;
+            free(path);
+            logError(comp, "Failed to allocate memory for the resource %s.", name);
+            return Error;
+        }
+
+        resource->path = path;
+
+        if (!mapResourceFile(resource)) {
+            UNLOCK_RESOURCES;
+            logError(comp, "Failed to open resource file %s.", resource->path);
+            freeResourceFile(resource);
+            return Error;
+        }
+
+        resource->next = resourceFiles;
+        resourceFiles = resource;
+    }
+
+    const size_t refCount = ++resource->refCount;
+
+    UNLOCK_RESOURCES;
+
+    comp->resources[comp->nResources++] = resource;
+
+    logEvent(comp, "Using resource file %s (reference count %zu).", name, refCount);
+
+    *data = resource->data;
+    *size = resource->size;
+
+    return OK;
+}
+
+#if N_TIME_EVENTS > 0
+
+#if N_TIME_EVENTS > 1
+
+static bool earlier(const TimeEvent *a, const TimeEvent *b) {
+    return a->time < b->time || (a->time == b->time && a->id < b->id);
+}
+
+static void swapTimeEvents(TimeEventQueue *queue, size_t i, size_t j) {
+
+    const TimeEvent event = queue->events[i];
+
+    queue->events[i] = queue->events[j];
+    queue->events[j] = event;
+
+    queue->positions[queue->events[i].id] = i;
+    queue->positions[queue->events[j].id] = j;
+}
+
+// restore the heap property for the event at index i
+static void siftTimeEvent(TimeEventQueue *queue, size_t i) {
+
+    // up
+    while (i > 0 && earlier(&queue->events[i], &queue->events[(i - 1) / 2])) {
+        swapTimeEvents(queue, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+
+    // down
+    for (;;) {
+
+        const size_t left  = 2 * i + 1;
+        const size_t right = 2 * i + 2;
+
+        size_t first = i;
+
+        if (left < queue->nEvents && earlier(&queue->events[left], &queue->events[first])) {
+            first = left;
+        }
+
+        if (right < queue->nEvents && earlier(&queue->events[right], &queue->events[first])) {
+            first = right;
+        }
+
+        if (first == i) {
+            break;
+        }
+
+        swapTimeEvents(queue, i, first);
+
+        i = first;
+    }
+}
+
+#else
+
+// a single event is always a heap
+#define siftTimeEvent(queue, i)
+
+#endif
+
+static void removeTimeEvent(TimeEventQueue *queue, size_t i) {
+
+    const size_t last = --queue->nEvents;
+
+    queue->positions[queue->events[i].id] = N_TIME_EVENTS;
+
+#if N_TIME_EVENTS > 1
+    if (i != last) {
+        queue->events[i] = queue->events[last];
+        queue->positions[queue->events[i].id] = i;
+        siftTimeEvent(queue, i);
+    }
+#else
+    UNUSED(last);
+#endif
+}
+
+Status scheduleTimeEvent(ModelInstance *comp, size_t id, double time) {
+
+    TimeEventQueue *queue = &comp->timeEvents;
+
+    if (id >= N_TIME_EVENTS) {
+        logError(comp, "The time event id must be less than %d but was %zu.", N_TIME_EVENTS, id);
+        return Error;
+    }
+
+    size_t i = queue->positions[id];
+
+    // re-schedule the event if it is already in the queue
+    if (i == N_TIME_EVENTS) {
+        i = queue->nEvents++;
+        queue->events[i].id = id;
+        queue->positions[id] = i;
+    }
+
+    queue->events[i].time = time;
+
+    siftTimeEvent(queue, i);
+
+    updateNextEventTime(comp);
+
+    return OK;
+}
+
+void cancelTimeEvent(ModelInstance *comp, size_t id) {
+
+    TimeEventQueue *queue = &comp->timeEvents;
+
+    if (id < N_TIME_EVENTS && queue->positions[id] < N_TIME_EVENTS) {
+        removeTimeEvent(queue, queue->positions[id]);
+        updateNextEventTime(comp);
+    }
+}
+
+bool popTimeEvent(ModelInstance *comp, size_t *id, double *time) {
+
+    TimeEventQueue *queue = &comp->timeEvents;
+
+    if (queue->nEvents == 0 || queue->events[0].time > comp->time + epsilon(comp->time)) {
+        return false;
+    }
+
+    *id   = queue->events[0].id;
+    *time = queue->events[0].time;
+
+    removeTimeEvent(queue, 0);
+
+    updateNextEventTime(comp);
+
+    return true;
+}
+
+#endif
+
+void clearTimeEvents(ModelInstance *comp) {
+#if N_TIME_EVENTS > 0
+    comp->timeEvents.nEvents = 0;
+
+    for (size_t i = 0; i < N_TIME_EVENTS; i++) {
+        comp->timeEvents.positions[i] = N_TIME_EVENTS;
+    }
+#else
+    UNUSED(comp)
+#endif
+}
+
+void updateNextEventTime(ModelInstance *comp) {
+#if N_TIME_EVENTS > 0
+    // models with time events don't set nextEventTime themselves
+    comp->nextEventTimeDefined = comp->timeEvents.nEvents > 0;
+    comp->nextEventTime        = comp->timeEvents.nEvents > 0 ? comp->timeEvents.events[0].time : 0;
+#else
+    UNUSED(comp)
+#endif
+}
+
 // default implementations
 #if NZ < 1
 void getEventIndicators(ModelInstance *comp, double z[], size_t nz) {
@@ -439,11 +1315,43 @@ Status getPartialDerivative(ModelInstance *comp, ValueReference unknown, ValueRe
 }
 #endif
 
+#ifndef COPY_MODEL_DATA
+Status copyModelData(ModelInstance *comp, ModelData *dst, const ModelData *src) {
+    UNUSED(comp)
+    memcpy(dst, src, sizeof(ModelData));
+    return OK;
+}
+
+void freeModelData(ModelData *data) {
+    UNUSED(data)
+}
+
+size_t serializedModelDataSize(const ModelData *data) {
+    UNUSED(data)
+    return sizeof(ModelData);
+}
+
+void serializeModelData(const ModelData *data, void *buffer) {
+    memcpy(buffer, data, sizeof(ModelData));
+}
+
+Status deserializeModelData(ModelInstance *comp, ModelData *data, const void *buffer, size_t size) {
+
+    if (invalidNumber(comp, "deserializeModelData", "size", size, sizeof(ModelData))) {
+        return Error;
+    }
+
+    memcpy(data, buffer, sizeof(ModelData));
+
+    return OK;
+}
+#endif
+
 void doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent) {
 
 #if NX > 0
-    double  x[NX] = { 0 };
-    double dx[NX] = { 0 };
+    double *x  = comp->x;
+    double *dx = comp->dx;
 
     getContinuousStates(comp, x, NX);
     getDerivatives(comp, dx, NX);
@@ -478,13 +1386,32 @@ void doFixedStep(ModelInstance *comp, bool* stateEvent, bool* timeEvent) {
 #endif
 
     // time event
+    updateNextEventTime(comp);
+
     *timeEvent = comp->nextEventTimeDefined && comp->time >= comp->nextEventTime;
 
+    if (*stateEvent) {
+        logEvent(comp, "State event at t=%.16g.", comp->time);
+    }
+
+    if (*timeEvent) {
+        logEvent(comp, "Time event at t=%.16g.", comp->time);
+    }
+
+    // intermediate update at events (where fmi3DoStep() can return early) and after
+    // the steps that are intermediateUpdateInterval apart if the importer requires
+    // intermediate variables
+    const bool intermediateUpdateNeeded = *stateEvent || *timeEvent ||
+        (comp->nRequiredIntermediateVariables > 0 &&
+         comp->time - comp->lastIntermediateUpdateTime + epsilon(comp->time) >= comp->intermediateUpdateInterval);
+
     bool earlyReturnRequested;
     double earlyReturnTime;
 
-    // intermediate update
-    if (comp->intermediateUpdate) {
+    if (comp->intermediateUpdate && intermediateUpdateNeeded) {
+
+        comp->lastIntermediateUpdateTime = comp->time;
+
         comp->intermediateUpdate(
             comp->componentEnvironment, // instanceEnvironment
             comp->time,                 // intermediateUpdateTime
@@ -0,0 +1,140 @@
+/**************************************************************
+ *  Copyright (c) Modelica Association Project "FMI".         *
+ *  All rights reserved.                                      *
+ *  This file is part of the Reference FMUs. See LICENSE.txt  *
+ *  in the project root for license information.              *
+ **************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ensemble.h"
+
+
+static const ValueReference states[NX] = ENSEMBLE_STATES;
+static const ValueReference derivatives[NX] = ENSEMBLE_DERIVATIVES;
+
+static void *allocateAligned(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, ENSEMBLE_ALIGNMENT);
+#else
+    return aligned_alloc(ENSEMBLE_ALIGNMENT, size);
+#endif
+}
+
+static void freeAligned(void *p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+Ensemble *createEnsemble(size_t nInstances) {
+
+    const size_t n = ENSEMBLE_ALIGNMENT / sizeof(double);
+
+    Ensemble *ensemble = calloc(1, sizeof(Ensemble));
+
+    if (!ensemble) {
+        return NULL;
+    }
+
+    ensemble->nInstances = nInstances;
+    ensemble->stride     = ((nInstances + n - 1) / n) * n;
+    ensemble->time       = 0;
+    ensemble->nSteps     = 0;
+
+    const size_t size = ENSEMBLE_N_VARIABLES * (ensemble->stride > 0 ? ensemble->stride : n) * sizeof(double);
+
+    ensemble->variables = allocateAligned(size);
+
+    if (!ensemble->variables) {
+        free(ensemble);
+        return NULL;
+    }
+
+    // the padding is evaluated with the instances
+    memset(ensemble->variables, 0, size);
+
+    ensembleSetStartValues(ensemble);
+
+    return ensemble;
+}
+
+void freeEnsemble(Ensemble *ensemble) {
+
+    if (!ensemble) {
+        return;
+    }
+
+    freeAligned(ensemble->variables);
+    free(ensemble);
+}
+
+Status ensembleGetFloat64(Ensemble *ensemble, ValueReference vr, double values[]) {
+
+    if ((size_t)vr >= ENSEMBLE_N_VARIABLES) {
+        return Error;
+    }
+
+    ensembleCalculateValues(ensemble);
+
+    memcpy(values, E(vr), ensemble->nInstances * sizeof(double));
+
+    return OK;
+}
+
+Status ensembleSetFloat64(Ensemble *ensemble, ValueReference vr, const double values[]) {
+
+    if ((size_t)vr >= ENSEMBLE_N_VARIABLES) {
+        return Error;
+    }
+
+    memcpy(E(vr), values, ensemble->nInstances * sizeof(double));
+
+    return OK;
+}
+
+void ensembleGetContinuousStates(Ensemble *ensemble, double x[]) {
+    for (size_t i = 0; i < NX; i++) {
+        memcpy(&x[i * ensemble->nInstances], E(states[i]), ensemble->nInstances * sizeof(double));
+    }
+}
+
+void ensembleSetContinuousStates(Ensemble *ensemble, const double x[]) {
+    for (size_t i = 0; i < NX; i++) {
+        memcpy(E(states[i]), &x[i * ensemble->nInstances], ensemble->nInstances * sizeof(double));
+    }
+}
+
+void ensembleGetDerivatives(Ensemble *ensemble, double dx[]) {
+
+    ensembleCalculateValues(ensemble);
+
+    for (size_t i = 0; i < NX; i++) {
+        memcpy(&dx[i * ensemble->nInstances], E(derivatives[i]), ensemble->nInstances * sizeof(double));
+    }
+}
+
+void ensembleDoFixedStep(Ensemble *ensemble) {
+
+    const size_t n = ensemble->stride;
+
+    ensembleCalculateValues(ensemble);
+
+    // forward Euler step
+    for (size_t i = 0; i < NX; i++) {
+
+        double *restrict x = E(states[i]);
+        const double *restrict dx = E(derivatives[i]);
+
+        for (size_t j = 0; j < n; j++) {
+            x[j] += FIXED_SOLVER_STEP * dx[j];
+        }
+    }
+
+    ensemble->nSteps++;
+
+    ensemble->time = ensemble->nSteps * FIXED_SOLVER_STEP;
+}
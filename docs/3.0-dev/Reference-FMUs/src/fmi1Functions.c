@@ -82,11 +82,13 @@ fmiStatus fmiSetDebugLogging(fmiComponent c, fmiBoolean loggingOn) {
 
 fmiStatus fmiSetReal(fmiComponent c, const fmiValueReference vr[], size_t nvr, const fmiReal value[]) {
     ASSERT_STATE("fmiSetReal", Instantiated | Initialized);
+    S->nValues = nvr;
     SET_VARIABLES(Float64);
 }
 
 fmiStatus fmiSetInteger(fmiComponent c, const fmiValueReference vr[], size_t nvr, const fmiInteger value[]) {
     ASSERT_STATE("fmiSetInteger", Instantiated | Initialized);
+    S->nValues = nvr;
     SET_VARIABLES(Int32);
 }
 
@@ -111,11 +113,13 @@ fmiStatus fmiSetString(fmiComponent c, const fmiValueReference vr[], size_t nvr,
 
 fmiStatus fmiGetReal(fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiReal value[]) {
     ASSERT_STATE("fmiGetReal", not_modelError);
+    S->nValues = nvr;
     GET_VARIABLES(Float64);
 }
 
 fmiStatus fmiGetInteger(fmiComponent c, const fmiValueReference vr[], size_t nvr, fmiInteger value[]) {
     ASSERT_STATE("fmiGetInteger", not_modelError);
+    S->nValues = nvr;
     GET_VARIABLES(Int32);
 }
 
@@ -190,7 +194,9 @@ fmiStatus fmiResetSlave(fmiComponent c) {
     if (invalidState(instance, "fmiResetSlave", Initialized))
          return fmiError;
     instance->state = Instantiated;
+    clearTimeEvents(instance);
     setStartValues(instance); // to be implemented by the includer of this file
+    updateNextEventTime(instance);
     return fmiOK;
 }
 
@@ -261,6 +267,7 @@ fmiStatus fmiDoStep(fmiComponent c, fmiReal currentCommunicationPoint, fmiReal c
 
         if (stateEvent || timeEvent) {
             eventUpdate(instance);
+            updateNextEventTime(instance);
         }
     }
 
@@ -358,6 +365,8 @@ fmiStatus fmiInitialize(fmiComponent c, fmiBoolean toleranceControlled, fmiReal
 
     eventUpdate(instance);
 
+    updateNextEventTime(instance);
+
     eventInfo->iterationConverged          = instance->newDiscreteStatesNeeded ? fmiFalse : fmiTrue;
     eventInfo->stateValueReferencesChanged = fmiFalse;
     eventInfo->stateValuesChanged          = instance->valuesOfContinuousStatesChanged;
@@ -410,8 +419,12 @@ fmiStatus fmiEventUpdate(fmiComponent c, fmiBoolean intermediateResults, fmiEven
     if (nullPointer(instance, "fmiEventUpdate", "eventInfo", eventInfo))
          return fmiError;
 
+    logEvent(instance, "Event update at t=%.16g.", instance->time);
+
     eventUpdate(instance);
 
+    updateNextEventTime(instance);
+
     // copy internal eventInfo of component to output eventInfo
     eventInfo->iterationConverged          = fmiTrue;
     eventInfo->stateValueReferencesChanged = fmiFalse;
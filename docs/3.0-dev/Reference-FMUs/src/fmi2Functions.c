@@ -229,7 +229,9 @@ fmi2Status fmi2Reset(fmi2Component c) {
 
     S->state = Instantiated;
 
+    clearTimeEvents(S);
     setStartValues(S); // to be implemented by the includer of this file
+    updateNextEventTime(S);
 
     S->isDirtyValues = true; // because we just called setStartValues
 
@@ -282,6 +284,7 @@ fmi2Status fmi2GetReal (fmi2Component c, const fmi2ValueReference vr[], size_t n
         S->isDirtyValues = false;
     }
 
+    S->nValues = nvr;
     GET_VARIABLES(Float64)
 }
 
@@ -300,6 +303,7 @@ fmi2Status fmi2GetInteger(fmi2Component c, const fmi2ValueReference vr[], size_t
         S->isDirtyValues = false;
     }
 
+    S->nValues = nvr;
     GET_VARIABLES(Int32)
 }
 
@@ -336,6 +340,7 @@ fmi2Status fmi2GetString (fmi2Component c, const fmi2ValueReference vr[], size_t
         S->isDirtyValues = false;
     }
 
+    S->nValues = nvr;
     GET_VARIABLES(String)
 }
 
@@ -352,6 +357,7 @@ fmi2Status fmi2SetReal (fmi2Component c, const fmi2ValueReference vr[], size_t n
     if (nvr > 0 && nullPointer(S, "fmi2SetReal", "value[]", value))
         return fmi2Error;
 
+    S->nValues = nvr;
     SET_VARIABLES(Float64)
 }
 
@@ -365,6 +371,7 @@ fmi2Status fmi2SetInteger(fmi2Component c, const fmi2ValueReference vr[], size_t
     if (nvr > 0 && nullPointer(S, "fmi2SetInteger", "value[]", value))
         return fmi2Error;
 
+    S->nValues = nvr;
     SET_VARIABLES(Int32)
 }
 
@@ -391,6 +398,7 @@ fmi2Status fmi2SetString (fmi2Component c, const fmi2ValueReference vr[], size_t
     if (nvr>0 && nullPointer(S, "fmi2SetString", "value[]", value))
         return fmi2Error;
 
+    S->nValues = nvr;
     SET_VARIABLES(String)
 }
 
@@ -398,8 +406,23 @@ fmi2Status fmi2GetFMUstate (fmi2Component c, fmi2FMUstate* FMUstate) {
 
     ASSERT_STATE(GetFMUstate)
 
-    ModelData *modelData = (ModelData *)calloc(1, sizeof(ModelData));
-    memcpy(modelData, S->modelData, sizeof(ModelData));
+    // re-use the memory of an existing FMU state
+    ModelData *modelData = *FMUstate ? *FMUstate : (ModelData *)calloc(1, sizeof(ModelData));
+
+    if (!modelData) {
+        logError(S, "Failed to allocate memory for the FMU state.");
+        return fmi2Error;
+    }
+
+    if (copyModelData(S, modelData, S->modelData) > Warning) {
+
+        if (!*FMUstate) {
+            free(modelData);
+        }
+
+        return fmi2Error;
+    }
+
     *FMUstate = modelData;
     return fmi2OK;
 }
@@ -409,7 +432,13 @@ fmi2Status fmi2SetFMUstate (fmi2Component c, fmi2FMUstate FMUstate) {
     ASSERT_STATE(SetFMUstate)
 
     ModelData *modelData = FMUstate;
-    memcpy(S->modelData, modelData, sizeof(ModelData));
+
+    if (copyModelData(S, S->modelData, modelData) > Warning) {
+        return fmi2Error;
+    }
+
+    S->isDirtyValues = true;
+
     return fmi2OK;
 }
 
@@ -418,6 +447,11 @@ fmi2Status fmi2FreeFMUstate(fmi2Component c, fmi2FMUstate* FMUstate) {
     ASSERT_STATE(FreeFMUstate)
 
     ModelData *modelData = *FMUstate;
+
+    if (modelData) {
+        freeModelData(modelData);
+    }
+
     free(modelData);
     *FMUstate = NULL;
 
@@ -426,12 +460,12 @@ fmi2Status fmi2FreeFMUstate(fmi2Component c, fmi2FMUstate* FMUstate) {
 
 fmi2Status fmi2SerializedFMUstateSize(fmi2Component c, fmi2FMUstate FMUstate, size_t *size) {
 
-    UNUSED(c)
-    UNUSED(FMUstate)
-
     ASSERT_STATE(SerializedFMUstateSize)
 
-    *size = sizeof(ModelData);
+    if (nullPointer(S, "fmi2SerializedFMUstateSize", "FMUstate", FMUstate))
+        return fmi2Error;
+
+    *size = serializedModelDataSize(FMUstate);
     return fmi2OK;
 }
 
@@ -442,10 +476,10 @@ fmi2Status fmi2SerializeFMUstate(fmi2Component c, fmi2FMUstate FMUstate, fmi2Byt
     if (nullPointer(S, "fmi2SerializeFMUstate", "FMUstate", FMUstate))
         return fmi2Error;
 
-    if (invalidNumber(S, "fmi2SerializeFMUstate", "size", size, sizeof(ModelData)))
+    if (invalidNumber(S, "fmi2SerializeFMUstate", "size", size, serializedModelDataSize(FMUstate)))
         return fmi2Error;
 
-    memcpy(serializedState, FMUstate, sizeof(ModelData));
+    serializeModelData(FMUstate, serializedState);
 
     return fmi2OK;
 }
@@ -454,14 +488,25 @@ fmi2Status fmi2DeSerializeFMUstate (fmi2Component c, const fmi2Byte serializedSt
 
     ASSERT_STATE(DeSerializeFMUstate)
 
-    if (*FMUstate == NULL) {
-        *FMUstate = (fmi2FMUstate *)calloc(1, sizeof(ModelData));
+    // re-use the memory of an existing FMU state
+    ModelData *modelData = *FMUstate ? *FMUstate : (ModelData *)calloc(1, sizeof(ModelData));
+
+    if (!modelData) {
+        logError(S, "Failed to allocate memory for the FMU state.");
+        return fmi2Error;
     }
 
-    if (invalidNumber(S, "fmi2DeSerializeFMUstate", "size", size, sizeof(ModelData)))
+    if (deserializeModelData(S, modelData, serializedState, size) > Warning) {
+
+        if (!*FMUstate) {
+            freeModelData(modelData);
+            free(modelData);
+        }
+
         return fmi2Error;
+    }
 
-    memcpy(*FMUstate, serializedState, sizeof(ModelData));
+    *FMUstate = modelData;
 
     return fmi2OK;
 }
@@ -561,6 +606,7 @@ fmi2Status fmi2DoStep(fmi2Component c, fmi2Real currentCommunicationPoint,
 
         if (stateEvent || timeEvent) {
             eventUpdate(S);
+            updateNextEventTime(S);
         }
     }
 
@@ -651,6 +697,8 @@ fmi2Status fmi2EnterEventMode(fmi2Component c) {
 
     ASSERT_STATE(EnterEventMode)
 
+    logEvent(S, "Entering Event Mode at t=%.16g.", S->time);
+
     S->state = EventMode;
     S->isNewEventIteration = fmi2True;
 
@@ -663,6 +711,8 @@ fmi2Status fmi2NewDiscreteStates(fmi2Component c, fmi2EventInfo *eventInfo) {
 
     eventUpdate(S);
 
+    updateNextEventTime(S);
+
     S->isNewEventIteration = false;
 
     // copy internal eventInfo of component to output eventInfo
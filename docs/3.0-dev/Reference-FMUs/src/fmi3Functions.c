@@ -13,6 +13,8 @@
 #include <string.h>
 #include <stdarg.h>
 #include <assert.h>
+#include <math.h>
+#include <stddef.h>
 
 #include "config.h"
 #include "model.h"
@@ -38,6 +40,22 @@
 #define DT_EVENT_DETECT 1e-10
 #endif
 
+// internal FMU state (see fmi3GetFMUState())
+typedef struct {
+    double time;
+    int nSteps;
+    bool nextEventTimeDefined;
+    double nextEventTime;
+    double lastIntermediateUpdateTime;
+#if NZ > 0
+    double prez[NZ];
+#endif
+#if N_TIME_EVENTS > 0
+    TimeEventQueue timeEvents;
+#endif
+    ModelData modelData;
+} FMUStateData;
+
 // ---------------------------------------------------------------------------
 // Function calls allowed state masks for both Model-exchange and Co-simulation
 // ---------------------------------------------------------------------------
@@ -239,8 +257,6 @@ fmi3Instance fmi3InstantiateCoSimulation(
     fmi3CallbackIntermediateUpdate intermediateUpdate) {
 
     UNUSED(visible);
-    UNUSED(requiredIntermediateVariables);
-    UNUSED(nRequiredIntermediateVariables);
 
     ModelInstance *instance = createModelInstance(
         (loggerType)logMessage,
@@ -253,9 +269,15 @@ fmi3Instance fmi3InstantiateCoSimulation(
         CoSimulation);
 
     if (instance) {
+
         instance->earlyReturnAllowed = earlyReturnAllowed;
         instance->eventModeUsed      = eventModeUsed;
         instance->state              = Instantiated;
+
+        if (setRequiredIntermediateVariables(instance, requiredIntermediateVariables, nRequiredIntermediateVariables) > Warning) {
+            freeModelInstance(instance);
+            return NULL;
+        }
     }
 
     return instance;
@@ -384,14 +406,13 @@ fmi3Status fmi3EnterEventMode(fmi3Instance instance,
     size_t nEventIndicators,
     fmi3Boolean timeEvent) {
 
-    UNUSED(stepEvent);
-    UNUSED(stateEvent);
     UNUSED(rootsFound);
     UNUSED(nEventIndicators);
-    UNUSED(timeEvent);
 
     ASSERT_STATE(EnterEventMode);
 
+    logEvent(S, "Entering Event Mode at t=%.16g (stepEvent=%d, stateEvent=%d, timeEvent=%d).", S->time, stepEvent, stateEvent, timeEvent);
+
     S->state = EventMode;
     S->isNewEventIteration = true;
 
@@ -412,8 +433,22 @@ fmi3Status fmi3Reset(fmi3Instance instance) {
     ASSERT_STATE(Reset);
 
     S->state = Instantiated;
+
+    S->time                              = 0;
+    S->nSteps                            = 0;
+    S->isNewEventIteration               = false;
+    S->newDiscreteStatesNeeded           = false;
+    S->terminateSimulation               = false;
+    S->nominalsOfContinuousStatesChanged = false;
+    S->valuesOfContinuousStatesChanged   = false;
+    S->nextEventTimeDefined              = false;
+    S->nextEventTime                     = 0;
+
+    clearTimeEvents(S);
     setStartValues(S);
+    updateNextEventTime(S);
     S->isDirtyValues = true;
+    S->lastIntermediateUpdateTime = -INFINITY;
 
     return fmi3OK;
 }
@@ -431,8 +466,8 @@ fmi3Status fmi3GetFloat32(fmi3Instance instance,
 }
 
 fmi3Status fmi3GetFloat64(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Float64 value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(GetFloat64);
+    S->nValues = nValues;
     GET_VARIABLES(Float64);
 }
 
@@ -473,14 +508,14 @@ fmi3Status fmi3GetInt16(fmi3Instance instance,
 }
 
 fmi3Status fmi3GetUInt16(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3UInt16 value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(GetUInt16);
+    S->nValues = nValues;
     GET_VARIABLES(UInt16);
 }
 
 fmi3Status fmi3GetInt32(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Int32 value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(GetInt32);
+    S->nValues = nValues;
     GET_VARIABLES(Int32);
 }
 
@@ -511,20 +546,20 @@ fmi3Status fmi3GetInt64(fmi3Instance instance,
 fmi3Status fmi3GetUInt64(fmi3Instance instance,
                          const fmi3ValueReference vr[], size_t nvr,
                          fmi3UInt64 value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(GetUInt64);
+    S->nValues = nValues;
     GET_VARIABLES(UInt64);
 }
 
 fmi3Status fmi3GetBoolean(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3Boolean value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(GetBoolean);
+    S->nValues = nValues;
     GET_VARIABLES(Boolean);
 }
 
 fmi3Status fmi3GetString(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, fmi3String value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(GetString);
+    S->nValues = nValues;
     GET_VARIABLES(String);
 }
 
@@ -581,8 +616,8 @@ fmi3Status fmi3SetFloat32(fmi3Instance instance,
 
 fmi3Status fmi3SetFloat64(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Float64 value[], size_t nValues) {
 
-    UNUSED(nValues);
     ASSERT_STATE(SetFloat64);
+    S->nValues = nValues;
     SET_VARIABLES(Float64);
 }
 
@@ -625,14 +660,14 @@ fmi3Status fmi3SetInt16(fmi3Instance instance,
 fmi3Status fmi3SetUInt16(fmi3Instance instance,
                          const fmi3ValueReference vr[], size_t nvr,
                          const fmi3UInt16 value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(SetUInt16);
+    S->nValues = nValues;
     SET_VARIABLES(UInt16);
 }
 
 fmi3Status fmi3SetInt32(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Int32 value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(SetInt32);
+    S->nValues = nValues;
     SET_VARIABLES(Int32);
 }
 
@@ -663,20 +698,20 @@ fmi3Status fmi3SetInt64(fmi3Instance instance,
 fmi3Status fmi3SetUInt64(fmi3Instance instance,
                          const fmi3ValueReference vr[], size_t nvr,
                          const fmi3UInt64 value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(SetUInt64);
+    S->nValues = nValues;
     SET_VARIABLES(UInt64);
 }
 
 fmi3Status fmi3SetBoolean(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3Boolean value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(SetBoolean);
+    S->nValues = nValues;
     SET_VARIABLES(Boolean);
 }
 
 fmi3Status fmi3SetString(fmi3Instance instance, const fmi3ValueReference vr[], size_t nvr, const fmi3String value[], size_t nValues) {
-    UNUSED(nValues);
     ASSERT_STATE(SetString);
+    S->nValues = nValues;
     SET_VARIABLES(String);
 }
 
@@ -752,9 +787,38 @@ fmi3Status fmi3GetFMUState(fmi3Instance instance, fmi3FMUState* FMUState) {
 
     ASSERT_STATE(GetFMUState);
 
-    ModelData *modelData = (ModelData *)calloc(1, sizeof(ModelData));
-    memcpy(modelData, S->modelData, sizeof(ModelData));
-    *FMUState = modelData;
+    // re-use the memory of an existing FMU state
+    FMUStateData *data = *FMUState ? *FMUState : calloc(1, sizeof(FMUStateData));
+
+    if (!data) {
+        logError(S, "Failed to allocate memory for the FMU state.");
+        return fmi3Error;
+    }
+
+    data->time                 = S->time;
+    data->nSteps               = S->nSteps;
+    data->nextEventTimeDefined = S->nextEventTimeDefined;
+    data->nextEventTime        = S->nextEventTime;
+    data->lastIntermediateUpdateTime = S->lastIntermediateUpdateTime;
+
+#if NZ > 0
+    memcpy(data->prez, S->prez, NZ * sizeof(double));
+#endif
+
+#if N_TIME_EVENTS > 0
+    data->timeEvents = S->timeEvents;
+#endif
+
+    if (copyModelData(S, &data->modelData, S->modelData) > Warning) {
+
+        if (!*FMUState) {
+            free(data);
+        }
+
+        return fmi3Error;
+    }
+
+    *FMUState = data;
 
     return fmi3OK;
 }
@@ -763,8 +827,31 @@ fmi3Status fmi3SetFMUState(fmi3Instance instance, fmi3FMUState FMUState) {
 
     ASSERT_STATE(SetFMUState);
 
-    ModelData *modelData = FMUState;
-    memcpy(S->modelData, modelData, sizeof(ModelData));
+    if (nullPointer(S, "fmi3SetFMUState", "FMUState", FMUState)) {
+        return fmi3Error;
+    }
+
+    const FMUStateData *data = FMUState;
+
+    S->time                 = data->time;
+    S->nSteps               = data->nSteps;
+    S->nextEventTimeDefined = data->nextEventTimeDefined;
+    S->nextEventTime        = data->nextEventTime;
+    S->lastIntermediateUpdateTime = data->lastIntermediateUpdateTime;
+
+#if NZ > 0
+    memcpy(S->prez, data->prez, NZ * sizeof(double));
+#endif
+
+#if N_TIME_EVENTS > 0
+    S->timeEvents = data->timeEvents;
+#endif
+
+    if (copyModelData(S, S->modelData, &data->modelData) > Warning) {
+        return fmi3Error;
+    }
+
+    S->isDirtyValues = true;
 
     return fmi3OK;
 }
@@ -773,20 +860,30 @@ fmi3Status fmi3FreeFMUState(fmi3Instance instance, fmi3FMUState* FMUState) {
 
     ASSERT_STATE(FreeFMUState);
 
-    ModelData *modelData = *FMUState;
-    free(modelData);
+    if (*FMUState) {
+        freeModelData(&((FMUStateData *)*FMUState)->modelData);
+    }
+
+    free(*FMUState);
     *FMUState = NULL;
 
     return fmi3OK;
 }
 
+// size of the FMU state without the model data that is serialized separately
+#define FMU_STATE_HEADER_SIZE offsetof(FMUStateData, modelData)
+
 fmi3Status fmi3SerializedFMUStateSize(fmi3Instance instance, fmi3FMUState FMUState, size_t *size) {
 
-    UNUSED(instance);
-    UNUSED(FMUState);
     ASSERT_STATE(SerializedFMUStateSize);
 
-    *size = sizeof(ModelData);
+    if (nullPointer(S, "fmi3SerializedFMUStateSize", "FMUState", FMUState)) {
+        return fmi3Error;
+    }
+
+    const FMUStateData *data = FMUState;
+
+    *size = FMU_STATE_HEADER_SIZE + serializedModelDataSize(&data->modelData);
 
     return fmi3OK;
 }
@@ -799,11 +896,15 @@ fmi3Status fmi3SerializeFMUState(fmi3Instance instance, fmi3FMUState FMUState, f
         return fmi3Error;
     }
 
-    if (invalidNumber(S, "fmi3SerializeFMUState", "size", size, sizeof(ModelData))) {
+    const FMUStateData *data = FMUState;
+
+    if (invalidNumber(S, "fmi3SerializeFMUState", "size", size, FMU_STATE_HEADER_SIZE + serializedModelDataSize(&data->modelData))) {
         return fmi3Error;
     }
 
-    memcpy(serializedState, FMUState, sizeof(ModelData));
+    memcpy(serializedState, data, FMU_STATE_HEADER_SIZE);
+
+    serializeModelData(&data->modelData, &serializedState[FMU_STATE_HEADER_SIZE]);
 
     return fmi3OK;
 }
@@ -813,14 +914,32 @@ fmi3Status fmi3DeSerializeFMUState (fmi3Instance instance, const fmi3Byte serial
 
     ASSERT_STATE(DeSerializeFMUState);
 
-    if (*FMUState == NULL) {
-        *FMUState = (fmi3FMUState *)calloc(1, sizeof(ModelData));
+    if (size < FMU_STATE_HEADER_SIZE) {
+        logError(S, "fmi3DeSerializeFMUState: Invalid argument size = %zu.", size);
+        return fmi3Error;
     }
 
-    if (invalidNumber(S, "fmi3DeSerializeFMUState", "size", size, sizeof(ModelData)))
+    // re-use the memory of an existing FMU state
+    FMUStateData *data = *FMUState ? *FMUState : calloc(1, sizeof(FMUStateData));
+
+    if (!data) {
+        logError(S, "Failed to allocate memory for the FMU state.");
         return fmi3Error;
+    }
 
-    memcpy(*FMUState, serializedState, sizeof(ModelData));
+    memcpy(data, serializedState, FMU_STATE_HEADER_SIZE);
+
+    if (deserializeModelData(S, &data->modelData, &serializedState[FMU_STATE_HEADER_SIZE], size - FMU_STATE_HEADER_SIZE) > Warning) {
+
+        if (!*FMUState) {
+            freeModelData(&data->modelData);
+            free(data);
+        }
+
+        return fmi3Error;
+    }
+
+    *FMUState = data;
 
     return fmi3OK;
 }
@@ -1039,6 +1158,8 @@ fmi3Status fmi3UpdateDiscreteStates(fmi3Instance instance,
 
     eventUpdate(S);
 
+    updateNextEventTime(S);
+
     S->isNewEventIteration = false;
 
     // copy internal eventInfo of component to output arguments
@@ -1274,6 +1395,8 @@ fmi3Status fmi3DoStep(fmi3Instance instance,
 
             eventUpdate(S);
 
+            updateNextEventTime(S);
+
             if (S->earlyReturnAllowed) {
                 break;
             }
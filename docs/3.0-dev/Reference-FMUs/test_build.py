@@ -1,7 +1,10 @@
 import unittest
 import subprocess
 import os
+import sys
 import shutil
+import json
+import struct
 from fmpy import simulate_fmu, platform, read_model_description
 from fmpy.util import compile_platform_binary
 from fmpy.validation import validate_fmu
@@ -37,13 +40,42 @@ def copy_to_cross_check(build_dir, model_names, fmi_version, fmi_types):
             shutil.copy(os.path.join(test_fmus_dir, model, model + '_ref.opt'), target_dir)
 
 
+def read_times(filename):
+    """ Read the first column of a CSV file """
+
+    with open(filename) as f:
+        return [float(line.split(',')[0]) for line in f.readlines()[1:]]
+
+
+def read_mat_columns(filename):
+    """ Read the column vectors of doubles from a little endian MAT v4 file """
+
+    columns = {}
+
+    with open(filename, 'rb') as f:
+        data = f.read()
+
+    offset = 0
+
+    while offset < len(data):
+        type, mrows, ncols, imagf, namlen = struct.unpack_from('<5i', data, offset)
+        offset += 20
+        name = data[offset:offset + namlen - 1].decode()
+        offset += namlen
+        assert type == 0 and ncols == 1 and imagf == 0
+        columns[name] = list(struct.unpack_from(f'<{mrows}d', data, offset))
+        offset += 8 * mrows
+
+    return columns
+
+
 class BuildTest(unittest.TestCase):
     """ Build all variants of the Reference FMUs and simulate the default experiment """
 
     @classmethod
     def setUpClass(cls):
         # clean up
-        for name in ['fmi1_me', 'fmi1_cs', 'fmi2', 'fmi3']:
+        for name in ['fmi1_me', 'fmi1_cs', 'fmi2', 'fmi3', 'fmi3_deferred_logging']:
             build_dir = os.path.join(test_fmus_dir, name)
             if os.path.isdir(build_dir):
                 print("Removing " + build_dir)
@@ -90,6 +122,134 @@ class BuildTest(unittest.TestCase):
 
                 self.assertLess(dev, 0.2, "Failed to validate " + model)
 
+    def assertGrid(self, filename, step, stop_time):
+        """ Check that the result contains every grid point and no interval is longer than step """
+
+        times = read_times(filename)
+
+        for i in range(int(round(stop_time / step)) + 1):
+            t = i * step
+            self.assertTrue(any(abs(time - t) < 1e-9 for time in times), f"Grid point {t} is missing in {filename}")
+
+        for t0, t1 in zip(times[:-1], times[1:]):
+            self.assertLessEqual(t1 - t0, step + 1e-9, f"Step from {t0} to {t1} in {filename} is longer than {step}")
+
+    def assertRecordedResults(self, filename, reference):
+        """ Assert that the values of a CSV file match the ones of a reference written with %g """
+
+        with open(filename) as f:
+            rows = f.readlines()
+
+        with open(reference) as f:
+            reference_rows = f.readlines()
+
+        self.assertEqual(reference_rows[0], rows[0])
+        self.assertEqual(len(reference_rows), len(rows))
+
+        for row, reference_row in zip(rows[1:], reference_rows[1:]):
+            for value, reference_value in zip(row.split(','), reference_row.split(',')):
+                self.assertAlmostEqual(float(reference_value), float(value), delta=1e-5 * max(1, abs(float(reference_value))))
+
+    def validate_oscillator_chain(self, build_dir):
+        """ Validate and simulate the OscillatorChain FMU """
+
+        fmu_filename = os.path.join(build_dir, 'dist', 'OscillatorChain.fmu')
+
+        problems = validate_fmu(fmu_filename)
+
+        self.assertEqual([], problems)
+
+        for fmi_type in ['ModelExchange', 'CoSimulation']:
+            result = simulate_fmu(fmu_filename, fmi_type=fmi_type, solver='Euler')
+            self.assertAlmostEqual(10, result['time'][-1])
+            self.assertGreater(result['crossings'][-1], 0, "No zero-crossings in " + fmi_type)
+
+    def run_example(self, build_dir, example, *args):
+        """ Run an example in the temp directory, check the exit code and return the output """
+
+        print("Running %s example..." % example)
+        temp_dir = os.path.join(build_dir, 'temp')
+        return subprocess.check_output([os.path.join(temp_dir, example)] + list(args), cwd=temp_dir, universal_newlines=True)
+
+    def run_without_input_table(self, build_dir):
+        """ Check that the Feedthrough examples fail if the input table is missing """
+
+        temp_dir = os.path.join(build_dir, 'temp')
+        cwd = os.path.join(temp_dir, 'no_input_table')
+
+        if os.path.exists(cwd):
+            shutil.rmtree(cwd)
+
+        shutil.copytree(os.path.join(temp_dir, 'Feedthrough', 'binaries'), os.path.join(cwd, 'Feedthrough', 'binaries'))
+
+        for interface_type in ['cs', 'me']:
+            process = subprocess.run(os.path.join(temp_dir, 'Feedthrough_' + interface_type), cwd=cwd, stdout=subprocess.PIPE, universal_newlines=True)
+            self.assertNotEqual(0, process.returncode)
+            self.assertIn('Failed to open', process.stdout)
+
+    def run_parameter_sweep(self, temp_dir):
+        """ Sweep the tunable parameter e of the BouncingBall in reset and restore mode """
+
+        with open(os.path.join(temp_dir, 'sweep_e.csv'), 'w') as f:
+            f.write('e\n' + '\n'.join(str(0.5 + 0.05 * i) for i in range(11)) + '\n')
+
+        with open(os.path.join(temp_dir, 'sweep_g.csv'), 'w') as f:
+            f.write('g\n-9.81\n-5\n')
+
+        executable = os.path.join(temp_dir, 'parameter_sweep')
+
+        for mode in ['reset', 'restore']:
+            subprocess.check_call([executable, 'BouncingBall', 'sweep_e.csv', f'sweep_{mode}.csv', '4', mode], cwd=temp_dir)
+
+        with open(os.path.join(temp_dir, 'sweep_reset.csv')) as f:
+            reset = f.read()
+
+        with open(os.path.join(temp_dir, 'sweep_restore.csv')) as f:
+            restore = f.read()
+
+        self.assertEqual(12, len(reset.splitlines()))
+        self.assertEqual(reset, restore)
+
+        # the MAT file has one column per variable with the values of the CSV file
+        subprocess.check_call([executable, 'BouncingBall', 'sweep_e.csv', 'sweep_reset.mat', '4', 'reset'], cwd=temp_dir)
+
+        columns = read_mat_columns(os.path.join(temp_dir, 'sweep_reset.mat'))
+        rows = [line.split(',') for line in reset.splitlines()]
+
+        self.assertEqual(['status', 'e', 'h', 'v'], list(columns.keys()))
+
+        for i, name in enumerate(rows[0][1:], start=1):
+            for row, value in zip(rows[1:], columns[name]):
+                self.assertAlmostEqual(float(row[i]), value, places=14)
+
+        # fixed parameters can only be swept in reset mode
+        subprocess.check_call([executable, 'BouncingBall', 'sweep_g.csv', 'sweep_g_reset.csv', '2', 'reset'], cwd=temp_dir)
+        self.assertNotEqual(0, subprocess.call([executable, 'BouncingBall', 'sweep_g.csv', 'sweep_g_restore.csv', '2', 'restore'], cwd=temp_dir))
+
+    def run_validate_result(self, temp_dir, results):
+        """ Validate the results of the examples (with optional validate_result options) and a truncated
+        result against the references """
+
+        executable = os.path.join(temp_dir, 'validate_result')
+
+        for model, result, *options in results:
+            reference = os.path.join(test_fmus_dir, model, model + '_ref.csv')
+            subprocess.check_call([executable] + options + [reference, result], cwd=temp_dir)
+
+        # a result that ends before the reference fails
+        model, result, *_ = results[0]
+
+        with open(os.path.join(temp_dir, result)) as f:
+            lines = f.readlines()
+
+        with open(os.path.join(temp_dir, 'truncated_out.csv'), 'w') as f:
+            f.writelines(lines[:len(lines) // 2])
+
+        reference = os.path.join(test_fmus_dir, model, model + '_ref.csv')
+        process = subprocess.run([executable, reference, 'truncated_out.csv'], cwd=temp_dir, stdout=subprocess.PIPE, universal_newlines=True)
+        self.assertEqual(1, process.returncode)
+        self.assertIn('the result ends before t=', process.stdout)
+
     def test_fmi1_me(self):
 
         build_dir = os.path.join(test_fmus_dir, 'fmi1_me')
@@ -148,6 +308,24 @@ class BuildTest(unittest.TestCase):
                 filename = os.path.join(build_dir, 'temp', example)
                 subprocess.check_call(filename, cwd=os.path.join(build_dir, 'temp'))
 
+        self.run_validate_result(os.path.join(build_dir, 'temp'), [
+            ('BouncingBall', 'BouncingBall_cs_out.csv'),
+            ('BouncingBall', 'BouncingBall_me_out.csv'),
+            ('Dahlquist', 'Dahlquist_cs_out.csv'),
+            ('Dahlquist', 'Dahlquist_me_out.csv'),
+            # the input is held over the communication step, which delays the output by one step (0.1 s)
+            ('Feedthrough', 'Feedthrough_cs_out.csv', '-t', '0.11'),
+            ('Feedthrough', 'Feedthrough_me_out.csv'),
+            ('Resource', 'Resource_cs_out.csv'),
+            ('Resource', 'Resource_me_out.csv'),
+            ('Stair', 'Stair_cs_out.csv'),
+            ('Stair', 'Stair_me_out.csv'),
+            ('VanDerPol', 'VanDerPol_cs_out.csv'),
+            ('VanDerPol', 'VanDerPol_me_out.csv')
+        ])
+
+        self.validate_oscillator_chain(build_dir)
+
     def test_fmi3(self):
 
         print('FMI 3.0')
@@ -167,12 +345,20 @@ class BuildTest(unittest.TestCase):
             'cs_intermediate_update',
             'BouncingBall_cs',
             'BouncingBall_me',
+            'Dahlquist_cs',
+            'Dahlquist_me',
+            'Feedthrough_cs',
+            'Feedthrough_me',
             'import_shared_library',
             'import_static_library',
             'jacobian',
+            'Resource_cs',
+            'Resource_me',
             'scs_synchronous',
             'Stair_cs',
-            'Stair_me'
+            'Stair_me',
+            'VanDerPol_cs',
+            'VanDerPol_me'
         ]
 
         is_windows = os.name == 'nt'
@@ -185,6 +371,136 @@ class BuildTest(unittest.TestCase):
             filename = os.path.join(build_dir, 'temp', example)
             subprocess.check_call(filename, cwd=os.path.join(build_dir, 'temp'))
 
+        # the statically linked FMU must compute the same states as the shared library
+        output = self.run_example(build_dir, 'benchmark_static_linking', '1000')
+        self.assertIn('max. difference of the states: 0\n', output)
+
+        if not is_windows:
+            # the simulate library runs concurrent simulations
+            output = self.run_example(build_dir, 'simulate_threads')
+            self.assertIn('0 of 8 concurrent simulations failed', output)
+
+        if not is_windows:
+            self.run_parameter_sweep(os.path.join(build_dir, 'temp'))
+
+            # Jacobi co-simulation of 48 instances on several threads
+            output = self.run_example(build_dir, 'cs_jacobi')
+            self.assertIn('Simulated 48 instances for 1000 steps', output)
+            # the two connections of a group are transferred with one Get and one Set call per step
+            # (and one Get for the initial outputs)
+            self.assertIn('VanDerPol0: 1001 Get calls, Feedthrough0: 1000 Set calls', output)
+
+            # Gauss-Seidel with an algebraic loop (the dependencies of Feedthrough are read from the
+            # model description after one call to fmi3GetNumberOfVariableDependencies())
+            output = self.run_example(build_dir, 'cs_gauss_seidel')
+            self.assertEqual(1, output.count('Function is not implemented.'))
+            max_error = float(output.strip().split('maximum error of the algebraic loop = ')[-1])
+            self.assertLess(max_error, 1e-8)
+
+            # asynchronous steps with early returns of BouncingBall
+            output = self.run_example(build_dir, 'cs_async')
+            n_early_returns = int(output.split(' early returns)')[0].split('(')[-1])
+            self.assertGreater(n_early_returns, 0)
+            for model in ['VanDerPol', 'Dahlquist', 'BouncingBall']:
+                self.assertIn('%s stopped at t=10\n' % model, output)
+
+            # the results recorded with FMIRecorder must match the ones written with fprintf()
+            output = self.run_example(build_dir, 'record_results', '10000')
+            self.assertIn('(10001 of 10001 samples recorded', output)
+            self.assertRecordedResults(os.path.join(build_dir, 'temp', 'record_results.csv'),
+                                       os.path.join(build_dir, 'temp', 'record_results_fprintf.csv'))
+
+            # the benchmarks of all models including OscillatorChain
+            self.run_example(build_dir, 'benchmarks', '1', 'benchmarks.json')
+            with open(os.path.join(build_dir, 'temp', 'benchmarks.json')) as f:
+                benchmarks = json.load(f)
+            model_identifiers = [model['modelIdentifier'] for model in benchmarks['models']]
+            self.assertIn('OscillatorChain', model_identifiers)
+
+            # variable communication step size with both error estimators
+            for estimator in ['extrapolation', 'step-doubling']:
+                output = self.run_example(build_dir, 'cs_variable_step', '1e-2', estimator)
+                self.assertIn('Simulated to 20 s', output)
+                h_min = float(output.split('min. step size = ')[1].split(',')[0])
+                h_max = float(output.split('max. step size = ')[1].split(')')[0])
+                self.assertLess(h_min, h_max / 5, "The step size of the %s estimator does not vary" % estimator)
+
+        if sys.platform.startswith('linux'):
+            # the preemption lock must be mutually exclusive and boost its owner while a
+            # SCHED_FIFO thread is blocked on it (not checked if SCHED_FIFO is not permitted)
+            self.run_example(build_dir, 'benchmark_activation_latency', '100', '1000', '1000', '10', 'activation_latency.json')
+            with open(os.path.join(build_dir, 'temp', 'activation_latency.json')) as f:
+                latency = json.load(f)
+            self.assertEqual(latency['preemptionLockExpectedCount'], latency['preemptionLockCount'])
+            self.assertIn(latency['priorityInheritance'], [True, None])
+
+        # the virtual-time schedule of the Clocks model partitions is reproducible
+        results = []
+        for _ in range(2):
+            output = self.run_example(build_dir, 'scs_virtual')
+            self.assertIn('inClock1Ticks=10, inClock2Ticks=4, inClock3Ticks=1, totalInClockTicks=15, result2=1000', output)
+            self.assertIn('inClock3: 1 activations, 2 preemptions, 0 overruns, 0 deadline misses', output)
+            with open(os.path.join(build_dir, 'temp', 'scs_virtual_out.csv')) as f:
+                results.append(f.read())
+        self.assertEqual(results[0], results[1])
+
+        # the ensembles must compute the same states as the instances and the first
+        # instance (with the start value of the parameter) the reference result
+        for model in ['Dahlquist', 'VanDerPol']:
+            output = self.run_example(build_dir, 'ensemble_' + model, '1000')
+            max_difference = float(output.split('max. difference = ')[1].split()[0])
+            self.assertLess(max_difference, 1e-10)
+            reference = os.path.join(test_fmus_dir, model, model + '_ref.csv')
+            subprocess.check_call([os.path.join(build_dir, 'temp', 'validate_result'), reference, f'ensemble_{model}_out.csv'], cwd=os.path.join(build_dir, 'temp'))
+
+        # y = A * u of the resized LinearTransform must match the scalar reference
+        output = self.run_example(build_dir, 'linear_transform')
+        self.assertIn('m = 37, n = 2500: max. difference = 0\n', output)
+        self.assertIn('max. difference of y = A * u: 0\n', output)
+
+        # two instances share the mapping of y.txt, which is released with the last one
+        output = self.run_example(build_dir, 'resource_sharing')
+        self.assertIn('[instance2] Using resource file y.txt (reference count 2).\n', output)
+        self.assertIn('[instance2] Released resource file y.txt (reference count 1).\n', output)
+        self.assertIn('[instance1] Released resource file y.txt (reference count 0).\n', output)
+
+        # without required intermediate variables intermediateUpdate() is only called at events
+        n_intermediate_updates = []
+        for n_required_variables in ['0', '2']:
+            output = self.run_example(build_dir, 'cs_intermediate_update', n_required_variables)
+            n_intermediate_updates.append(int(output.split(' intermediate updates')[0].split()[-1]))
+        self.assertGreater(n_intermediate_updates[0], 0)
+        self.assertLess(n_intermediate_updates[0], n_intermediate_updates[1] / 10)
+
+        # the event messages are passed to the logger immediately
+        output = self.run_example(build_dir, 'log_events')
+        self.assertIn('State event at t=', output)
+        self.assertIn('Event messages from fmi3FreeInstance: 0', output)
+
+        self.run_validate_result(os.path.join(build_dir, 'temp'), [
+            ('BouncingBall', 'BouncingBall_cs_out.csv'),
+            # the reference detects the bounces at the end of the step, which delays each of
+            # the ten bounces by up to one step (0.01 s) and changes the bounce velocity
+            ('BouncingBall', 'BouncingBall_me_out.csv', '-t', '0.1', '-a', '0.05'),
+            ('Dahlquist', 'Dahlquist_cs_out.csv'),
+            ('Dahlquist', 'Dahlquist_me_out.csv'),
+            # the input is held over the communication step, which delays the output by one step (0.1 s)
+            ('Feedthrough', 'Feedthrough_cs_out.csv', '-t', '0.11'),
+            ('Feedthrough', 'Feedthrough_me_out.csv'),
+            ('Resource', 'Resource_cs_out.csv'),
+            ('Resource', 'Resource_me_out.csv'),
+            ('Stair', 'Stair_cs_out.csv'),
+            ('Stair', 'Stair_me_out.csv'),
+            ('VanDerPol', 'VanDerPol_cs_out.csv'),
+            ('VanDerPol', 'VanDerPol_me_out.csv')
+        ])
+
+        # the Feedthrough examples read their inputs from the input table in the FMU
+        self.run_without_input_table(build_dir)
+
+        # the state events must not move the output grid
+        self.assertGrid(os.path.join(build_dir, 'temp', 'BouncingBall_me_out.csv'), step=1e-2, stop_time=3)
+
         models = ['BouncingBall', 'Dahlquist', 'Feedthrough', 'Resource', 'Stair', 'VanDerPol']
         self.validate(build_dir, models=models)
         self.validate(build_dir, models=models, compile=True)
@@ -196,6 +512,26 @@ class BuildTest(unittest.TestCase):
             problems = validate_fmu(filename=os.path.join(build_dir, 'dist', model + '.fmu'))
             self.assertEqual([], problems)
 
+        self.validate_oscillator_chain(build_dir)
+
+    def test_fmi3_deferred_logging(self):
+
+        build_dir = os.path.join(test_fmus_dir, 'fmi3_deferred_logging')
+
+        if not os.path.exists(build_dir):
+            os.makedirs(build_dir)
+
+        subprocess.check_call(['cmake', '-G', generator, '-DFMI_VERSION=3', '-DDEFERRED_LOGGING=ON', '..'], cwd=build_dir)
+        subprocess.check_call(['cmake', '--build', '.', '--config', 'Release', '--target', 'log_events'], cwd=build_dir)
+
+        # the event messages are formatted when the instance is freed
+        output = self.run_example(build_dir, 'log_events')
+        self.assertIn('State event at t=', output)
+        self.assertIn('Event messages during the simulation: 0', output)
+        self.assertNotIn('Event messages from fmi3FreeInstance: 0', output)
+
+        self.validate(build_dir, models=['BouncingBall'])
+
 
 if __name__ == '__main__':
     unittest.main()